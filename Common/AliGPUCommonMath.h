@@ -184,6 +184,7 @@ GPUdi() void AliGPUCommonMath::AtomicMaxShared ( GPUAtomic(int) *addr, int val )
 GPUdi() void AliGPUCommonMath::AtomicMinShared ( GPUAtomic(int) *addr, int val ) {AliGPUCommonMath::AtomicMin(addr, val);}
 #endif
 
+//On the host, the atomics only reserve slots and accumulate counters / maxima, the results are read after the threads are joined, so relaxed ordering is sufficient
 #ifndef GPUCA_GPUCODE
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-value" //GCC BUG in omp atomic capture gives false warning
@@ -197,6 +198,8 @@ GPUdi() int AliGPUCommonMath::AtomicExch( GPUglobalref() GPUAtomic(int) *addr, i
 	return ::atomic_xchg( (volatile __global int*) addr, val );
 #elif defined(GPUCA_GPUCODE) && (defined (__CUDACC__) || defined(__HIPCC_))
 	return ::atomicExch( addr, val );
+#elif defined(__GNUC__)
+	return __atomic_exchange_n( addr, val, __ATOMIC_RELAXED );
 #else
 	int old;
 #ifdef GPUCA_HAVE_OPENMP
@@ -218,6 +221,8 @@ GPUdi() int AliGPUCommonMath::AtomicAdd ( GPUglobalref() GPUAtomic(int) *addr, i
 	return ::atomic_add( (volatile __global int*) addr, val );
 #elif defined(GPUCA_GPUCODE) && (defined (__CUDACC__) || defined(__HIPCC_))
 	return ::atomicAdd( addr, val );
+#elif defined(__GNUC__)
+	return __atomic_fetch_add( addr, val, __ATOMIC_RELAXED );
 #else
 	int old;
 #ifdef GPUCA_HAVE_OPENMP
@@ -239,6 +244,9 @@ GPUdi() void AliGPUCommonMath::AtomicMax ( GPUglobalref() GPUAtomic(int) *addr,
 	::atomic_max( (volatile __global int*) addr, val );
 #elif defined(GPUCA_GPUCODE) && (defined (__CUDACC__) || defined(__HIPCC_))
 	::atomicMax( addr, val );
+#elif defined(__GNUC__)
+	int current = __atomic_load_n( addr, __ATOMIC_RELAXED );
+	while ( current < val && !__atomic_compare_exchange_n( addr, &current, val, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) );
 #else
 #ifdef GPUCA_HAVE_OPENMP
 	while (*addr < val) AtomicExch(addr, val);
@@ -256,6 +264,9 @@ GPUdi() void AliGPUCommonMath::AtomicMin ( GPUglobalref() GPUAtomic(int) *addr,
 	::atomic_min( (volatile __global int*) addr, val );
 #elif defined(GPUCA_GPUCODE) && (defined (__CUDACC__) || defined(__HIPCC_))
 	::atomicMin( addr, val );
+#elif defined(__GNUC__)
+	int current = __atomic_load_n( addr, __ATOMIC_RELAXED );
+	while ( current > val && !__atomic_compare_exchange_n( addr, &current, val, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) );
 #else
 #ifdef GPUCA_HAVE_OPENMP
 	while (*addr > val) AtomicExch(addr, val);
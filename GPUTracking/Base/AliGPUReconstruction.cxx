@@ -73,9 +73,10 @@ int AliGPUReconstruction::Init()
 	mRecoStepsGPU &= mRecoSteps;
 	mRecoStepsGPU &= AvailableRecoSteps();
 	if (!IsGPU()) mRecoStepsGPU.set((unsigned char) 0);
-	if (!IsGPU()) mDeviceProcessingSettings.trackletConstructorInPipeline = mDeviceProcessingSettings.trackletSelectorInPipeline = false;
+	if (!IsGPU()) mDeviceProcessingSettings.trackletSelectorInPipeline = mDeviceProcessingSettings.trackletConstructorInPipeline;
 	if (param().rec.NonConsecutiveIDs) param().rec.DisableRefitAttachment = 0xFF;
 	if (!mDeviceProcessingSettings.trackletConstructorInPipeline) mDeviceProcessingSettings.trackletSelectorInPipeline = false;
+	if (mDeviceProcessingSettings.mergerFitLanes > 0) mDeviceProcessingSettings.mergerFitLanes = mDeviceProcessingSettings.mergerFitLanes <= 4 ? 4 : mDeviceProcessingSettings.mergerFitLanes <= 8 ? 8 : 16;
 		
 #ifdef GPUCA_HAVE_OPENMP
 	if (mDeviceProcessingSettings.nThreads <= 0) mDeviceProcessingSettings.nThreads = omp_get_max_threads();
@@ -15,6 +15,7 @@
 #include "AliGPUTPCStartHitsSorter.h"
 #include "AliGPUTPCTrackletConstructor.h"
 #include "AliGPUTPCTrackletSelector.h"
+#include "AliGPUTPCGlobalTracking.h"
 #include "AliGPUTPCGMMergerGPU.h"
 #include "AliGPUTRDTrackerGPU.h"
 
@@ -19,6 +19,7 @@
 #include "AliGPUTPCStartHitsFinder.cxx"
 #include "AliGPUTPCStartHitsSorter.cxx"
 #include "AliGPUTPCTrackletConstructor.cxx"
+#include "AliGPUTPCGlobalTracking.cxx"
 
 #ifdef GPUCA_BUILD_MERGER
 	#include "AliGPUTPCGMMergerGPU.cxx"
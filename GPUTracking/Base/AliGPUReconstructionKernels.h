@@ -24,6 +24,7 @@ protected:
 	virtual int runKernelImpl(classArgument<AliGPUTPCTrackletConstructor>, const krnlExec& x, const krnlRunRange& y, const krnlEvent& z) GPUCA_KRNL(({return T::template runKernelBackend<AliGPUTPCTrackletConstructor>(x, y, z);}))
 	virtual int runKernelImpl(classArgument<AliGPUTPCTrackletConstructor, 1>, const krnlExec& x, const krnlRunRange& y, const krnlEvent& z) GPUCA_KRNL(({return T::template runKernelBackend<AliGPUTPCTrackletConstructor, 1>(x, y, z);}))
 	virtual int runKernelImpl(classArgument<AliGPUTPCTrackletSelector>, const krnlExec& x, const krnlRunRange& y, const krnlEvent& z) GPUCA_KRNL(({return T::template runKernelBackend<AliGPUTPCTrackletSelector>(x, y, z);}))
+	virtual int runKernelImpl(classArgument<AliGPUTPCGlobalTracking>, const krnlExec& x, const krnlRunRange& y, const krnlEvent& z) GPUCA_KRNL(({return T::template runKernelBackend<AliGPUTPCGlobalTracking>(x, y, z);}))
 	virtual int runKernelImpl(classArgument<AliGPUMemClean16>, const krnlExec& x, const krnlRunRange& y, const krnlEvent& z, void* ptr, unsigned long size) GPUCA_KRNL(({return T::template runKernelBackend<AliGPUMemClean16>(x, y, z, ptr, size);}))
 	virtual int runKernelImpl(classArgument<AliGPUTPCGMMergerTrackFit>, const krnlExec& x, const krnlRunRange& y, const krnlEvent& z) GPUCA_KRNL(({return T::template runKernelBackend<AliGPUTPCGMMergerTrackFit>(x, y, z);}))
 	virtual int runKernelImpl(classArgument<AliGPUTRDTrackerGPU>, const krnlExec& x, const krnlRunRange& y, const krnlEvent& z) GPUCA_KRNL(({return T::template runKernelBackend<AliGPUTRDTrackerGPU>(x, y, z);}))
@@ -19,6 +19,8 @@ void AliGPUSettingsRec::SetDefaults()
 	TrackReferenceX = 1000.f;
 	NonConsecutiveIDs = false;
 	DisableRefitAttachment = 0;
+	RefitMaxAttempts = 2;
+	RefitMaxLooperSteps = 0;
 }
 
 void AliGPUSettingsEvent::SetDefaults()
@@ -55,4 +57,9 @@ void AliGPUSettingsDeviceProcessing::SetDefaults()
 	nStreams = 8;
 	trackletConstructorInPipeline = true;
 	trackletSelectorInPipeline = false;
+	mergerSortTracks = false;
+	mergerFitLanes = 0;
+	mergerIncremental = false;
+	mergerCompactOutput = false;
+	sliceOutputClusterIndex = false;
 }
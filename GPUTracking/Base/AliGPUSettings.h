@@ -33,6 +33,8 @@ struct AliGPUSettingsRec
 	float TrackReferenceX;						//Transport all tracks to this X after tracking (disabled if > 500)
 	char NonConsecutiveIDs;						//Non-consecutive cluster IDs as in HLT, disables features that need access to slice data in TPC merger
 	unsigned char DisableRefitAttachment;		//Bitmask to disable cluster attachment steps in refit: 1: attachment, 2: propagation, 4: loop following, 8: mirroring
+	char RefitMaxAttempts;						//Max number of fit attempts per track in the refit, a rejected track is fit again without the special errors
+	int RefitMaxLooperSteps;					//Budget of loop following propagation steps per track in the refit, once used up the track is finished without loop following and further attempts (0 or negative = unlimited)
 };
 
 //Settings describing the events / time frames
@@ -88,6 +90,11 @@ struct AliGPUSettingsDeviceProcessing
 	int nStreams;								//Number of parallel GPU streams
 	bool trackletConstructorInPipeline;			//Run tracklet constructor in pileline like the preceeding tasks instead of as one big block
 	bool trackletSelectorInPipeline;			//Run tracklet selector in pipeline, requres also tracklet constructor in pipeline
+	bool mergerSortTracks;						//Process the tracks in the merger track fit ordered by their number of clusters, longest first
+	int mergerFitLanes;							//Refit 4, 8, or 16 tracks with similar numbers of clusters in lock-step in SIMD lanes (CPU only, 0 = one track at a time)
+	bool mergerIncremental;						//Unpack and merge the slices in the merger as soon as their output is ready, while other slices are still tracked (CPU only)
+	bool mergerCompactOutput;					//Write the merged tracks also in the compact format of AliGPUTPCGMMergedTrackCompact
+	bool sliceOutputClusterIndex;				//Store only the indices of the input clusters in the slice output, the merger reads the clusters from the input (not for a separate merger without the input clusters)
 };
 
 #endif
@@ -18,6 +18,7 @@
 #pragma link C++ class AliGPUTPCStartHitsFinder+;
 #pragma link C++ class AliGPUTPCTrackletConstructor+;
 #pragma link C++ class AliGPUTPCTrackletSelector+;
+#pragma link C++ class AliGPUTPCGlobalTracking+;
 #pragma link C++ class AliGPUTPCGlobalMergerComponent+;
 #pragma link C++ class AliGPUTPCClusterData+;
 #pragma link C++ class AliGPUTPCSliceData+;
@@ -29,6 +30,7 @@
 #pragma link C++ class AliGPUTPCGMPropagator+;
 #pragma link C++ class AliGPUTPCGMPhysicalTrackModel+;
 #pragma link C++ class AliGPUTPCGMPolynomialFieldManager+;
+#pragma link C++ class AliGPUTPCGMMaterialLUT+;
 #pragma link C++ class AliHLTTPCClusterStatComponent+;
 
 //#pragma link C++ class AliGPUTRDTrack+; //Templated, should add linkdef for specialization, but with an ifdef for ROOT >= 6 only
@@ -6,6 +6,7 @@
 #include "AliGPUTPCSliceOutCluster.h"
 #include "AliGPUTPCGMMergedTrack.h"
 #include "AliGPUTPCGMMergedTrackHit.h"
+#include "AliGPUTPCGMMergedTrackCompact.h"
 #include "AliGPUTRDTrackletWord.h"
 #include "AliHLTTPCClusterMCData.h"
 #include "AliGPUTPCMCInfo.h"
@@ -19,9 +20,13 @@
 #include "AliGPULogging.h"
 
 #include "TPCFastTransform.h"
+#include "AliGPUTPCGMMaterialLUT.h"
 
 #include "utils/linux_helpers.h"
 
+#include <algorithm>
+#include <vector>
+
 #ifdef HAVE_O2HEADERS
 #include "TRDBase/TRDGeometryFlat.h"
 #else
@@ -104,6 +109,14 @@ int AliGPUChainTracking::Init()
 			mFlatObjectsShadow.fTrdGeometry->clearInternalBufferPtr();
 		}
 	#endif
+		if (mMaterialLUT)
+		{
+			memcpy((void*) mFlatObjectsShadow.fMaterialLUT, (const void*) mMaterialLUT.get(), sizeof(*mMaterialLUT));
+			memcpy((void*) mFlatObjectsShadow.fMaterialLUTBuffer, (const void*) mMaterialLUT->getFlatBufferPtr(), mMaterialLUT->getFlatBufferSize());
+			mFlatObjectsShadow.fMaterialLUT->clearInternalBufferPtr();
+			mFlatObjectsShadow.fMaterialLUT->setActualBufferAddress(mFlatObjectsShadow.fMaterialLUTBuffer);
+			mFlatObjectsShadow.fMaterialLUT->setFutureBufferAddress(mFlatObjectsDevice.fMaterialLUTBuffer);
+		}
 		TransferMemoryResourceLinkToGPU(mFlatObjectsShadow.mMemoryResFlat);
 	}
 	
@@ -137,6 +150,11 @@ void* AliGPUChainTracking::AliGPUTrackingFlatObjects::SetPointersFlatObjects(voi
 	{
 		computePointerWithAlignment(mem, fTrdGeometry, 1);
 	}
+	if (fChainTracking->GetMaterialLUT())
+	{
+		computePointerWithAlignment(mem, fMaterialLUT, 1);
+		computePointerWithAlignment(mem, fMaterialLUTBuffer, fChainTracking->GetMaterialLUT()->getFlatBufferSize());
+	}
 	return mem;
 }
 
@@ -332,6 +350,13 @@ void AliGPUChainTracking::SetTRDGeometry(const o2::trd::TRDGeometryFlat& geo)
 	mTRDGeometry.reset(new o2::trd::TRDGeometryFlat(geo));
 }
 
+void AliGPUChainTracking::SetMaterialLUT(std::unique_ptr<AliGPUTPCGMMaterialLUT> materialLUT)
+{
+	//The flat object memory and the GPU copy of the table are set up in Init
+	if (mRec->IsInitialized()) throw std::runtime_error("Cannot set the material LUT once initialized");
+	mMaterialLUT = std::move(materialLUT);
+}
+
 int AliGPUChainTracking::ReadEvent(int iSlice, int threadId)
 {
 	if (GetDeviceProcessingSettings().debugLevel >= 5) {GPUInfo("Running ReadEvent for slice %d on thread %d\n", iSlice, threadId);}
@@ -358,21 +383,13 @@ int AliGPUChainTracking::GlobalTracking(int iSlice, int threadId)
 {
 	if (GetDeviceProcessingSettings().debugLevel >= 5) {GPUInfo("GPU Tracker running Global Tracking for slice %d on thread %d\n", iSlice, threadId);}
 
-	int sliceLeft = (iSlice + (NSLICES / 2 - 1)) % (NSLICES / 2);
-	int sliceRight = (iSlice + 1) % (NSLICES / 2);
-	if (iSlice >= (int) NSLICES / 2)
-	{
-		sliceLeft += NSLICES / 2;
-		sliceRight += NSLICES / 2;
-	}
+	const int sliceLeft = AliGPUTPCGlobalTracking::GlobalTrackingSliceLeft(iSlice);
+	const int sliceRight = AliGPUTPCGlobalTracking::GlobalTrackingSliceRight(iSlice);
 	while (fSliceOutputReady < iSlice || fSliceOutputReady < sliceLeft || fSliceOutputReady < sliceRight);
 
-	timerTPCtracking[iSlice][8].Start();
-	workers()->tpcTrackers[iSlice].PerformGlobalTracking(workers()->tpcTrackers[sliceLeft], workers()->tpcTrackers[sliceRight], GPUCA_MAX_TRACKS, GPUCA_MAX_TRACKS);
-	timerTPCtracking[iSlice][8].Stop();
+	//The kernel only adds tracks to slice iSlice, so different slices can be processed concurrently
+	runKernel<AliGPUTPCGlobalTracking>({1, 1, 0, krnlDeviceType::CPU}, &timerTPCtracking[iSlice][8], {(unsigned int) iSlice});
 
-	fSliceLeftGlobalReady[sliceLeft] = 1;
-	fSliceRightGlobalReady[sliceRight] = 1;
 	if (GetDeviceProcessingSettings().debugLevel >= 5) {GPUInfo("GPU Tracker finished Global Tracking for slice %d on thread %d\n", iSlice, threadId);}
 	return(0);
 }
@@ -394,7 +411,16 @@ int AliGPUChainTracking::RunTPCTrackingSlices()
 	ActivateThreadContext();
 	mRec->SetThreadCounts(RecoStep::TPCSliceTracking);
 	
-	int retVal = RunTPCTrackingSlices_internal();
+	for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
+	{
+		workers()->tpcTrackers[iSlice].SetCapacityScale(1.f);
+	}
+	int retVal;
+	while ((retVal = RunTPCTrackingSlices_internal()) == -1)
+	{
+		//A slice ran out of buffer space, its capacity was increased, process the event again
+		if (GetDeviceProcessingSettings().debugLevel >= 2) GPUInfo("Repeating TPC Slice Tracking with increased buffer sizes");
+	}
 	if (retVal) SynchronizeGPU();
 	if (retVal >= 2)
 	{
@@ -408,11 +434,17 @@ int AliGPUChainTracking::RunTPCTrackingSlices_internal()
 {
 	if (GetDeviceProcessingSettings().debugLevel >= 2) GPUInfo("Running TPC Slice Tracker");
 	bool doGPU = GetRecoStepsGPU() & RecoStep::TPCSliceTracking;
+	//The merger can process a slice as soon as its output is written, if all local tracks exist before the output of the first slice is written
+	const bool mergerIncremental = GetDeviceProcessingSettings().mergerIncremental && !doGPU && (GetRecoSteps() & RecoStep::TPCMerging) && !(GetRecoStepsGPU() & RecoStep::TPCMerging) && (param().rec.GlobalTracking || !GetDeviceProcessingSettings().trackletConstructorInPipeline);
+	AliGPUTPCGMMerger& Merger = workers()->tpcMerger;
+	Merger.SetIncremental(false);
 
 	int offset = 0;
 	for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
 	{
-		workers()->tpcTrackers[iSlice].Data().SetClusterData(mIOPtrs.clusterData[iSlice], mIOPtrs.nClusterData[iSlice], offset);
+		if (mIOPtrs.clusterData[iSlice]) workers()->tpcTrackers[iSlice].Data().SetClusterData(mIOPtrs.clusterData[iSlice], mIOPtrs.nClusterData[iSlice], offset);
+		else workers()->tpcTrackers[iSlice].Data().SetClusterData(&mIOPtrs.clusterDataSoA[iSlice], mIOPtrs.nClusterData[iSlice], offset);
+		workers()->tpcTrackers[iSlice].GPUParameters()->fGPUError = 0;
 		offset += mIOPtrs.nClusterData[iSlice];
 	}
 	if (doGPU)
@@ -557,15 +589,19 @@ int AliGPUChainTracking::RunTPCTrackingSlices_internal()
 			AllocateRegisteredMemory(trk.MemoryResTrackHits());
 		}
 
-		if (!doGPU || GetDeviceProcessingSettings().trackletConstructorInPipeline)
+		if (GetDeviceProcessingSettings().trackletConstructorInPipeline)
 		{
 			runKernel<AliGPUTPCTrackletConstructor>({ConstructorBlockCount(), ConstructorThreadCount(), useStream}, &timerTPCtracking[iSlice][6], {iSlice});
 			if (GetDeviceProcessingSettings().debugLevel >= 3) printf("Slice %d, Number of tracklets: %d\n", iSlice, *trk.NTracklets());
 			if (GetDeviceProcessingSettings().debugMask & 128) trk.DumpTrackletHits(mDebugFile);
 			if (GetDeviceProcessingSettings().debugMask & 256 && !GetDeviceProcessingSettings().comparableDebutOutput) trk.DumpHitWeights(mDebugFile);
 		}
+		else if (!doGPU)
+		{
+			trk.GPUParameters()->fNextTracklet = 0;
+		}
 
-		if (!doGPU || GetDeviceProcessingSettings().trackletSelectorInPipeline)
+		if (GetDeviceProcessingSettings().trackletSelectorInPipeline)
 		{
 			runKernel<AliGPUTPCTrackletSelector>({SelectorBlockCount(), SelectorThreadCount(), useStream}, &timerTPCtracking[iSlice][7], {iSlice});
 			TransferMemoryResourceLinkToHost(trk.MemoryResCommon(), useStream, &mEvents.selector[iSlice]);
@@ -574,7 +610,7 @@ int AliGPUChainTracking::RunTPCTrackingSlices_internal()
 			if (GetDeviceProcessingSettings().debugMask & 512) trk.DumpTrackHits(mDebugFile);
 		}
 
-		if (!doGPU)
+		if (!doGPU && GetDeviceProcessingSettings().trackletSelectorInPipeline)
 		{
 			trk.CommonMemory()->fNLocalTracks = trk.CommonMemory()->fNTracks;
 			trk.CommonMemory()->fNLocalTrackHits = trk.CommonMemory()->fNTrackHits;
@@ -586,6 +622,52 @@ int AliGPUChainTracking::RunTPCTrackingSlices_internal()
 	}
 	if (error) return(3);
 
+	if (!doGPU && !GetDeviceProcessingSettings().trackletConstructorInPipeline)
+	{
+		//All start hits exist now, the tracklet constructor balances the tracklets of all slices over the CPU threads
+		runKernel<AliGPUTPCTrackletConstructor, 1>({ConstructorBlockCount(), ConstructorThreadCount(), 0}, &timerTPCtracking[0][6]);
+		if (mergerIncremental && !param().rec.GlobalTracking)
+		{
+			Merger.SetIncremental(true);
+			SetupGPUProcessor(&Merger, true);
+		}
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(GetDeviceProcessingSettings().nThreads)
+#endif
+		for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
+		{
+			AliGPUTPCTracker& trk = workers()->tpcTrackers[iSlice];
+			if (trk.NHitsTotal() < 1)
+			{
+				if (Merger.Incremental())
+				{
+					Merger.SetSliceData(iSlice, trk.Output());
+					Merger.MergeSliceIncremental(iSlice);
+				}
+				continue;
+			}
+			if (GetDeviceProcessingSettings().debugLevel >= 3) printf("Slice %d, Number of tracklets: %d\n", iSlice, *trk.NTracklets());
+			if (GetDeviceProcessingSettings().debugMask & 128) trk.DumpTrackletHits(mDebugFile);
+			if (GetDeviceProcessingSettings().debugMask & 256 && !GetDeviceProcessingSettings().comparableDebutOutput) trk.DumpHitWeights(mDebugFile);
+
+			runKernel<AliGPUTPCTrackletSelector>({SelectorBlockCount(), SelectorThreadCount(), 0}, &timerTPCtracking[iSlice][7], {iSlice});
+			if (GetDeviceProcessingSettings().debugLevel >= 3) printf("Slice %d, Number of tracks: %d\n", iSlice, *trk.NTracks());
+			if (GetDeviceProcessingSettings().debugMask & 512) trk.DumpTrackHits(mDebugFile);
+
+			trk.CommonMemory()->fNLocalTracks = trk.CommonMemory()->fNTracks;
+			trk.CommonMemory()->fNLocalTrackHits = trk.CommonMemory()->fNTrackHits;
+			if (!param().rec.GlobalTracking)
+			{
+				WriteOutput(iSlice, 0);
+			}
+			if (Merger.Incremental())
+			{
+				Merger.SetSliceData(iSlice, trk.Output());
+				Merger.MergeSliceIncremental(iSlice);
+			}
+		}
+	}
+
 	if (doGPU)
 	{
 		ReleaseEvent(&mEvents.init);
@@ -637,18 +719,12 @@ int AliGPUChainTracking::RunTPCTrackingSlices_internal()
 		}
 
 		fSliceOutputReady = 0;
-
-		if (param().rec.GlobalTracking)
-		{
-			memset((void*) fSliceLeftGlobalReady, 0, sizeof(fSliceLeftGlobalReady));
-			memset((void*) fSliceRightGlobalReady, 0, sizeof(fSliceRightGlobalReady));
-			fGlobalTrackingDone.fill(0);
-			fWriteOutputDone.fill(0);
-		}
 		RunHelperThreads(&AliGPUChainTracking::HelperOutput, this, NSLICES);
 
 		std::array<bool, NSLICES> transferRunning;
 		transferRunning.fill(true);
+		std::array<bool, NSLICES> outputDone;
+		outputDone.fill(false);
 		unsigned int tmpSlice = 0;
 		for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
 		{
@@ -686,71 +762,24 @@ int AliGPUChainTracking::RunTPCTrackingSlices_internal()
 			if (GetDeviceProcessingSettings().debugLevel >= 3) GPUInfo("Data ready for slice %d, helper thread %d", iSlice, iSlice % (GetDeviceProcessingSettings().nDeviceHelperThreads + 1));
 			fSliceOutputReady = iSlice;
 
-			if (param().rec.GlobalTracking)
+			//Process the slices of the main thread as soon as the tracks of the slice and of its neighbours are on the host
+			for (unsigned int tmpSlice2 = 0;tmpSlice2 < NSLICES;tmpSlice2 += GetDeviceProcessingSettings().nDeviceHelperThreads + 1)
 			{
-				if (iSlice % (NSLICES / 2) == 2)
+				if (outputDone[tmpSlice2]) continue;
+				if (param().rec.GlobalTracking)
 				{
-					int tmpId = iSlice % (NSLICES / 2) - 1;
-					if (iSlice >= NSLICES / 2) tmpId += NSLICES / 2;
-					GlobalTracking(tmpId, 0);
-					fGlobalTrackingDone[tmpId] = 1;
-				}
-				for (unsigned int tmpSlice3a = 0;tmpSlice3a < iSlice;tmpSlice3a += GetDeviceProcessingSettings().nDeviceHelperThreads + 1)
-				{
-					unsigned int tmpSlice3 = tmpSlice3a + 1;
-					if (tmpSlice3 % (NSLICES / 2) < 1) tmpSlice3 -= (NSLICES / 2);
-					if (tmpSlice3 >= iSlice) break;
-
-					unsigned int sliceLeft = (tmpSlice3 + (NSLICES / 2 - 1)) % (NSLICES / 2);
-					unsigned int sliceRight = (tmpSlice3 + 1) % (NSLICES / 2);
-					if (tmpSlice3 >= (int) NSLICES / 2)
-					{
-						sliceLeft += NSLICES / 2;
-						sliceRight += NSLICES / 2;
-					}
-
-					if (tmpSlice3 % (NSLICES / 2) != 1 && fGlobalTrackingDone[tmpSlice3] == 0 && sliceLeft < iSlice && sliceRight < iSlice)
-					{
-						GlobalTracking(tmpSlice3, 0);
-						fGlobalTrackingDone[tmpSlice3] = 1;
-					}
-
-					if (fWriteOutputDone[tmpSlice3] == 0 && fSliceLeftGlobalReady[tmpSlice3] && fSliceRightGlobalReady[tmpSlice3])
-					{
-						WriteOutput(tmpSlice3, 0);
-						fWriteOutputDone[tmpSlice3] = 1;
-					}
+					if (tmpSlice2 > iSlice || AliGPUTPCGlobalTracking::GlobalTrackingSliceLeft(tmpSlice2) > (int) iSlice || AliGPUTPCGlobalTracking::GlobalTrackingSliceRight(tmpSlice2) > (int) iSlice) continue;
+					GlobalTracking(tmpSlice2, 0);
 				}
-			}
-			else
-			{
-				if (iSlice % (GetDeviceProcessingSettings().nDeviceHelperThreads + 1) == 0)
+				else if (tmpSlice2 > iSlice)
 				{
-					WriteOutput(iSlice, 0);
+					break;
 				}
+				WriteOutput(tmpSlice2, 0);
+				outputDone[tmpSlice2] = true;
 			}
 		}
 		for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++) if (transferRunning[iSlice]) ReleaseEvent(&mEvents.selector[iSlice]);
-
-		if (param().rec.GlobalTracking)
-		{
-			for (unsigned int tmpSlice3a = 0;tmpSlice3a < NSLICES;tmpSlice3a += GetDeviceProcessingSettings().nDeviceHelperThreads + 1)
-			{
-				unsigned int tmpSlice3 = (tmpSlice3a + 1);
-				if (tmpSlice3 % (NSLICES / 2) < 1) tmpSlice3 -= (NSLICES / 2);
-				if (fGlobalTrackingDone[tmpSlice3] == 0) GlobalTracking(tmpSlice3, 0);
-			}
-			for (unsigned int tmpSlice3a = 0;tmpSlice3a < NSLICES;tmpSlice3a += GetDeviceProcessingSettings().nDeviceHelperThreads + 1)
-			{
-				unsigned int tmpSlice3 = (tmpSlice3a + 1);
-				if (tmpSlice3 % (NSLICES / 2) < 1) tmpSlice3 -= (NSLICES / 2);
-				if (fWriteOutputDone[tmpSlice3] == 0)
-				{
-					while (fSliceLeftGlobalReady[tmpSlice3] == 0 || fSliceRightGlobalReady[tmpSlice3] == 0);
-					WriteOutput(tmpSlice3, 0);
-				}
-			}
-		}
 		WaitForHelperThreads();
 	}
 	else
@@ -758,27 +787,37 @@ int AliGPUChainTracking::RunTPCTrackingSlices_internal()
 		fSliceOutputReady = NSLICES;
 		if (param().rec.GlobalTracking)
 		{
-			for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
+			//All local tracks exist now, the slices only depend on the local tracks of their neighbours
+			if (mergerIncremental)
 			{
-				GlobalTracking(iSlice, 0);
+				Merger.SetIncremental(true);
+				SetupGPUProcessor(&Merger, true);
 			}
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(GetDeviceProcessingSettings().nThreads)
+#endif
 			for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
 			{
+				GlobalTracking(iSlice, 0);
 				WriteOutput(iSlice, 0);
+				if (mergerIncremental)
+				{
+					Merger.SetSliceData(iSlice, workers()->tpcTrackers[iSlice].Output());
+					Merger.MergeSliceIncremental(iSlice);
+				}
 			}
 		}
 	}
 
-	for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
+	bool repeat[NSLICES];
+	int retVal;
+	while ((retVal = CheckTPCTrackingSlicesErrors(repeat)) == -1)
 	{
-		if (workers()->tpcTrackers[iSlice].GPUParameters()->fGPUError != 0)
-		{
-			const char* errorMsgs[] = GPUCA_ERROR_STRINGS;
-			const char* errorMsg = (unsigned) workers()->tpcTrackers[iSlice].GPUParameters()->fGPUError >= sizeof(errorMsgs) / sizeof(errorMsgs[0]) ? "UNKNOWN" : errorMsgs[workers()->tpcTrackers[iSlice].GPUParameters()->fGPUError];
-			GPUError("GPU Tracker returned Error Code %d (%s) in slice %d (Clusters %d)", workers()->tpcTrackers[iSlice].GPUParameters()->fGPUError, errorMsg, iSlice, workers()->tpcTrackers[iSlice].Data().NumberOfHits());
-			return(1);
-		}
+		//The buffers of the GPU and of the global allocation cannot be resized per slice, the full event is processed again
+		if (doGPU || GetDeviceProcessingSettings().memoryAllocationStrategy != AliGPUMemoryResource::ALLOCATION_INDIVIDUAL) return(-1);
+		if ((retVal = RepeatTPCTrackingSlices(repeat))) return(retVal);
 	}
+	if (retVal) return(retVal);
 
 	if (param().rec.GlobalTracking)
 	{
@@ -803,6 +842,99 @@ int AliGPUChainTracking::RunTPCTrackingSlices_internal()
 	return 0;
 }
 
+int AliGPUChainTracking::CheckTPCTrackingSlicesErrors(bool* repeat)
+{
+	//Returns -1 if slices overflowed their buffers and have to be processed again with increased capacities, these slices are flagged in repeat
+	bool retry = false;
+	for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
+	{
+		AliGPUTPCTracker& trk = workers()->tpcTrackers[iSlice];
+		const int gpuError = trk.GPUParameters()->fGPUError;
+		repeat[iSlice] = false;
+		if (gpuError != 0)
+		{
+			const char* errorMsgs[] = GPUCA_ERROR_STRINGS;
+			const char* errorMsg = (unsigned) gpuError >= sizeof(errorMsgs) / sizeof(errorMsgs[0]) ? "UNKNOWN" : errorMsgs[gpuError];
+			const bool overflow = gpuError == GPUCA_ERROR_TRACKLET_OVERFLOW || gpuError == GPUCA_ERROR_TRACK_OVERFLOW || gpuError == GPUCA_ERROR_STARTHIT_OVERFLOW;
+			if (overflow && trk.CapacityScale() * GPUCA_CAPACITY_SCALE_STEP <= GPUCA_MAX_CAPACITY_SCALE)
+			{
+				//Buffers were estimated too small, increase them for this slice and repeat the tracking instead of losing tracks
+				trk.SetCapacityScale(trk.CapacityScale() * GPUCA_CAPACITY_SCALE_STEP);
+				GPUWarning("Buffer overflow (%s) in slice %d (Clusters %d), repeating with capacity scale %f", errorMsg, iSlice, trk.Data().NumberOfHits(), trk.CapacityScale());
+				repeat[iSlice] = retry = true;
+				continue;
+			}
+			GPUError("GPU Tracker returned Error Code %d (%s) in slice %d (Clusters %d)", gpuError, errorMsg, iSlice, trk.Data().NumberOfHits());
+			return(1);
+		}
+	}
+	return(retry ? -1 : 0);
+}
+
+int AliGPUChainTracking::RepeatTPCTrackingSlices(const bool* repeat)
+{
+	//Process the slices flagged in repeat again with their enlarged buffers (CPU with individual allocation only), and redo the global tracking and the output of the affected slices
+	AliGPUTPCGMMerger& Merger = workers()->tpcMerger;
+	Merger.SetIncremental(false); //The incremental merger is sized by the old capacities and has already used the output of the slices
+	bool error = false;
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(GetDeviceProcessingSettings().nThreads)
+#endif
+	for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
+	{
+		if (!repeat[iSlice]) continue;
+		AliGPUTPCTracker& trk = workers()->tpcTrackers[iSlice];
+		if (GetDeviceProcessingSettings().debugLevel >= 2) GPUInfo("Repeating TPC Slice Tracking for slice %d with capacity scale %f", iSlice, trk.CapacityScale());
+		trk.GPUParameters()->fGPUError = 0;
+		trk.SetMaxData();
+		AllocateRegisteredMemory(&trk);
+		if (ReadEvent(iSlice, 0))
+		{
+			GPUError("Error reading event");
+			error = 1;
+			continue;
+		}
+		if (trk.CheckEmptySlice()) continue;
+		runKernel<AliGPUMemClean16>({BlockCount(), ThreadCount(), 0}, &timerTPCtracking[iSlice][5], krnlRunRangeNone, {}, trk.Data().HitWeights(), trk.Data().NumberOfHitsPlusAlign() * sizeof(*trk.Data().HitWeights()));
+		runKernel<AliGPUTPCNeighboursFinder>({GPUCA_ROW_COUNT, FinderThreadCount(), 0}, &timerTPCtracking[iSlice][1], {iSlice});
+		runKernel<AliGPUTPCNeighboursCleaner>({GPUCA_ROW_COUNT - 2, ThreadCount(), 0}, &timerTPCtracking[iSlice][2], {iSlice});
+		runKernel<AliGPUTPCStartHitsFinder>({GPUCA_ROW_COUNT - 6, ThreadCount(), 0}, &timerTPCtracking[iSlice][3], {iSlice});
+		trk.UpdateMaxData();
+		AllocateRegisteredMemory(trk.MemoryResTracklets());
+		AllocateRegisteredMemory(trk.MemoryResTracks());
+		AllocateRegisteredMemory(trk.MemoryResTrackHits());
+		runKernel<AliGPUTPCTrackletConstructor>({ConstructorBlockCount(), ConstructorThreadCount(), 0}, &timerTPCtracking[iSlice][6], {iSlice});
+		runKernel<AliGPUTPCTrackletSelector>({SelectorBlockCount(), SelectorThreadCount(), 0}, &timerTPCtracking[iSlice][7], {iSlice});
+		trk.CommonMemory()->fNLocalTracks = trk.CommonMemory()->fNTracks;
+		trk.CommonMemory()->fNLocalTrackHits = trk.CommonMemory()->fNTrackHits;
+	}
+	if (error) return(3);
+
+	//The global tracks of a slice are prolonged from the local tracks of its neighbours
+	bool redoOutput[NSLICES];
+	for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
+	{
+		redoOutput[iSlice] = repeat[iSlice] || (param().rec.GlobalTracking && (repeat[AliGPUTPCGlobalTracking::GlobalTrackingSliceLeft(iSlice)] || repeat[AliGPUTPCGlobalTracking::GlobalTrackingSliceRight(iSlice)]));
+	}
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(GetDeviceProcessingSettings().nThreads)
+#endif
+	for (unsigned int iSlice = 0;iSlice < NSLICES;iSlice++)
+	{
+		if (!redoOutput[iSlice]) continue;
+		AliGPUTPCTracker& trk = workers()->tpcTrackers[iSlice];
+		if (trk.NHitsTotal() < 1) continue;
+		if (param().rec.GlobalTracking)
+		{
+			trk.CommonMemory()->fNTracks = trk.CommonMemory()->fNLocalTracks;
+			trk.CommonMemory()->fNTrackHits = trk.CommonMemory()->fNLocalTrackHits;
+			GlobalTracking(iSlice, 0);
+		}
+		WriteOutput(iSlice, 0);
+	}
+	return(0);
+}
+
 int AliGPUChainTracking::RunTPCTrackingMerger()
 {
 	bool doGPU = GetRecoStepsGPU() & RecoStep::TPCMerging;
@@ -822,7 +954,8 @@ int AliGPUChainTracking::RunTPCTrackingMerger()
 		nCount = 0;
 	}
 
-	SetupGPUProcessor(&Merger, true);
+	if (!Merger.Incremental()) SetupGPUProcessor(&Merger, true); //Otherwise allocated before the slice output was written
+	Merger.SetMaterialLUT(mMaterialLUT.get());
 	
 	timer.ResetStart();
 	Merger.UnpackSlices();
@@ -850,15 +983,24 @@ int AliGPUChainTracking::RunTPCTrackingMerger()
 	{
 		SetupGPUProcessor(&Merger, false);
 		MergerShadow.OverrideSliceTracker(workersDevice()->tpcTrackers);
+		MergerShadow.SetMaterialLUT(mFlatObjectsDevice.fMaterialLUT);
 	}
 	
 	WriteToConstantMemory((char*) &workers()->tpcMerger - (char*) workers(), &MergerShadow, sizeof(MergerShadow), 0);
 	TransferMemoryResourceLinkToGPU(Merger.MemoryResRefit());
 	times[6] += timer.GetCurrentElapsedTime(true);
 	
+	std::vector<float> trackFitTimes; //Refit time per track for the timing output, only measured by the CPU refit
+	if (GetDeviceProcessingSettings().debugLevel > 0 && !doGPU)
+	{
+		trackFitTimes.resize(Merger.NOutputTracks());
+		Merger.SetTrackFitTimes(trackFitTimes.data());
+	}
+	timer.ResetStart();
 	runKernel<AliGPUTPCGMMergerTrackFit>({BlockCount(), ThreadCount(), 0}, nullptr, krnlRunRangeNone);
 	SynchronizeGPU();
 	times[7] += timer.GetCurrentElapsedTime(true);
+	Merger.SetTrackFitTimes(nullptr);
 	
 	TransferMemoryResourceLinkToHost(Merger.MemoryResRefit());
 	SynchronizeGPU();
@@ -867,6 +1009,18 @@ int AliGPUChainTracking::RunTPCTrackingMerger()
 	Merger.Finalize();
 	times[9] += timer.GetCurrentElapsedTime(true);
 
+	size_t compactSize = 0;
+	double compactTime = 0.;
+	if (GetDeviceProcessingSettings().mergerCompactOutput)
+	{
+		unsigned int nTrackClusters = 0;
+		for (int i = 0;i < Merger.NOutputTracks();i++) nTrackClusters += Merger.OutputTracks()[i].NClusters();
+		mIOMem.mergedTracksCompact.reset(new char[AliGPUTPCGMMergedTrackCompact::MaxSize(Merger.NOutputTracks(), nTrackClusters)]);
+		compactSize = AliGPUTPCGMMergedTrackCompact::Encode(Merger.OutputTracks(), Merger.NOutputTracks(), Merger.Clusters(), mIOMem.mergedTracksCompact.get(), param().rec.NonConsecutiveIDs ? Merger.GlobalClusterIDs() : nullptr);
+		if (compactSize == 0) GPUError("Error writing compact merged track output");
+		compactTime = timer.GetCurrentElapsedTime(true);
+	}
+
 	nCount++;
 	if (GetDeviceProcessingSettings().debugLevel > 0)
 	{
@@ -880,15 +1034,38 @@ int AliGPUChainTracking::RunTPCTrackingMerger()
 		double speed = (double) copysize / times[6] * nCount / 1e9;
 		if (doGPU) printf("\t\tCopy From:\t%'7d us (%6.3f GB/s)\n", (int) (times[6] * 1000000 / nCount), speed);
 		printf("\t\tRefit:\t\t%'7d us\n", (int) (times[7] * 1000000 / nCount));
+		if (trackFitTimes.size())
+		{
+			std::sort(trackFitTimes.begin(), trackFitTimes.end());
+			const size_t n = trackFitTimes.size() - 1;
+			printf("\t\tRefit per track:\t50%% %.1f us, 90%% %.1f us, 99%% %.1f us, 99.9%% %.1f us, max %.1f us\n", trackFitTimes[n / 2] * 1e6, trackFitTimes[n * 9 / 10] * 1e6, trackFitTimes[n * 99 / 100] * 1e6, trackFitTimes[n * 999 / 1000] * 1e6, trackFitTimes[n] * 1e6);
+		}
 		speed = (double) copysize / times[8] * nCount / 1e9;
 		if (doGPU) printf("\t\tCopy To:\t%'7d us (%6.3f GB/s)\n", (int) (times[8] * 1000000 / nCount), speed);
 		printf("\t\tFinalize:\t%'7d us\n", (int) (times[9] * 1000000 / nCount));
+		if (GetDeviceProcessingSettings().mergerCompactOutput)
+		{
+			size_t nativeSize = Merger.NOutputTracks() * sizeof(AliGPUTPCGMMergedTrack) + Merger.NOutputTrackClusters() * sizeof(AliGPUTPCGMMergedTrackHit);
+			printf("\t\tCompact:\t%'7d us (%'lld bytes, native %'lld bytes)\n", (int) (compactTime * 1000000), (long long int) compactSize, (long long int) nativeSize);
+		}
+	}
+	if (param().rec.RefitMaxLooperSteps > 0 && GetDeviceProcessingSettings().debugLevel >= 0)
+	{
+		int nExceeded = 0, nLoopers = 0;
+		for (int i = 0;i < Merger.NOutputTracks();i++)
+		{
+			if (Merger.OutputTracks()[i].FitBudgetExceeded()) nExceeded++;
+			if (Merger.OutputTracks()[i].Looper()) nLoopers++;
+		}
+		GPUInfo("Refit looper budget (%d steps) exceeded by %d of %d tracks (%d loopers)", param().rec.RefitMaxLooperSteps, nExceeded, Merger.NOutputTracks(), nLoopers);
 	}
 	
 	mIOPtrs.mergedTracks = Merger.OutputTracks();
 	mIOPtrs.nMergedTracks = Merger.NOutputTracks();
 	mIOPtrs.mergedTrackHits = Merger.Clusters();
 	mIOPtrs.nMergedTrackHits = Merger.NOutputTrackClusters();
+	mIOPtrs.mergedTracksCompact = compactSize ? mIOMem.mergedTracksCompact.get() : nullptr;
+	mIOPtrs.nMergedTracksCompact = compactSize;
 
 	if (GetDeviceProcessingSettings().debugLevel >= 2) GPUInfo("TPC Merger Finished");
 	ReleaseThreadContext();
@@ -1184,29 +1361,15 @@ int AliGPUChainTracking::HelperReadEvent(int iSlice, int threadId, AliGPUReconst
 
 int AliGPUChainTracking::HelperOutput(int iSlice, int threadId, AliGPUReconstructionHelpers::helperParam* par)
 {
-	int mustRunSlice19 = 0;
 	if (param().rec.GlobalTracking)
 	{
-		int realSlice = iSlice + 1;
-		if (realSlice % (NSLICES / 2) < 1) realSlice -= NSLICES / 2;
-
-		if (realSlice % (NSLICES / 2) != 1)
+		const int sliceLeft = AliGPUTPCGlobalTracking::GlobalTrackingSliceLeft(iSlice);
+		const int sliceRight = AliGPUTPCGlobalTracking::GlobalTrackingSliceRight(iSlice);
+		while (fSliceOutputReady < iSlice || fSliceOutputReady < sliceLeft || fSliceOutputReady < sliceRight)
 		{
-			GlobalTracking(realSlice, threadId);
-		}
-
-		if (realSlice == 19)
-		{
-			mustRunSlice19 = 1;
-		}
-		else
-		{
-			while (fSliceLeftGlobalReady[realSlice] == 0 || fSliceRightGlobalReady[realSlice] == 0)
-			{
-				if (par->fReset) return 1;
-			}
-			WriteOutput(realSlice, threadId);
+			if (par->fReset) return 1;
 		}
+		GlobalTracking(iSlice, threadId);
 	}
 	else
 	{
@@ -1214,15 +1377,7 @@ int AliGPUChainTracking::HelperOutput(int iSlice, int threadId, AliGPUReconstruc
 		{
 			if (par->fReset) return 1;
 		}
-		WriteOutput(iSlice, threadId);
-	}
-	if (iSlice >= par->fCount - (GetDeviceProcessingSettings().nDeviceHelperThreads + 1) && mustRunSlice19)
-	{
-		while (fSliceLeftGlobalReady[19] == 0 || fSliceRightGlobalReady[19] == 0)
-		{
-			if (par->fReset) return 1;
-		}
-		WriteOutput(19, threadId);
 	}
+	WriteOutput(iSlice, threadId);
 	return 0;
 }
@@ -3,6 +3,7 @@
 
 #include "AliGPUChain.h"
 #include "AliGPUReconstructionHelpers.h"
+#include "AliGPUTPCClusterData.h"
 #include <atomic>
 #include <array>
 
@@ -16,13 +17,13 @@ class AliHLTTPCClusterMCLabel;
 class AliGPUTPCMCInfo;
 class AliGPUTRDTracker;
 class AliGPUTPCGPUTracker;
-struct AliGPUTPCClusterData;
 struct AliHLTTPCRawCluster;
 struct ClusterNativeAccessExt;
 struct AliGPUTRDTrackletLabels;
 class AliGPUDisplay;
 class AliGPUQA;
 class AliGPUTRDGeometry;
+class AliGPUTPCGMMaterialLUT;
 
 namespace o2 { namespace trd { class TRDGeometryFlat; }}
 namespace o2 { namespace TPC { struct ClusterNativeAccessFullTPC; struct ClusterNative; }}
@@ -44,13 +45,14 @@ public:
 	struct InOutPointers
 	{
 		InOutPointers() : mcLabelsTPC(nullptr), nMCLabelsTPC(0), mcInfosTPC(nullptr), nMCInfosTPC(0),
-			mergedTracks(nullptr), nMergedTracks(0), mergedTrackHits(nullptr), nMergedTrackHits(0),
+			mergedTracks(nullptr), nMergedTracks(0), mergedTrackHits(nullptr), nMergedTrackHits(0), mergedTracksCompact(nullptr), nMergedTracksCompact(0),
 			trdTracks(nullptr), nTRDTracks(0), trdTracklets(nullptr), nTRDTracklets(0), trdTrackletsMC(nullptr),
 			nTRDTrackletsMC(0)
 		{}
 		InOutPointers(const InOutPointers&) = default;
 		
 		const AliGPUTPCClusterData* clusterData[NSLICES];
+		AliGPUTPCClusterDataSoA clusterDataSoA[NSLICES]; //Column-wise cluster input, used for slices without clusterData
 		unsigned int nClusterData[NSLICES];
 		const AliHLTTPCRawCluster* rawClusters[NSLICES];
 		unsigned int nRawClusters[NSLICES];
@@ -67,6 +69,8 @@ public:
 		unsigned int nMergedTracks;
 		const AliGPUTPCGMMergedTrackHit* mergedTrackHits;
 		unsigned int nMergedTrackHits;
+		const char* mergedTracksCompact; //Merged tracks in the format of AliGPUTPCGMMergedTrackCompact, if enabled
+		unsigned int nMergedTracksCompact; //Size in bytes
 		const GPUTRDTrack* trdTracks;
 		unsigned int nTRDTracks;
 		const AliGPUTRDTrackletWord* trdTracklets;
@@ -91,6 +95,7 @@ public:
 		std::unique_ptr<AliGPUTPCMCInfo[]> mcInfosTPC;
 		std::unique_ptr<AliGPUTPCGMMergedTrack[]> mergedTracks;
 		std::unique_ptr<AliGPUTPCGMMergedTrackHit[]> mergedTrackHits;
+		std::unique_ptr<char[]> mergedTracksCompact;
 		std::unique_ptr<GPUTRDTrack[]> trdTracks;
 		std::unique_ptr<AliGPUTRDTrackletWord[]> trdTracklets;
 		std::unique_ptr<AliGPUTRDTrackletLabels[]> trdTrackletsMC;
@@ -128,9 +133,11 @@ public:
 	//Getters / setters for parameters
 	const TPCFastTransform* GetTPCTransform() const {return mTPCFastTransform.get();}
 	const AliGPUTRDGeometry* GetTRDGeometry() const {return (AliGPUTRDGeometry*) mTRDGeometry.get();}
+	const AliGPUTPCGMMaterialLUT* GetMaterialLUT() const {return mMaterialLUT.get();}
 	const ClusterNativeAccessExt* GetClusterNativeAccessExt() const {return mClusterNativeAccess.get();}
 	void SetTPCFastTransform(std::unique_ptr<TPCFastTransform> tpcFastTransform);
 	void SetTRDGeometry(const o2::trd::TRDGeometryFlat& geo);
+	void SetMaterialLUT(std::unique_ptr<AliGPUTPCGMMaterialLUT> materialLUT); //Must be called before Init
 	void LoadClusterErrors();
 	
 	const void* mConfigDisplay = nullptr;										//Abstract pointer to Standalone Display Configuration Structure
@@ -143,6 +150,8 @@ protected:
 		TPCFastTransform* fTpcTransform = nullptr;
 		char* fTpcTransformBuffer = nullptr;
 		o2::trd::TRDGeometryFlat* fTrdGeometry = nullptr;
+		AliGPUTPCGMMaterialLUT* fMaterialLUT = nullptr;
+		char* fMaterialLUTBuffer = nullptr;
 		void* SetPointersFlatObjects(void* mem);
 		short mMemoryResFlat = -1;
 	};
@@ -178,6 +187,7 @@ protected:
 	std::unique_ptr<ClusterNativeAccessExt> mClusterNativeAccess;				//Internal memory for clusterNativeAccess
 	std::unique_ptr<TPCFastTransform> mTPCFastTransform;						//Global TPC fast transformation object
 	std::unique_ptr<o2::trd::TRDGeometryFlat> mTRDGeometry;						//TRD Geometry
+	std::unique_ptr<AliGPUTPCGMMaterialLUT> mMaterialLUT;						//Material budget map for the track fit, optional
 	
 	HighResTimer timerTPCtracking[NSLICES][10];
 	eventStruct mEvents;
@@ -187,16 +197,14 @@ protected:
 #define volatile
 #endif
 	volatile int fSliceOutputReady;
-	volatile char fSliceLeftGlobalReady[NSLICES];
-	volatile char fSliceRightGlobalReady[NSLICES];
 #ifdef __ROOT__
 #undef volatile
 #endif
-	std::array<char, NSLICES> fGlobalTrackingDone;
-	std::array<char, NSLICES> fWriteOutputDone;
 
 private:
 	int RunTPCTrackingSlices_internal();
+	int CheckTPCTrackingSlicesErrors(bool* repeat);
+	int RepeatTPCTrackingSlices(const bool* repeat);
 	std::atomic_flag mLockAtomic = ATOMIC_FLAG_INIT;
 	
 	int HelperReadEvent(int iSlice, int threadId, AliGPUReconstructionHelpers::helperParam* par);
@@ -0,0 +1,126 @@
+// **************************************************************************
+// This file is property of and copyright by the ALICE HLT Project          *
+// ALICE Experiment at CERN, All rights reserved.                           *
+//                                                                          *
+// Permission to use, copy, modify and distribute this software and its     *
+// documentation strictly for non-commercial purposes is hereby granted     *
+// without fee, provided that the above copyright notice appears in all     *
+// copies and that both the copyright notice and this permission notice     *
+// appear in the supporting documentation. The authors make no claims       *
+// about the suitability of this software for any purpose. It is            *
+// provided "as is" without express or implied warranty.                    *
+//                                                                          *
+//***************************************************************************
+
+#include "AliGPUTPCGMMaterialLUT.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+AliGPUTPCGMMaterialLUT::AliGPUTPCGMMaterialLUT() : FlatObject(), fNR(0), fNZ(0), fNPhi(0), fRMin(0.f), fZMin(0.f), fRStepInv(0.f), fZStepInv(0.f), fPhiStepInv(0.f)
+{
+}
+
+void AliGPUTPCGMMaterialLUT::cloneFromObject(const AliGPUTPCGMMaterialLUT &obj, char *newFlatBufferPtr)
+{
+	FlatObject::cloneFromObject(obj, newFlatBufferPtr);
+	fNR = obj.fNR;
+	fNZ = obj.fNZ;
+	fNPhi = obj.fNPhi;
+	fRMin = obj.fRMin;
+	fZMin = obj.fZMin;
+	fRStepInv = obj.fRStepInv;
+	fZStepInv = obj.fZStepInv;
+	fPhiStepInv = obj.fPhiStepInv;
+}
+
+void AliGPUTPCGMMaterialLUT::destroy()
+{
+	fNR = fNZ = fNPhi = 0;
+	FlatObject::destroy();
+}
+
+void AliGPUTPCGMMaterialLUT::Construct(int nR, float rMin, float rMax, int nZ, float zMax, int nPhi, const Layer *layers, int nLayers, float defaultRadLen, float defaultRho, int nSub)
+{
+	FlatObject::startConstruction();
+
+	if (nR < 1) nR = 1;
+	if (nZ < 1) nZ = 1;
+	if (nPhi < 1) nPhi = 1;
+	if (nSub < 1) nSub = 1;
+	const double twoPi = 2. * M_PI;
+	const double stepR = nR > 1 ? (rMax - rMin) / (nR - 1) : 0.;
+	const double stepZ = nZ > 1 ? 2. * zMax / (nZ - 1) : 0.;
+	const double stepPhi = twoPi / nPhi;
+
+	fNR = nR;
+	fNZ = nZ;
+	fNPhi = nPhi;
+	fRMin = rMin;
+	fZMin = -zMax;
+	fRStepInv = stepR > 0. ? 1. / stepR : 0.f;
+	fZStepInv = stepZ > 0. ? 1. / stepZ : 0.f;
+	fPhiStepInv = 1. / stepPhi;
+
+	FlatObject::finishConstruction(nR * nZ * nPhi * sizeof(Material));
+
+	Material *nodes = reinterpret_cast<Material*>(mFlatBufferPtr);
+	std::vector<double> rEdges;
+	for (int iPhi = 0;iPhi < nPhi;iPhi++)
+	{
+		for (int iz = 0;iz < nZ;iz++)
+		{
+			for (int ir = 0;ir < nR;ir++)
+			{
+				//Average rho and rho / X0 over the cell around the node, so that layers thinner than a cell are not lost.
+				//In r the average is exact, the cell is split at all layer boundaries, in z and phi it is sampled at nSub points.
+				const double rLow = rMin + (ir - 0.5) * stepR, rHigh = rMin + (ir + 0.5) * stepR;
+				rEdges.clear();
+				rEdges.push_back(rLow);
+				for (int k = 0;k < nLayers;k++)
+				{
+					if (layers[k].fRMin > rLow && layers[k].fRMin < rHigh) rEdges.push_back(layers[k].fRMin);
+					if (layers[k].fRMax > rLow && layers[k].fRMax < rHigh) rEdges.push_back(layers[k].fRMax);
+				}
+				rEdges.push_back(rHigh);
+				std::sort(rEdges.begin(), rEdges.end());
+
+				double sumRho = 0., sumRhoOverRadLen = 0.;
+				for (int jPhi = 0;jPhi < nSub;jPhi++)
+				{
+					double phi = (iPhi + (jPhi + 0.5) / nSub - 0.5) * stepPhi;
+					if (phi < 0.) phi += twoPi;
+					for (int jz = 0;jz < nSub;jz++)
+					{
+						const double z = fZMin + (iz + (jz + 0.5) / nSub - 0.5) * stepZ;
+						for (unsigned int jr = 0;jr + 1 < rEdges.size();jr++)
+						{
+							const double r = 0.5 * (rEdges[jr] + rEdges[jr + 1]);
+							const double w = stepR > 0. ? (rEdges[jr + 1] - rEdges[jr]) / stepR : 1.;
+							double radLen = defaultRadLen, rho = defaultRho;
+							for (int k = 0;k < nLayers;k++)
+							{
+								const Layer &l = layers[k];
+								if (r < l.fRMin || r >= l.fRMax || z < l.fZMin || z >= l.fZMax) continue;
+								if (l.fPhiMin < l.fPhiMax)
+								{
+									double dPhi = phi - l.fPhiMin;
+									dPhi -= std::floor(dPhi / twoPi) * twoPi;
+									if (dPhi >= l.fPhiMax - l.fPhiMin) continue;
+								}
+								radLen = l.fRadLen;
+								rho = l.fRho;
+							}
+							sumRho += w * rho;
+							sumRhoOverRadLen += radLen > 1.e-4 ? w * rho / radLen : 0.;
+						}
+					}
+				}
+				const double norm = 1. / (nSub * nSub);
+				Material &node = nodes[(iPhi * nZ + iz) * nR + ir];
+				node.fRho = sumRho * norm;
+				node.fRhoOverRadLen = sumRhoOverRadLen * norm;
+			}
+		}
+	}
+}
@@ -0,0 +1,120 @@
+//-*- Mode: C++ -*-
+//*************************************************************************
+// This file is property of and copyright by the ALICE HLT Project        *
+// ALICE Experiment at CERN, All rights reserved.                         *
+// See cxx source for full Copyright notice                               *
+//                                                                        *
+//*************************************************************************
+
+#ifndef AliGPUTPCGMMaterialLUT_H
+#define AliGPUTPCGMMaterialLUT_H
+
+#include "AliGPUCommonDef.h"
+#include "FlatObject.h"
+
+/**
+ * @class AliGPUTPCGMMaterialLUT
+ *
+ * Material budget lookup table for the AliGPUTPCGMPropagator on a cylindrical (r, z, phi) grid.
+ * Each node stores rho and rho / X0 averaged over the cell around the node,
+ * the lookup interpolates linearly between the nodes, phi is periodic. Points outside of the grid in r or z have no entry,
+ * the caller then uses its default material.
+ * The node array is the only content of the flat buffer, so no pointers need to be relocated.
+ */
+class AliGPUTPCGMMaterialLUT : public ali_tpc_common::Base::FlatObject
+{
+  public:
+	struct Material
+	{
+		float fRho;           // density [g/cm^3]
+		float fRhoOverRadLen; // density / radiation length [g/cm^4]
+	};
+
+	/// Cylindrical layer used to construct the table, a layer with fPhiMin >= fPhiMax covers the full azimuth
+	struct Layer
+	{
+		float fRMin, fRMax;
+		float fZMin, fZMax;
+		float fPhiMin, fPhiMax;
+		float fRadLen; // radiation length [cm]
+		float fRho;    // density [g/cm^3]
+	};
+
+	AliGPUTPCGMMaterialLUT();
+	AliGPUTPCGMMaterialLUT(const AliGPUTPCGMMaterialLUT&) CON_DELETE;
+	AliGPUTPCGMMaterialLUT &operator=(const AliGPUTPCGMMaterialLUT &) CON_DELETE;
+	~AliGPUTPCGMMaterialLUT() CON_DEFAULT;
+
+	/// FlatObject functionality, see FlatObject class for description
+	using FlatObject::getClassAlignmentBytes;
+	using FlatObject::getBufferAlignmentBytes;
+	void cloneFromObject(const AliGPUTPCGMMaterialLUT &obj, char *newFlatBufferPtr);
+	void destroy();
+	using FlatObject::releaseInternalBuffer;
+#ifndef GPUCA_GPUCODE
+	using FlatObject::moveBufferTo;
+#endif
+	using FlatObject::setActualBufferAddress;
+	using FlatObject::setFutureBufferAddress;
+
+	/// Build the table from cylindrical layers, later layers override earlier ones, the rest of the volume gets the default material.
+	/// The nodes span [rMin, rMax] x [-zMax, zMax] x [0, 2pi), each node averages the material of its cell, exactly in r and over nSub^2 sample points in z and phi.
+	void Construct(int nR, float rMin, float rMax, int nZ, float zMax, int nPhi, const Layer *layers, int nLayers, float defaultRadLen, float defaultRho, int nSub = 4);
+
+	/// Returns false and leaves rho and rhoOverRadLen unchanged if r or z is outside of the grid
+	GPUd() bool GetMaterial(float r, float z, float phi, float &rho, float &rhoOverRadLen) const;
+
+	GPUd() int NR() const { return fNR; }
+	GPUd() int NZ() const { return fNZ; }
+	GPUd() int NPhi() const { return fNPhi; }
+
+  private:
+	GPUd() const Material *Nodes() const { return reinterpret_cast<const Material *>(mFlatBufferPtr); }
+	GPUd() static bool GridCoordinate(float v, float vMin, float stepInv, int n, int &i, float &f);
+
+	int fNR, fNZ, fNPhi; // number of nodes
+	float fRMin, fZMin;  // position of the first node, the first phi node is at 0
+	float fRStepInv, fZStepInv, fPhiStepInv; // inverse node distances
+};
+
+GPUdi() bool AliGPUTPCGMMaterialLUT::GridCoordinate(float v, float vMin, float stepInv, int n, int &i, float &f)
+{
+	//Lower node index and fraction towards the next node, false if v is outside of the grid, with a margin for the rounding at the boundary nodes
+	float u = (v - vMin) * stepInv;
+	if (!(u >= -1.e-4f && u <= n - 1 + 1.e-4f)) return false;
+	if (u < 0.f) u = 0.f;
+	if (u > n - 1) u = n - 1;
+	i = (int) u;
+	if (i > n - 2) i = n - 2;
+	if (i < 0) i = 0;
+	f = n > 1 ? (u - i) : 0.f;
+	return true;
+}
+
+GPUdi() bool AliGPUTPCGMMaterialLUT::GetMaterial(float r, float z, float phi, float &rho, float &rhoOverRadLen) const
+{
+	int ir, iz;
+	float fr, fz;
+	if (!GridCoordinate(r, fRMin, fRStepInv, fNR, ir, fr) || !GridCoordinate(z, fZMin, fZStepInv, fNZ, iz, fz)) return false;
+	float uPhi = phi * fPhiStepInv;
+	while (uPhi < 0.f) uPhi += fNPhi;
+	while (uPhi >= fNPhi) uPhi -= fNPhi;
+	int iPhi0 = (int) uPhi;
+	const float fPhi = uPhi - iPhi0;
+	if (iPhi0 >= fNPhi) iPhi0 = 0;
+	const int iPhi1 = iPhi0 + 1 < fNPhi ? iPhi0 + 1 : 0;
+	const int dr = fNR > 1 ? 1 : 0, dz = fNZ > 1 ? fNR : 0;
+
+	const Material *n0 = Nodes() + (iPhi0 * fNZ + iz) * fNR + ir;
+	const Material *n1 = Nodes() + (iPhi1 * fNZ + iz) * fNR + ir;
+	const float w00 = (1.f - fr) * (1.f - fz), w10 = fr * (1.f - fz), w01 = (1.f - fr) * fz, w11 = fr * fz;
+	const float rho0 = w00 * n0[0].fRho + w10 * n0[dr].fRho + w01 * n0[dz].fRho + w11 * n0[dz + dr].fRho;
+	const float rho1 = w00 * n1[0].fRho + w10 * n1[dr].fRho + w01 * n1[dz].fRho + w11 * n1[dz + dr].fRho;
+	const float x0 = w00 * n0[0].fRhoOverRadLen + w10 * n0[dr].fRhoOverRadLen + w01 * n0[dz].fRhoOverRadLen + w11 * n0[dz + dr].fRhoOverRadLen;
+	const float x1 = w00 * n1[0].fRhoOverRadLen + w10 * n1[dr].fRhoOverRadLen + w01 * n1[dz].fRhoOverRadLen + w11 * n1[dz + dr].fRhoOverRadLen;
+	rho = rho0 + fPhi * (rho1 - rho0);
+	rhoOverRadLen = x0 + fPhi * (x1 - x0);
+	return true;
+}
+
+#endif
@@ -36,6 +36,7 @@ class AliGPUTPCGMMergedTrack
 	GPUd() bool Looper()                           const { return fFlags & 0x02;    }
 	GPUd() bool CSide()                            const { return fFlags & 0x04;    }
 	GPUd() bool CCE()                              const { return fFlags & 0x08;    }
+	GPUd() bool FitBudgetExceeded()                const { return fFlags & 0x10;    }
   
 	GPUd() void SetNClusters      ( int v )                { fNClusters = v;       }
 	GPUd() void SetNClustersFitted( int v )                { fNClustersFitted = v; }
@@ -49,6 +50,7 @@ class AliGPUTPCGMMergedTrack
 	GPUd() void SetLooper( bool v )                        { if (v) fFlags |= 0x02; else fFlags &= 0xFD; }
 	GPUd() void SetCSide( bool v )                         { if (v) fFlags |= 0x04; else fFlags &= 0xFB; }
 	GPUd() void SetCCE( bool v )                           { if (v) fFlags |= 0x08; else fFlags &= 0xF7; }
+	GPUd() void SetFitBudgetExceeded( bool v )             { if (v) fFlags |= 0x10; else fFlags &= 0xEF; }
 	GPUd() void SetFlags ( unsigned char v )               { fFlags = v; }
   
 	GPUd() const AliGPUTPCGMTrackParam::AliGPUTPCOuterParam& OuterParam() const {return fOuterParam;}
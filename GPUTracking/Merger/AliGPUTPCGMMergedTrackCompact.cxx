@@ -0,0 +1,234 @@
+// **************************************************************************
+// This file is property of and copyright by the ALICE HLT Project          *
+// ALICE Experiment at CERN, All rights reserved.                           *
+//                                                                          *
+// Permission to use, copy, modify and distribute this software and its     *
+// documentation strictly for non-commercial purposes is hereby granted     *
+// without fee, provided that the above copyright notice appears in all     *
+// copies and that both the copyright notice and this permission notice     *
+// appear in the supporting documentation. The authors make no claims       *
+// about the suitability of this software for any purpose. It is            *
+// provided "as is" without express or implied warranty.                    *
+//                                                                          *
+//***************************************************************************
+
+#include "AliGPUTPCGMMergedTrackCompact.h"
+#include "AliGPUTPCGMMergedTrack.h"
+#include "AliGPUTPCGMMergedTrackHit.h"
+#include <cstring>
+
+static inline char *AliGPUTPCGMMergedTrackCompact_PutVarInt(char *ptr, unsigned long long v)
+{
+	while (v >= 0x80)
+	{
+		*(ptr++) = (char) (v | 0x80);
+		v >>= 7;
+	}
+	*(ptr++) = (char) v;
+	return ptr;
+}
+
+static inline const char *AliGPUTPCGMMergedTrackCompact_GetVarInt(const char *ptr, const char *end, unsigned long long &v)
+{
+	v = 0;
+	for (int shift = 0; ptr < end && shift < 64; shift += 7)
+	{
+		const unsigned char c = *(ptr++);
+		v |= (unsigned long long) (c & 0x7F) << shift;
+		if (!(c & 0x80)) return ptr;
+	}
+	return nullptr;
+}
+
+static inline unsigned long long AliGPUTPCGMMergedTrackCompact_ZigZag(long long v) { return ((unsigned long long) v << 1) ^ (unsigned long long) (v >> 63); }
+static inline long long AliGPUTPCGMMergedTrackCompact_UnZigZag(unsigned long long v) { return (long long) (v >> 1) ^ -(long long) (v & 1); }
+
+unsigned short AliGPUTPCGMMergedTrackCompact::FloatToHalf(float v)
+{
+	//Round to nearest even, finite values beyond the half range saturate at the largest finite half value
+	unsigned int f;
+	memcpy(&f, &v, sizeof(f));
+	const unsigned short sign = (f >> 16) & 0x8000;
+	const unsigned int fExp = (f >> 23) & 0xFF;
+	unsigned int mant = f & 0x7FFFFF;
+	if (fExp == 0xFF) return sign | 0x7C00 | (mant ? 0x200 : 0);
+	const int exp = (int) fExp - 127 + 15;
+	if (exp >= 31) return sign | 0x7BFF;
+	if (exp <= 0)
+	{
+		if (exp < -10) return sign;
+		mant |= 0x800000;
+		const int shift = 14 - exp;
+		unsigned int h = mant >> shift;
+		const unsigned int rem = mant & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+		if (rem > halfway || (rem == halfway && (h & 1))) h++;
+		return sign | h;
+	}
+	unsigned int h = ((unsigned int) exp << 10) | (mant >> 13);
+	const unsigned int rem = mant & 0x1FFF;
+	if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) h++;
+	if (h >= 0x7C00) h = 0x7BFF;
+	return sign | h;
+}
+
+float AliGPUTPCGMMergedTrackCompact::HalfToFloat(unsigned short h)
+{
+	const unsigned int sign = (unsigned int) (h & 0x8000) << 16;
+	unsigned int exp = (h >> 10) & 0x1F, mant = h & 0x3FF, f;
+	if (exp == 0x1F) f = sign | 0x7F800000 | (mant << 13);
+	else if (exp) f = sign | ((exp + 112) << 23) | (mant << 13);
+	else if (mant == 0) f = sign;
+	else
+	{
+		//Denormal half, normalize for the float representation
+		exp = 113;
+		while (!(mant & 0x400))
+		{
+			mant <<= 1;
+			exp--;
+		}
+		f = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+	}
+	float v;
+	memcpy(&v, &f, sizeof(v));
+	return v;
+}
+
+size_t AliGPUTPCGMMergedTrackCompact::MaxSize(unsigned int nTracks, unsigned int nClusters)
+{
+	return sizeof(Header) + nTracks * sizeof(Track) + nClusters * fgkMaxClusterBytes;
+}
+
+size_t AliGPUTPCGMMergedTrackCompact::Encode(const AliGPUTPCGMMergedTrack *tracks, unsigned int nTracks, const AliGPUTPCGMMergedTrackHit *clusters, char *buffer, const int *clusterIDs)
+{
+	char *trackPtr = buffer + sizeof(Header);
+	char *ptr = trackPtr + nTracks * sizeof(Track);
+	unsigned int nClusters = 0;
+	for (unsigned int i = 0; i < nTracks; i++)
+	{
+		const AliGPUTPCGMMergedTrack &trk = tracks[i];
+		if (trk.NClusters() > 0xFFFF) return 0;
+		const AliGPUTPCGMTrackParam &param = trk.GetParam();
+		const AliGPUTPCGMTrackParam::AliGPUTPCOuterParam &outer = trk.OuterParam();
+		Track t;
+		memset(&t, 0, sizeof(t));
+		t.fX = param.GetX();
+		t.fZOffset = param.GetZOffset();
+		for (int j = 0; j < 5; j++) t.fP[j] = param.GetPar(j);
+		for (int j = 0; j < 15; j++) t.fC[j] = param.GetCov(j);
+		t.fChi2 = param.GetChi2();
+		t.fNDF = param.GetNDF();
+		t.fAlpha = trk.GetAlpha();
+		t.fLastX = trk.LastX();
+		t.fLastY = trk.LastY();
+		t.fLastZ = trk.LastZ();
+		t.fOuterX = outer.fX;
+		t.fOuterAlpha = outer.fAlpha;
+		for (int j = 0; j < 5; j++) t.fOuterP[j] = FloatToHalf(outer.fP[j]);
+		for (int j = 0; j < 15; j++) t.fOuterC[j] = FloatToHalf(outer.fC[j]);
+		t.fNClusters = trk.NClusters();
+		t.fNClustersFitted = trk.NClustersFitted();
+		t.fFlags = (trk.OK() ? 0x01 : 0) | (trk.Looper() ? 0x02 : 0) | (trk.CSide() ? 0x04 : 0) | (trk.CCE() ? 0x08 : 0) | (trk.FitBudgetExceeded() ? 0x10 : 0);
+		memcpy(trackPtr + i * sizeof(Track), &t, sizeof(t));
+
+		unsigned int lastNum = 0;
+		int lastRow = 0, lastSlice = 0, lastLeg = 0, lastState = 0;
+		for (unsigned int j = 0; j < trk.NClusters(); j++)
+		{
+			const unsigned int ref = trk.FirstClusterRef() + j;
+			const AliGPUTPCGMMergedTrackHit &cl = clusters[ref];
+			const unsigned int num = clusterIDs ? (unsigned int) clusterIDs[ref] : cl.fNum;
+			const bool newState = cl.fState != lastState, newSlice = cl.fSlice != lastSlice, newLeg = cl.fLeg != lastLeg;
+			ptr = AliGPUTPCGMMergedTrackCompact_PutVarInt(ptr, (AliGPUTPCGMMergedTrackCompact_ZigZag(cl.fRow - lastRow) << 3) | (newState ? 4 : 0) | (newSlice ? 2 : 0) | (newLeg ? 1 : 0));
+			if (newSlice) *(ptr++) = cl.fSlice;
+			if (newLeg) *(ptr++) = cl.fLeg;
+			if (newState) *(ptr++) = cl.fState;
+			ptr = AliGPUTPCGMMergedTrackCompact_PutVarInt(ptr, AliGPUTPCGMMergedTrackCompact_ZigZag((long long) num - (long long) lastNum));
+			lastNum = num;
+			lastRow = cl.fRow;
+			lastSlice = cl.fSlice;
+			lastLeg = cl.fLeg;
+			lastState = cl.fState;
+		}
+		nClusters += trk.NClusters();
+	}
+
+	Header hdr;
+	hdr.fMagic = fgkMagic;
+	hdr.fNTracks = nTracks;
+	hdr.fNClusters = nClusters;
+	hdr.fSize = ptr - buffer;
+	memcpy(buffer, &hdr, sizeof(hdr));
+	return hdr.fSize;
+}
+
+int AliGPUTPCGMMergedTrackCompact::GetCounts(const char *buffer, size_t size, unsigned int &nTracks, unsigned int &nClusters)
+{
+	Header hdr;
+	if (size < sizeof(hdr)) return 1;
+	memcpy(&hdr, buffer, sizeof(hdr));
+	if (hdr.fMagic != fgkMagic || hdr.fSize != size || sizeof(Header) + (size_t) hdr.fNTracks * sizeof(Track) > size) return 1;
+	nTracks = hdr.fNTracks;
+	nClusters = hdr.fNClusters;
+	return 0;
+}
+
+int AliGPUTPCGMMergedTrackCompact::Decode(const char *buffer, size_t size, AliGPUTPCGMMergedTrack *tracks, AliGPUTPCGMMergedTrackHit *clusters)
+{
+	unsigned int nTracks, nClusters;
+	if (GetCounts(buffer, size, nTracks, nClusters)) return 1;
+	const char *trackPtr = buffer + sizeof(Header);
+	const char *ptr = trackPtr + nTracks * sizeof(Track);
+	const char *const end = buffer + size;
+	unsigned int iCluster = 0;
+	for (unsigned int i = 0; i < nTracks; i++)
+	{
+		Track t;
+		memcpy(&t, trackPtr + i * sizeof(Track), sizeof(t));
+		if (t.fNClusters > nClusters - iCluster) return 1;
+		AliGPUTPCGMMergedTrack &trk = tracks[i];
+		AliGPUTPCGMTrackParam &param = trk.Param();
+		AliGPUTPCGMTrackParam::AliGPUTPCOuterParam &outer = trk.OuterParam();
+		param.SetX(t.fX);
+		param.ZOffset() = t.fZOffset;
+		for (int j = 0; j < 5; j++) param.SetPar(j, t.fP[j]);
+		for (int j = 0; j < 15; j++) param.SetCov(j, t.fC[j]);
+		param.SetChi2(t.fChi2);
+		param.SetNDF(t.fNDF);
+		trk.SetAlpha(t.fAlpha);
+		trk.SetLastX(t.fLastX);
+		trk.SetLastY(t.fLastY);
+		trk.SetLastZ(t.fLastZ);
+		outer.fX = t.fOuterX;
+		outer.fAlpha = t.fOuterAlpha;
+		for (int j = 0; j < 5; j++) outer.fP[j] = HalfToFloat(t.fOuterP[j]);
+		for (int j = 0; j < 15; j++) outer.fC[j] = HalfToFloat(t.fOuterC[j]);
+		trk.SetFirstClusterRef(iCluster);
+		trk.SetNClusters(t.fNClusters);
+		trk.SetNClustersFitted(t.fNClustersFitted);
+		trk.SetFlags(t.fFlags);
+
+		unsigned int lastNum = 0;
+		int lastRow = 0, lastSlice = 0, lastLeg = 0, lastState = 0;
+		for (unsigned int j = 0; j < t.fNClusters; j++)
+		{
+			unsigned long long v;
+			if ((ptr = AliGPUTPCGMMergedTrackCompact_GetVarInt(ptr, end, v)) == nullptr) return 1;
+			AliGPUTPCGMMergedTrackHit &cl = clusters[iCluster++];
+			memset(&cl, 0, sizeof(cl));
+			cl.fRow = lastRow + AliGPUTPCGMMergedTrackCompact_UnZigZag(v >> 3);
+			if (end - ptr < ((v & 4) ? 1 : 0) + ((v & 2) ? 1 : 0) + ((v & 1) ? 1 : 0)) return 1;
+			cl.fSlice = (v & 2) ? (unsigned char) *(ptr++) : lastSlice;
+			cl.fLeg = (v & 1) ? (unsigned char) *(ptr++) : lastLeg;
+			cl.fState = (v & 4) ? (unsigned char) *(ptr++) : lastState;
+			if ((ptr = AliGPUTPCGMMergedTrackCompact_GetVarInt(ptr, end, v)) == nullptr) return 1;
+			cl.fNum = lastNum + AliGPUTPCGMMergedTrackCompact_UnZigZag(v);
+			lastNum = cl.fNum;
+			lastRow = cl.fRow;
+			lastSlice = cl.fSlice;
+			lastLeg = cl.fLeg;
+			lastState = cl.fState;
+		}
+	}
+	return ptr != end || iCluster != nClusters;
+}
@@ -0,0 +1,70 @@
+//-*- Mode: C++ -*-
+// ************************************************************************
+// This file is property of and copyright by the ALICE HLT Project        *
+// ALICE Experiment at CERN, All rights reserved.                         *
+// See cxx source for full Copyright notice                               *
+//                                                                        *
+//*************************************************************************
+
+#ifndef ALIHLTTPCGMMERGEDTRACKCOMPACT_H
+#define ALIHLTTPCGMMERGEDTRACKCOMPACT_H
+
+#include <cstddef>
+
+class AliGPUTPCGMMergedTrack;
+struct AliGPUTPCGMMergedTrackHit;
+
+/**
+ * @class AliGPUTPCGMMergedTrackCompact
+ *
+ * Encoder / decoder of a compact format of the merger output tracks for shipping to downstream consumers.
+ * The buffer contains a Header, a fixed-size Track record per track, and a byte stream with the cluster references of all tracks.
+ * The fitted track parameters are stored unchanged, the outer parameters with half precision (saturated at the largest finite half value).
+ * The clusters of a merged track are sorted by row within each leg, so the cluster references are encoded as deltas to the previous cluster of the track:
+ * a varint with the zigzag-encoded row delta and three bits flagging a change of state, slice or leg, the new slice / leg / state byte if flagged,
+ * and a varint with the zigzag-encoded cluster index delta.
+ * With non-consecutive cluster IDs (HLT) the merger keeps the cluster IDs in a separate array, which is then passed to Encode and stored as cluster index.
+ * The cluster coordinates and amplitudes are not stored, they are available from the input clusters through the cluster index.
+ * The decoded tracks reference consecutive clusters in track order.
+ */
+class AliGPUTPCGMMergedTrackCompact
+{
+  public:
+	struct Header
+	{
+		unsigned int fMagic;
+		unsigned int fNTracks;
+		unsigned int fNClusters; // total number of cluster references of all tracks
+		unsigned int fSize;      // size of the buffer in bytes
+	};
+
+	struct Track
+	{
+		float fX, fZOffset, fP[5], fC[15], fChi2; // fitted parameters
+		int fNDF;
+		float fAlpha, fLastX, fLastY, fLastZ;
+		float fOuterX, fOuterAlpha;
+		unsigned short fOuterP[5], fOuterC[15]; // outer parameters, half precision
+		unsigned short fNClusters, fNClustersFitted;
+		unsigned char fFlags;
+	};
+
+	/// Upper limit of the buffer size for tracks with nClusters cluster references in total
+	static size_t MaxSize(unsigned int nTracks, unsigned int nClusters);
+	/// Encode the tracks into buffer, which must hold MaxSize bytes, returns the used size, or 0 if a track has too many clusters for the format
+	/// If clusterIDs is given, the cluster index of cluster reference i is clusterIDs[i] instead of clusters[i].fNum
+	static size_t Encode(const AliGPUTPCGMMergedTrack *tracks, unsigned int nTracks, const AliGPUTPCGMMergedTrackHit *clusters, char *buffer, const int *clusterIDs = nullptr);
+	/// Read the number of tracks and cluster references from the header, returns 1 if the buffer is not a valid compact buffer
+	static int GetCounts(const char *buffer, size_t size, unsigned int &nTracks, unsigned int &nClusters);
+	/// Decode the buffer into arrays sized according to GetCounts, returns 1 on corrupt input
+	static int Decode(const char *buffer, size_t size, AliGPUTPCGMMergedTrack *tracks, AliGPUTPCGMMergedTrackHit *clusters);
+
+	static unsigned short FloatToHalf(float v);
+	static float HalfToFloat(unsigned short h);
+
+  private:
+	static const unsigned int fgkMagic = 0x3254434d; // "MCT2"
+	static const size_t fgkMaxClusterBytes = 10;     // 2 bytes row varint, slice, leg, state, 5 bytes index varint
+};
+
+#endif
@@ -45,6 +45,7 @@
 #include <cmath>
 
 #include <algorithm>
+#include <atomic>
 
 #include "AliGPUTPCGPUConfig.h"
 
@@ -53,6 +54,15 @@
 static constexpr int kMaxParts = 400;
 static constexpr int kMaxClusters = 1000;
 
+//Cluster copy of a merge across the central electrode, the clusters of track 1 and then of track 0 are written to fDest
+struct AliGPUTPCGMMerger_CECopy
+{
+	int fSrc[2];
+	int fN[2];
+	bool fReverse[2];
+	int fDest;
+};
+
 //#define OFFLINE_FITTER
 
 #if !defined(GPUCA_ALIROOT_LIB) || defined(GPUCA_GPUCODE)
@@ -61,6 +71,7 @@ static constexpr int kMaxClusters = 1000;
 
 AliGPUTPCGMMerger::AliGPUTPCGMMerger() :
 	fField(),
+	fMaterialLUT(nullptr),
 	fTrackLinks(nullptr),
 	fNMaxSliceTracks(0),
 	fNMaxTracks(0),
@@ -75,10 +86,13 @@ AliGPUTPCGMMerger::AliGPUTPCGMMerger() :
 	fNOutputTrackClusters( 0 ),
 	fOutputTracks( 0 ),
 	fSliceTrackInfos( 0 ),
+	fIncremental(false),
 	fClusters(nullptr),
 	fGlobalClusterIDs(nullptr),
 	fClusterAttachment(nullptr),
 	fTrackOrder(nullptr),
+	fTrackOrderProcess(nullptr),
+	fTrackFitTimes(nullptr),
 	fTmpMem(0),
 	fBorderMemory(0),
 	fBorderRangeMemory(0),
@@ -99,7 +113,33 @@ AliGPUTPCGMMerger::AliGPUTPCGMMerger() :
 	fPrevSliceInd[ fgkNSlices/2 ] = last;
 
 	fField.Reset(); // set very wrong initial value in order to see if the field was not properly initialised
-	for (int i = 0; i < fgkNSlices; i++) fkSlices[i] = nullptr;
+	for (int i = 0; i < fgkNSlices; i++)
+	{
+		fkSlices[i] = nullptr;
+		fSliceNMaxTracks[i] = 0;
+		fSliceNLocalTracks[i] = 0;
+		fSlicePairReady[i] = 0;
+	}
+}
+
+inline AliGPUTPCSliceOutCluster AliGPUTPCGMMerger::SliceTrackCluster(const AliGPUTPCGMSliceTrack &track, int i) const
+{
+	//Cluster i of the slice track, read from the input clusters of the slice if the slice output stores only the cluster indices
+	const AliGPUTPCSliceOutTrack *sliceTr = track.OrigTrack();
+	if (!fkSlices[(int) track.Slice()]->ClusterIndexOutput()) return sliceTr->Cluster(i);
+	AliGPUTPCSliceOutCluster c;
+	fSliceTrackers[(int) track.Slice()].GetOutputCluster(c, sliceTr->ClusterIndex(i));
+	return c;
+}
+
+float AliGPUTPCGMMerger::SliceTrackMinClusterZ(const AliGPUTPCGMSliceTrack &track) const
+{
+	return CAMath::Min(SliceTrackCluster(track, 0).GetZ(), SliceTrackCluster(track, track.NClusters() - 1).GetZ());
+}
+
+float AliGPUTPCGMMerger::SliceTrackMaxClusterZ(const AliGPUTPCGMSliceTrack &track) const
+{
+	return CAMath::Max(SliceTrackCluster(track, 0).GetZ(), SliceTrackCluster(track, track.NClusters() - 1).GetZ());
 }
 
 //DEBUG CODE
@@ -158,7 +198,6 @@ void AliGPUTPCGMMerger::CheckMergedTracks()
 int AliGPUTPCGMMerger::GetTrackLabel(AliGPUTPCGMBorderTrack &trk)
 {
 	AliGPUTPCGMSliceTrack *track = &fSliceTrackInfos[trk.TrackID()];
-	const AliGPUTPCSliceOutCluster *clusters = track->OrigTrack()->Clusters();
 	int nClusters = track->OrigTrack()->NClusters();
 	std::vector<int> labels;
 	AliGPUTPCStandaloneFramework &hlt = AliGPUTPCStandaloneFramework::Instance();
@@ -166,7 +205,7 @@ int AliGPUTPCGMMerger::GetTrackLabel(AliGPUTPCGMBorderTrack &trk)
 	{
 		for (int j = 0; j < 3; j++)
 		{
-			int label = hlt.GetMCLabels()[clusters[i].GetId()].fClusterID[j].fMCID;
+			int label = hlt.GetMCLabels()[SliceTrackCluster(*track, i).GetId()].fClusterID[j].fMCID;
 			if (label >= 0) labels.push_back(label);
 		}
 	}
@@ -194,6 +233,7 @@ int AliGPUTPCGMMerger::GetTrackLabel(AliGPUTPCGMBorderTrack &trk)
 	}
 	return bestLabel;
 }
+
 #endif
 //END DEBUG CODE
 
@@ -208,18 +248,18 @@ void* AliGPUTPCGMMerger::SetPointersHostOnly(void* mem)
 {
 	computePointerWithAlignment(mem, fSliceTrackInfos, fNMaxSliceTracks);
 	if (mCAParam->rec.NonConsecutiveIDs) computePointerWithAlignment(mem, fGlobalClusterIDs, fNMaxOutputTrackClusters);
-	computePointerWithAlignment(mem, fBorderMemory, fNMaxSliceTracks);
-	computePointerWithAlignment(mem, fBorderRangeMemory, 2 * fNMaxSliceTracks);
+	computePointerWithAlignment(mem, fBorderMemory, 2 * fNMaxSliceTracks);
+	computePointerWithAlignment(mem, fBorderRangeMemory, 3 * fNMaxSingleSliceTracks * fgkNSlices);
 	computePointerWithAlignment(mem, fTrackLinks, fNMaxSliceTracks);
-	size_t tmpSize = CAMath::Max(fNMaxSingleSliceTracks * fgkNSlices * sizeof(int), fNMaxTracks * sizeof(int) + fNMaxClusters * sizeof(char));
+	size_t tmpSize = CAMath::Max(CAMath::Max(fNMaxSingleSliceTracks * fgkNSlices, 5 * CAMath::Max(fNMaxTracks, fNMaxSliceTracks)) * sizeof(int), fNMaxTracks * sizeof(AliGPUTPCGMMerger_CECopy));
 	computePointerWithAlignment(mem, fTmpMem, tmpSize);
 	
 	int nTracks = 0;
 	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
 	{
-		fBorder[iSlice] = fBorderMemory + nTracks;
-		fBorderRange[iSlice] = fBorderRangeMemory + 2 * nTracks;
-		nTracks += fkSlices[iSlice]->NTracks();
+		fBorder[iSlice] = fBorderMemory + 2 * nTracks;
+		fBorderRange[iSlice] = fBorderRangeMemory + 3 * fNMaxSingleSliceTracks * iSlice;
+		nTracks += fSliceNMaxTracks[iSlice];
 	}
 	return mem;
 }
@@ -229,6 +269,7 @@ void* AliGPUTPCGMMerger::SetPointersGPURefit(void* mem)
 	computePointerWithAlignment(mem, fOutputTracks, fNMaxTracks);
 	computePointerWithAlignment(mem, fClusters, fNMaxOutputTrackClusters);
 	computePointerWithAlignment(mem, fTrackOrder, fNMaxTracks);
+	if (mRec->GetDeviceProcessingSettings().mergerSortTracks || mRec->GetDeviceProcessingSettings().mergerFitLanes) computePointerWithAlignment(mem, fTrackOrderProcess, fNMaxTracks);
 	computePointerWithAlignment(mem, fClusterAttachment, fNMaxClusters);
 
 	return mem;
@@ -248,10 +289,19 @@ void AliGPUTPCGMMerger::SetMaxData()
 	fNMaxSingleSliceTracks = 0;
 	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
 	{
-		if (!fkSlices[iSlice]) continue;
-		fNMaxSliceTracks += fkSlices[iSlice]->NTracks();
-		fNClusters += fkSlices[iSlice]->NTrackClusters();
-		if (fNMaxSingleSliceTracks < fkSlices[iSlice]->NTracks()) fNMaxSingleSliceTracks = fkSlices[iSlice]->NTracks();
+		if (fIncremental)
+		{
+			//The slice output does not exist yet, the capacity of the slice tracker limits it
+			fSliceNMaxTracks[iSlice] = fSliceTrackers[iSlice].NMaxTracks();
+			fNClusters += fSliceTrackers[iSlice].NMaxTrackHits();
+		}
+		else
+		{
+			fSliceNMaxTracks[iSlice] = fkSlices[iSlice] ? fkSlices[iSlice]->NTracks() : 0;
+			if (fkSlices[iSlice]) fNClusters += fkSlices[iSlice]->NTrackClusters();
+		}
+		fNMaxSliceTracks += fSliceNMaxTracks[iSlice];
+		if (fNMaxSingleSliceTracks < fSliceNMaxTracks[iSlice]) fNMaxSingleSliceTracks = fSliceNMaxTracks[iSlice];
 	}
 	fNMaxOutputTrackClusters = fNClusters * 1.1f + 1000;
 	fNMaxTracks = fNMaxSliceTracks;
@@ -265,9 +315,45 @@ void AliGPUTPCGMMerger::SetSliceData(int index, const AliGPUTPCSliceOutput *slic
 	fkSlices[index] = sliceData;
 }
 
-void AliGPUTPCGMMerger::ClearTrackLinks(int n)
+void AliGPUTPCGMMerger::SetIncremental(bool incremental)
+{
+	//Must be set before the memory is allocated, in incremental mode the memory is sized by the capacities of the slice trackers
+	fIncremental = incremental;
+	for (int i = 0; i < fgkNSlices; i++) fSlicePairReady[i] = 0;
+}
+
+void AliGPUTPCGMMerger::ClearTrackLinks(int first, int last)
+{
+	for (int i = first; i < last; i++) fTrackLinks[i] = -1;
+}
+
+int AliGPUTPCGMMerger::UnpackSliceLocalTracks(int iSlice, int first, int *trackIds, const AliGPUTPCSliceOutTrack *&firstGlobalTrack)
 {
-	for (int i = 0; i < n; i++) fTrackLinks[i] = -1;
+	//* unpack the local tracks of a slice to the track infos starting at first, trackIds maps the local track id to the track info index
+
+	int nTracksCurrent = first;
+	float alpha = mCAParam->Alpha(iSlice);
+	const AliGPUTPCSliceOutput &slice = *(fkSlices[iSlice]);
+	const AliGPUTPCSliceOutTrack *sliceTr = slice.GetFirstTrack();
+
+	for (unsigned int i = 0; i < slice.NLocalTracks(); i++) trackIds[i] = -1;
+	for (unsigned int itr = 0; itr < slice.NLocalTracks(); itr++, sliceTr = sliceTr->GetNextTrack(slice.ClusterIndexOutput()))
+	{
+		AliGPUTPCGMSliceTrack &track = fSliceTrackInfos[nTracksCurrent];
+		track.Set(sliceTr, alpha, iSlice);
+		if (!track.FilterErrors(*mCAParam, SliceTrackCluster(track, sliceTr->NClusters() - 1).GetX(), GPUCA_MAX_SIN_PHI, 0.1f)) continue;
+		if (DEBUG) printf("INPUT Slice %d, Track %d, QPt %f DzDs %f\n", iSlice, itr, track.QPt(), track.DzDs());
+		track.SetPrevNeighbour(-1);
+		track.SetNextNeighbour(-1);
+		track.SetNextSegmentNeighbour(-1);
+		track.SetPrevSegmentNeighbour(-1);
+		track.SetGlobalTrackId(0, -1);
+		track.SetGlobalTrackId(1, -1);
+		trackIds[sliceTr->LocalTrackId()] = nTracksCurrent;
+		nTracksCurrent++;
+	}
+	firstGlobalTrack = sliceTr;
+	return nTracksCurrent - first;
 }
 
 void AliGPUTPCGMMerger::UnpackSlices()
@@ -288,33 +374,27 @@ void AliGPUTPCGMMerger::UnpackSlices()
 	if (maxSliceTracks > fNMaxSingleSliceTracks) throw std::runtime_error("fNMaxSingleSliceTracks too small");
 
 	int *TrackIds = (int*) fTmpMem;
-	for (unsigned int i = 0; i < maxSliceTracks * fgkNSlices; i++) TrackIds[i] = -1;
-
-	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
+	if (fIncremental)
 	{
-
-		fSliceTrackInfoIndex[iSlice] = nTracksCurrent;
-
-		float alpha = mCAParam->Alpha(iSlice);
-		const AliGPUTPCSliceOutput &slice = *(fkSlices[iSlice]);
-		const AliGPUTPCSliceOutTrack *sliceTr = slice.GetFirstTrack();
-
-		for (unsigned int itr = 0; itr < slice.NLocalTracks(); itr++, sliceTr = sliceTr->GetNextTrack())
+		//The local tracks were unpacked by MergeSliceIncremental, with the stride of the track id map fixed before the slices were known
+		maxSliceTracks = fNMaxSingleSliceTracks;
+		CompactIncrementalSlices(TrackIds);
+		nTracksCurrent = SliceTrackInfoLocalTotal();
+		for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
 		{
-			AliGPUTPCGMSliceTrack &track = fSliceTrackInfos[nTracksCurrent];
-			track.Set(sliceTr, alpha, iSlice);
-			if (!track.FilterErrors(*mCAParam, GPUCA_MAX_SIN_PHI, 0.1f)) continue;
-			if (DEBUG) printf("INPUT Slice %d, Track %d, QPt %f DzDs %f\n", iSlice, itr, track.QPt(), track.DzDs());
-			track.SetPrevNeighbour(-1);
-			track.SetNextNeighbour(-1);
-			track.SetNextSegmentNeighbour(-1);
-			track.SetPrevSegmentNeighbour(-1);
-			track.SetGlobalTrackId(0, -1);
-			track.SetGlobalTrackId(1, -1);
-			TrackIds[iSlice * maxSliceTracks + sliceTr->LocalTrackId()] = nTracksCurrent;
-			nTracksCurrent++;
+			const AliGPUTPCSliceOutTrack *sliceTr = fkSlices[iSlice]->GetFirstTrack();
+			for (unsigned int itr = 0; itr < fkSlices[iSlice]->NLocalTracks(); itr++) sliceTr = sliceTr->GetNextTrack(fkSlices[iSlice]->ClusterIndexOutput());
+			firstGlobalTracks[iSlice] = sliceTr;
+		}
+	}
+	else
+	{
+		for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
+		{
+			fSliceTrackInfoIndex[iSlice] = nTracksCurrent;
+			fSliceNLocalTracks[iSlice] = UnpackSliceLocalTracks(iSlice, nTracksCurrent, TrackIds + iSlice * maxSliceTracks, firstGlobalTracks[iSlice]);
+			nTracksCurrent += fSliceNLocalTracks[iSlice];
 		}
-		firstGlobalTracks[iSlice] = sliceTr;
 	}
 	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
 	{
@@ -323,7 +403,7 @@ void AliGPUTPCGMMerger::UnpackSlices()
 		float alpha = mCAParam->Alpha(iSlice);
 		const AliGPUTPCSliceOutput &slice = *(fkSlices[iSlice]);
 		const AliGPUTPCSliceOutTrack *sliceTr = firstGlobalTracks[iSlice];
-		for (unsigned int itr = slice.NLocalTracks(); itr < slice.NTracks(); itr++, sliceTr = sliceTr->GetNextTrack())
+		for (unsigned int itr = slice.NLocalTracks(); itr < slice.NTracks(); itr++, sliceTr = sliceTr->GetNextTrack(slice.ClusterIndexOutput()))
 		{
 			int localId = TrackIds[(sliceTr->LocalTrackId() >> 24) * maxSliceTracks + (sliceTr->LocalTrackId() & 0xFFFFFF)];
 			if (localId == -1) continue;
@@ -341,6 +421,79 @@ void AliGPUTPCGMMerger::UnpackSlices()
 	fSliceTrackInfoIndex[2 * fgkNSlices] = nTracksCurrent;
 }
 
+void AliGPUTPCGMMerger::MergeSliceIncremental(int iSlice)
+{
+	//* unpack a finished slice and merge its tracks within the slice, then match the border tracks of the neighbour pairs for which both slices are finished
+	//* each slice has a fixed region of fSliceNMaxTracks in the track infos, the track links, and the track id map, so the slices can be processed concurrently
+
+	int first = 0;
+	for (int i = 0; i < iSlice; i++) first += fSliceNMaxTracks[i];
+	const AliGPUTPCSliceOutTrack *firstGlobalTrack;
+	fSliceTrackInfoIndex[iSlice] = first;
+	fSliceNLocalTracks[iSlice] = UnpackSliceLocalTracks(iSlice, first, (int*) fTmpMem + iSlice * fNMaxSingleSliceTracks, firstGlobalTrack);
+	MergeWithinSlice(iSlice);
+	ClearTrackLinks(SliceTrackInfoFirst(iSlice), SliceTrackInfoLast(iSlice));
+
+	//The pair (slice, next slice) writes the links of the first slice and reads the tracks of both, the thread finishing the second slice of a pair runs it
+	std::atomic_thread_fence(std::memory_order_release);
+	const int pairs[2] = {iSlice, fPrevSliceInd[iSlice]};
+	for (int k = 0; k < 2; k++)
+	{
+		if (CAMath::AtomicAdd(&fSlicePairReady[pairs[k]], 1) != 1) continue;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		MergeSlicePair(pairs[k], 2, 3, false);
+	}
+}
+
+void AliGPUTPCGMMerger::CompactIncrementalSlices(int *trackIds)
+{
+	//* move the regions of the incrementally unpacked slices together, the within-slice links stay in the slice, the pair links point to the next slice
+
+	int shift[fgkNSlices];
+	int nTracks = 0;
+	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
+	{
+		shift[iSlice] = nTracks - fSliceTrackInfoIndex[iSlice];
+		nTracks += fSliceNLocalTracks[iSlice];
+	}
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads)
+#endif
+	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
+	{
+		const int d = shift[iSlice], dNext = shift[fNextSliceInd[iSlice]];
+		for (int itr = SliceTrackInfoFirst(iSlice); itr < SliceTrackInfoLast(iSlice); itr++)
+		{
+			AliGPUTPCGMSliceTrack &track = fSliceTrackInfos[itr];
+			if (track.PrevNeighbour() >= 0) track.SetPrevNeighbour(track.PrevNeighbour() + d);
+			if (track.NextNeighbour() >= 0) track.SetNextNeighbour(track.NextNeighbour() + d);
+			if (track.PrevSegmentNeighbour() >= 0) track.SetPrevSegmentNeighbour(track.PrevSegmentNeighbour() + d);
+			if (track.NextSegmentNeighbour() >= 0) track.SetNextSegmentNeighbour(track.NextSegmentNeighbour() + d);
+			if (fTrackLinks[itr] >= 0) fTrackLinks[itr] += dNext;
+		}
+		int *ids = trackIds + iSlice * fNMaxSingleSliceTracks;
+		for (unsigned int i = 0; i < fkSlices[iSlice]->NLocalTracks(); i++)
+		{
+			if (ids[i] >= 0) ids[i] += d;
+		}
+	}
+	//The regions only move down, in slice order no region is overwritten before it was moved
+	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
+	{
+		const int first = SliceTrackInfoFirst(iSlice);
+		if (shift[iSlice])
+		{
+			memmove(fSliceTrackInfos + first + shift[iSlice], fSliceTrackInfos + first, fSliceNLocalTracks[iSlice] * sizeof(*fSliceTrackInfos));
+			memmove(fTrackLinks + first + shift[iSlice], fTrackLinks + first, fSliceNLocalTracks[iSlice] * sizeof(*fTrackLinks));
+		}
+		fSliceTrackInfoIndex[iSlice] = first + shift[iSlice];
+	}
+	fSliceTrackInfoIndex[fgkNSlices] = nTracks;
+
+	fNClusters = 0;
+	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++) fNClusters += fkSlices[iSlice]->NTrackClusters();
+}
+
 void AliGPUTPCGMMerger::MakeBorderTracks(int iSlice, int iBorder, AliGPUTPCGMBorderTrack B[], int &nB, bool fromOrig)
 {
 	//* prepare slice tracks for merging with next/previous/same sector
@@ -413,6 +566,31 @@ void AliGPUTPCGMMerger::MakeBorderTracks(int iSlice, int iBorder, AliGPUTPCGMBor
 	}
 }
 
+static inline unsigned int AliGPUTPCGMMerger_RangeKey(const AliGPUTPCGMBorderTrack::Range &r, bool byMax)
+{
+	//Map the float to an unsigned int with the same ordering
+	union {float f; unsigned int i;} tmp;
+	tmp.f = byMax ? r.fMax : r.fMin;
+	return tmp.i ^ ((tmp.i & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+static void SortBorderRanges(AliGPUTPCGMBorderTrack::Range *ranges, AliGPUTPCGMBorderTrack::Range *tmp, int n, bool byMax)
+{
+	//Stable LSD radix sort of the ranges by fMin or fMax, 8 bits per pass, passes where all keys share the digit are skipped
+	if (n < 2) return;
+	AliGPUTPCGMBorderTrack::Range *in = ranges, *out = tmp;
+	for (int shift = 0;shift < 32;shift += 8)
+	{
+		int count[257] = {0};
+		for (int i = 0;i < n;i++) count[((AliGPUTPCGMMerger_RangeKey(in[i], byMax) >> shift) & 0xFF) + 1]++;
+		if (count[((AliGPUTPCGMMerger_RangeKey(in[0], byMax) >> shift) & 0xFF) + 1] == n) continue;
+		for (int i = 0;i < 256;i++) count[i + 1] += count[i];
+		for (int i = 0;i < n;i++) out[count[(AliGPUTPCGMMerger_RangeKey(in[i], byMax) >> shift) & 0xFF]++] = in[i];
+		std::swap(in, out);
+	}
+	if (in != ranges) memcpy(ranges, in, n * sizeof(*ranges));
+}
+
 void AliGPUTPCGMMerger::MergeBorderTracks(int iSlice1, AliGPUTPCGMBorderTrack B1[], int N1, int iSlice2, AliGPUTPCGMBorderTrack B2[], int N2, int crossCE)
 {
 	//* merge two sets of tracks
@@ -431,8 +609,10 @@ void AliGPUTPCGMMerger::MergeBorderTracks(int iSlice1, AliGPUTPCGMBorderTrack B1
 	int minNPartHits = 10; //SG!!!
 	int minNTotalHits = 20;
 
+	//All range buffers of a slice pair belong to the first slice, so slice pairs can be merged in parallel
 	AliGPUTPCGMBorderTrack::Range *range1 = fBorderRange[iSlice1];
-	AliGPUTPCGMBorderTrack::Range *range2 = fBorderRange[iSlice2] + N2;
+	AliGPUTPCGMBorderTrack::Range *range2 = range1 + fNMaxSingleSliceTracks;
+	AliGPUTPCGMBorderTrack::Range *rangeTmp = range2 + fNMaxSingleSliceTracks;
 
 	bool sameSlice = (iSlice1 == iSlice2);
 	{
@@ -446,11 +626,9 @@ void AliGPUTPCGMMerger::MergeBorderTracks(int iSlice1, AliGPUTPCGMBorderTrack B1
 			range1[itr].fMin = b.Par()[1] + b.ZOffset() - d;
 			range1[itr].fMax = b.Par()[1] + b.ZOffset() + d;
 		}
-		std::sort(range1,range1+N1,AliGPUTPCGMBorderTrack::Range::CompMin);
 		if(sameSlice)
 		{
 			for(int i=0; i<N1; i++) range2[i]= range1[i];
-			std::sort(range2,range2+N1,AliGPUTPCGMBorderTrack::Range::CompMax);
 			N2 = N1;
 			B2 = B1;
 		}
@@ -467,8 +645,9 @@ void AliGPUTPCGMMerger::MergeBorderTracks(int iSlice1, AliGPUTPCGMBorderTrack B1
 				range2[itr].fMin = b.Par()[1] + b.ZOffset() - d;
 				range2[itr].fMax = b.Par()[1] + b.ZOffset() + d;
 			}
-			std::sort(range2,range2+N2,AliGPUTPCGMBorderTrack::Range::CompMax);
 		}
+		SortBorderRanges(range1, rangeTmp, N1, false);
+		SortBorderRanges(range2, rangeTmp, N2, true);
 	}
 
 	int i2 = 0;
@@ -483,38 +662,48 @@ void AliGPUTPCGMMerger::MergeBorderTracks(int iSlice1, AliGPUTPCGMBorderTrack B1
 		int iBest2 = -1;
 		int lBest2 = 0;
 		statAll++;
+
+		//The cuts only depend on b1 and the candidate, they are evaluated without early exits so that the candidate loop has no data dependent branches
+		const bool b1Looper = fabsf(b1.Par()[4]) >= 20;
+		const float fys = b1Looper ? (2. * factor2ys) : factor2ys;
+		const float fzt = b1Looper ? (2. * factor2zt) : factor2zt;
+		const int minNPartHits2 = b1Looper ? 0 : minNPartHits;
+		const int minNTotalHits2 = b1Looper ? 0 : (minNTotalHits - b1.NClusters());
 		for(int k2 = i2;k2<N2;k2++)
 		{
 			AliGPUTPCGMBorderTrack::Range r2 = range2[k2];
 			if( r2.fMin > r1.fMax ) break;
-			if( sameSlice && (r1.fId >= r2.fId) ) continue;
-			// do check
 
 			AliGPUTPCGMBorderTrack &b2 = B2[r2.fId];
+			const bool ok = !(sameSlice && (r1.fId >= r2.fId));
+			const bool okNCl1 = b2.NClusters() >= lBest2;
+			const bool okRow = crossCE < 2 || abs(b1.Row() - b2.Row()) <= 1;
+			const bool okY = b1.CheckChi2Y(b2, factor2ys);
+			//const bool okZ = b1.CheckChi2Z(b2, factor2zt);
+			const bool okQPt = b1.CheckChi2QPt(b2, factor2k);
+			const bool okYS = b1.CheckChi2YS(b2, fys);
+			const bool okZT = b1.CheckChi2ZT(b2, fzt);
+			const bool okNCl2 = b2.NClusters() >= minNPartHits2 && b2.NClusters() >= minNTotalHits2;
+			if (DEBUG && ok)
+			{
+				printf("Comparing track %3d to %3d: ", r1.fId, r2.fId);for (int i = 0;i < 5;i++) {printf("%8.3f ", b1.Par()[i]);}printf(" - ");for (int i = 0;i < 5;i++) {printf("%8.3f ", b1.Cov()[i]);}printf("\n%28s", "");
+				for (int i = 0;i < 5;i++) {printf("%8.3f ", b2.Par()[i]);}printf(" - ");for (int i = 0;i < 5;i++) {printf("%8.3f ", b2.Cov()[i]);}printf("   -   %5s   -   ", GetTrackLabel(b1) == GetTrackLabel(b2) ? "CLONE" : "FAKE");
+				if (!okNCl1) printf("!NCl1\n");
+				else if (!okRow) printf("!ROW\n");
+				else if (!okY) printf("!Y\n");
+				else if (!okQPt) printf("!QPt\n");
+				else if (!okYS) printf("!YS\n");
+				else if (!okZT) printf("!ZT\n");
+				else if (!okNCl2) printf("!NCl2\n");
+				else printf("OK: dZ %8.3f D1 %8.3f D2 %8.3f\n", fabsf(b1.Par()[1] - b2.Par()[1]), 3.5*sqrt(b1.Cov()[1]), 3.5*sqrt(b2.Cov()[1]));
+			}
+			bool okCuts = okNCl1 & okRow & okY & okQPt & okYS & okZT & okNCl2;
 #ifdef GPUCA_MERGER_BY_MC_LABEL
-			if (GetTrackLabel(b1) != GetTrackLabel(b2)) //DEBUG CODE, match by MC label
+			okCuts |= GetTrackLabel(b1) == GetTrackLabel(b2); //DEBUG CODE, match by MC label
 #endif
-			{
-				if (DEBUG) {printf("Comparing track %3d to %3d: ", r1.fId, r2.fId);for (int i = 0;i < 5;i++) {printf("%8.3f ", b1.Par()[i]);}printf(" - ");for (int i = 0;i < 5;i++) {printf("%8.3f ", b1.Cov()[i]);}printf("\n%28s", "");
-					for (int i = 0;i < 5;i++) {printf("%8.3f ", b2.Par()[i]);}printf(" - ");for (int i = 0;i < 5;i++) {printf("%8.3f ", b2.Cov()[i]);}printf("   -   %5s   -   ", GetTrackLabel(b1) == GetTrackLabel(b2) ? "CLONE" : "FAKE");}
-				if ( b2.NClusters() < lBest2 ) {if (DEBUG) {printf("!NCl1\n");}continue;}
-				if (crossCE >= 2 && abs(b1.Row() - b2.Row()) > 1) {if (DEBUG) {printf("!ROW\n");}continue;}
-				if( !b1.CheckChi2Y(b2, factor2ys ) ) {if (DEBUG) {printf("!Y\n");}continue;}
-				//if( !b1.CheckChi2Z(b2, factor2zt ) ) {if (DEBUG) {printf("!NCl1\n");}continue;}
-				if( !b1.CheckChi2QPt(b2, factor2k ) ) {if (DEBUG) {printf("!QPt\n");}continue;}
-				float fys = fabsf(b1.Par()[4]) < 20 ? factor2ys : (2. * factor2ys);
-				float fzt = fabsf(b1.Par()[4]) < 20 ? factor2zt : (2. * factor2zt);
-				if( !b1.CheckChi2YS(b2, fys ) ) {if (DEBUG) {printf("!YS\n");}continue;}
-				if( !b1.CheckChi2ZT(b2, fzt ) ) {if (DEBUG) {printf("!ZT\n");}continue;}
-				if (fabsf(b1.Par()[4]) < 20)
-				{
-					if ( b2.NClusters() < minNPartHits ) {if (DEBUG) {printf("!NCl2\n");}continue;}
-					if ( b1.NClusters() + b2.NClusters() < minNTotalHits ) {if (DEBUG) {printf("!NCl3\n");}continue;}
-				}
-				if (DEBUG) printf("OK: dZ %8.3f D1 %8.3f D2 %8.3f\n", fabsf(b1.Par()[1] - b2.Par()[1]), 3.5*sqrt(b1.Cov()[1]), 3.5*sqrt(b2.Cov()[1]));
-			} //DEBUG CODE, match by MC label
-			lBest2 = b2.NClusters();
-			iBest2 = b2.TrackID();
+			const bool accept = ok & okCuts;
+			lBest2 = accept ? b2.NClusters() : lBest2;
+			iBest2 = accept ? b2.TrackID() : iBest2;
 		}
 
 		if (iBest2 < 0) continue;
@@ -527,54 +716,73 @@ void AliGPUTPCGMMerger::MergeBorderTracks(int iSlice1, AliGPUTPCGMBorderTrack B1
 	//printf("STAT: slices %d, %d: all %d merged %d\n", iSlice1, iSlice2, statAll, statMerged);
 }
 
-void AliGPUTPCGMMerger::MergeWithingSlices()
+void AliGPUTPCGMMerger::MergeWithinSlice(int iSlice)
 {
+	//* merge the tracks of one slice with each other, the tracks and links of the slice are not touched by other slices
 	float x0 = mCAParam->RowX[63];
 	const float maxSin = CAMath::Sin(60. / 180.*CAMath::Pi());
 
-	ClearTrackLinks(SliceTrackInfoLocalTotal());
-	for (int iSlice = 0;iSlice < fgkNSlices;iSlice++)
+	ClearTrackLinks(SliceTrackInfoFirst(iSlice), SliceTrackInfoLast(iSlice));
+	int nBord = 0;
+	for ( int itr = SliceTrackInfoFirst(iSlice); itr < SliceTrackInfoLast(iSlice); itr++ )
 	{
-		int nBord = 0;
-		for ( int itr = SliceTrackInfoFirst(iSlice); itr < SliceTrackInfoLast(iSlice); itr++ )
+		AliGPUTPCGMSliceTrack &track = fSliceTrackInfos[itr];
+		AliGPUTPCGMBorderTrack &b = fBorder[iSlice][nBord];
+		if (track.TransportToX(x0, mCAParam->ConstBz, b, maxSin))
 		{
-			AliGPUTPCGMSliceTrack &track = fSliceTrackInfos[itr];
-			AliGPUTPCGMBorderTrack &b = fBorder[iSlice][nBord];
-			if (track.TransportToX(x0, mCAParam->ConstBz, b, maxSin))
-			{
-				b.SetTrackID( itr );
-				if (DEBUG) {printf("WITHIN SLICE %d Track %d - ", iSlice, itr);for (int i = 0;i < 5;i++) {printf("%8.3f ", b.Par()[i]);} printf(" - ");for (int i = 0;i < 5;i++) {printf("%8.3f ", b.Cov()[i]);} printf("\n");}
-				b.SetNClusters( track.NClusters() );
-				nBord++;
-			}
+			b.SetTrackID( itr );
+			if (DEBUG) {printf("WITHIN SLICE %d Track %d - ", iSlice, itr);for (int i = 0;i < 5;i++) {printf("%8.3f ", b.Par()[i]);} printf(" - ");for (int i = 0;i < 5;i++) {printf("%8.3f ", b.Cov()[i]);} printf("\n");}
+			b.SetNClusters( track.NClusters() );
+			nBord++;
 		}
-
-		MergeBorderTracks( iSlice, fBorder[iSlice], nBord, iSlice, fBorder[iSlice], nBord );
 	}
 
-	ResolveMergeSlices(false, true);
+	MergeBorderTracks( iSlice, fBorder[iSlice], nBord, iSlice, fBorder[iSlice], nBord );
+	ResolveMergeSlices(false, true, SliceTrackInfoFirst(iSlice), SliceTrackInfoLast(iSlice));
+}
+
+void AliGPUTPCGMMerger::MergeWithingSlices()
+{
+	if (fIncremental) return; //Done per slice by MergeSliceIncremental
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads)
+#endif
+	for (int iSlice = 0;iSlice < fgkNSlices;iSlice++)
+	{
+		MergeWithinSlice(iSlice);
+	}
 }
 
 void AliGPUTPCGMMerger::MergeSlices()
 {
-	MergeSlicesStep(2, 3, false);
+	if (fIncremental) ResolveMergeSlices(false, false, 0, SliceTrackInfoLocalTotal()); //The slice pairs of the first step were matched by MergeSliceIncremental
+	else MergeSlicesStep(2, 3, false);
 	MergeSlicesStep(0, 1, false);
 	MergeSlicesStep(0, 1, true);
 }
 
+void AliGPUTPCGMMerger::MergeSlicePair(int iSlice, int border0, int border1, bool fromOrig)
+{
+	//Every slice is the next slice of exactly one other slice, the border tracks of that neighbour go to the second half of its border buffer
+	int jSlice = fNextSliceInd[iSlice];
+	AliGPUTPCGMBorderTrack *bCurr = fBorder[iSlice], *bNext = fBorder[jSlice] + fSliceNMaxTracks[jSlice];
+	int nCurr = 0, nNext = 0;
+	MakeBorderTracks(iSlice, border0, bCurr, nCurr, fromOrig);
+	MakeBorderTracks(jSlice, border1, bNext, nNext, fromOrig);
+	MergeBorderTracks(iSlice, bCurr, nCurr, jSlice, bNext, nNext, fromOrig ? -1 : 0);
+}
+
 void AliGPUTPCGMMerger::MergeSlicesStep(int border0, int border1, bool fromOrig)
 {
-	ClearTrackLinks(SliceTrackInfoLocalTotal());
+	ClearTrackLinks(0, SliceTrackInfoLocalTotal());
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads)
+#endif
 	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
 	{
-		int jSlice = fNextSliceInd[iSlice];
-		AliGPUTPCGMBorderTrack *bCurr = fBorder[iSlice], *bNext = fBorder[jSlice];
-		int nCurr = 0, nNext = 0;
-		MakeBorderTracks(iSlice, border0, bCurr, nCurr, fromOrig);
-		MakeBorderTracks(jSlice, border1, bNext, nNext, fromOrig);
-		MergeBorderTracks(iSlice, bCurr, nCurr, jSlice, bNext, nNext, fromOrig ? -1 : 0);
+		MergeSlicePair(iSlice, border0, border1, fromOrig);
 	}
-	ResolveMergeSlices(fromOrig, false);
+	ResolveMergeSlices(fromOrig, false, 0, SliceTrackInfoLocalTotal());
 }
 
 void AliGPUTPCGMMerger::PrintMergeGraph(AliGPUTPCGMSliceTrack* trk)
@@ -606,7 +814,7 @@ void AliGPUTPCGMMerger::PrintMergeGraph(AliGPUTPCGMSliceTrack* trk)
 	}
 }
 
-void AliGPUTPCGMMerger::ResolveMergeSlices(bool fromOrig, bool mergeAll)
+void AliGPUTPCGMMerger::ResolveMergeSlices(bool fromOrig, bool mergeAll, int firstTrack, int lastTrack)
 {
 	if (!mergeAll)
 	{
@@ -640,7 +848,7 @@ void AliGPUTPCGMMerger::ResolveMergeSlices(bool fromOrig, bool mergeAll)
 		newTrack2.SetPrevNeighbour( itr, neighborType );*/
 	}
 
-	for (int itr = 0; itr < SliceTrackInfoLocalTotal(); itr++)
+	for (int itr = firstTrack; itr < lastTrack; itr++)
 	{
 		int itr2 = fTrackLinks[itr];
 		if (itr2 < 0) continue;
@@ -695,10 +903,10 @@ void AliGPUTPCGMMerger::ResolveMergeSlices(bool fromOrig, bool mergeAll)
 				}
 			}
 
-			float z1min = track1->MinClusterZ(), z1max = track1->MaxClusterZ();
-			float z2min = track2->MinClusterZ(), z2max = track2->MaxClusterZ();
-			if (track1 != track1Base) {z1min = CAMath::Min(z1min, track1Base->MinClusterZ()); z1max = CAMath::Max(z1max, track1Base->MaxClusterZ());}
-			if (track2 != track2Base) {z2min = CAMath::Min(z2min, track2Base->MinClusterZ()); z2max = CAMath::Max(z2max, track2Base->MaxClusterZ());}
+			float z1min = SliceTrackMinClusterZ(*track1), z1max = SliceTrackMaxClusterZ(*track1);
+			float z2min = SliceTrackMinClusterZ(*track2), z2max = SliceTrackMaxClusterZ(*track2);
+			if (track1 != track1Base) {z1min = CAMath::Min(z1min, SliceTrackMinClusterZ(*track1Base)); z1max = CAMath::Max(z1max, SliceTrackMaxClusterZ(*track1Base));}
+			if (track2 != track2Base) {z2min = CAMath::Min(z2min, SliceTrackMinClusterZ(*track2Base)); z2max = CAMath::Max(z2max, SliceTrackMaxClusterZ(*track2Base));}
 
 			bool goUp = z2max - z1min > z1max - z2min;
 
@@ -785,7 +993,7 @@ void AliGPUTPCGMMerger::MergeCEFill(const AliGPUTPCGMSliceTrack *track, const Al
 	int slice = track->Slice();
 	for (int attempt = 0; attempt < 2; attempt++)
 	{
-		AliGPUTPCGMBorderTrack &b = attempt == 0 ? fBorder[slice][fBorderCETracks[0][slice]] : fBorder[slice][fkSlices[slice]->NTracks() - 1 - fBorderCETracks[1][slice]];
+		AliGPUTPCGMBorderTrack &b = attempt == 0 ? fBorder[slice][fBorderCETracks[0][slice]] : fBorder[slice][fSliceNMaxTracks[slice] - 1 - fBorderCETracks[1][slice]];
 		const float x0 = attempt == 0 ? mCAParam->RowX[63] : cls.fX;
 		if(track->TransportToX(x0, mCAParam->ConstBz, b, GPUCA_MAX_SIN_PHI_LOW))
 		{
@@ -805,15 +1013,43 @@ void AliGPUTPCGMMerger::MergeCEFill(const AliGPUTPCGMSliceTrack *track, const Al
 	}
 }
 
+void AliGPUTPCGMMerger::MergeCECopyClusters(const AliGPUTPCGMMerger_CECopy *copies, int nCopies)
+{
+	//The sources of a batch are not written by the batch, and the destinations are disjoint
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads)
+#endif
+	for (int i = 0;i < nCopies;i++)
+	{
+		const AliGPUTPCGMMerger_CECopy &copy = copies[i];
+		int out = copy.fDest;
+		for (int k = 1;k >= 0;k--)
+		{
+			if (copy.fReverse[k]) for (int j = copy.fN[k] - 1;j >= 0;j--) fClusters[out++] = fClusters[copy.fSrc[k] + j];
+			else for (int j = 0;j < copy.fN[k];j++) fClusters[out++] = fClusters[copy.fSrc[k] + j];
+		}
+	}
+}
+
 void AliGPUTPCGMMerger::MergeCE()
 {
-	ClearTrackLinks(fNOutputTracks);
+	ClearTrackLinks(0, fNOutputTracks);
+	//Every track is a CE candidate in at most one slice, so the slice pairs write disjoint links
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads)
+#endif
 	for (int iSlice = 0;iSlice < fgkNSlices / 2;iSlice++)
 	{
 		int jSlice = iSlice + fgkNSlices / 2;
 		MergeBorderTracks(iSlice, fBorder[iSlice], fBorderCETracks[0][iSlice], jSlice, fBorder[jSlice], fBorderCETracks[0][jSlice], 1);
-		MergeBorderTracks(iSlice, fBorder[iSlice] + fkSlices[iSlice]->NTracks() - fBorderCETracks[1][iSlice], fBorderCETracks[1][iSlice], jSlice, fBorder[jSlice] + fkSlices[jSlice]->NTracks() - fBorderCETracks[1][jSlice], fBorderCETracks[1][jSlice], 2);
+		MergeBorderTracks(iSlice, fBorder[iSlice] + fSliceNMaxTracks[iSlice] - fBorderCETracks[1][iSlice], fBorderCETracks[1][iSlice], jSlice, fBorder[jSlice] + fSliceNMaxTracks[jSlice] - fBorderCETracks[1][jSlice], fBorderCETracks[1][jSlice], 2);
 	}
+
+	//The links are applied in track order, the clusters of the merged tracks are only reserved here and copied in parallel batches.
+	//A batch is flushed before a track whose clusters are the result of an earlier CE merge is used, since its clusters must be in place.
+	AliGPUTPCGMMerger_CECopy *copies = (AliGPUTPCGMMerger_CECopy*) fTmpMem;
+	int nCopies = 0;
+	const int nClustersNotCE = fNOutputTrackClusters;
 	for (int i = 0;i < fNOutputTracks;i++)
 	{
 		if (fTrackLinks[i] >= 0)
@@ -822,8 +1058,15 @@ void AliGPUTPCGMMerger::MergeCE()
 			
 			if (!trk[1]->OK() || trk[1]->CCE()) continue;
 
+			if ((int) trk[0]->FirstClusterRef() >= nClustersNotCE || (int) trk[1]->FirstClusterRef() >= nClustersNotCE)
+			{
+				MergeCECopyClusters(copies, nCopies);
+				nCopies = 0;
+			}
+
 			if (fNOutputTrackClusters + trk[0]->NClusters() + trk[1]->NClusters() >= fNMaxOutputTrackClusters)
 			{
+				MergeCECopyClusters(copies, nCopies);
 				printf("Insufficient cluster memory for merging CE tracks (OutputClusters %d, total clusters %d)\n", fNOutputTrackClusters, fNMaxOutputTrackClusters);
 				return;
 			}
@@ -864,11 +1107,15 @@ void AliGPUTPCGMMerger::MergeCE()
 			}
 
 			int newRef = fNOutputTrackClusters;
-			for (int k = 1;k >= 0;k--)
+			AliGPUTPCGMMerger_CECopy &copy = copies[nCopies++];
+			for (int k = 0;k < 2;k++)
 			{
-				if (reverse[k]) for (int j = trk[k]->NClusters() - 1;j >= 0;j--) fClusters[fNOutputTrackClusters++] = fClusters[trk[k]->FirstClusterRef() + j];
-				else for (unsigned int j = 0;j < trk[k]->NClusters();j++) fClusters[fNOutputTrackClusters++] = fClusters[trk[k]->FirstClusterRef() + j];
+				copy.fSrc[k] = trk[k]->FirstClusterRef();
+				copy.fN[k] = trk[k]->NClusters();
+				copy.fReverse[k] = reverse[k];
 			}
+			copy.fDest = newRef;
+			fNOutputTrackClusters += trk[0]->NClusters() + trk[1]->NClusters();
 			trk[1]->SetFirstClusterRef(newRef);
 			trk[1]->SetNClusters(trk[0]->NClusters() + trk[1]->NClusters());
 			trk[1]->SetCCE(true);
@@ -876,6 +1123,7 @@ void AliGPUTPCGMMerger::MergeCE()
 			trk[0]->SetOK(false);
 		}
 	}
+	MergeCECopyClusters(copies, nCopies);
 
 	//for (int i = 0;i < fNOutputTracks;i++) {if (fOutputTracks[i].CCE() == false) {fOutputTracks[i].SetNClusters(0);fOutputTracks[i].SetOK(false);}} //Remove all non-CE tracks
 }
@@ -913,61 +1161,88 @@ struct AliGPUTPCGMMerger_CompareClusterIds
 	}
 };
 
-struct AliGPUTPCGMMerger_CompareTracks
+//Maps a float to an unsigned int with the same ordering
+static inline unsigned int AliGPUTPCGMMerger_FloatKey(float v)
 {
-	const AliGPUTPCGMMergedTrack* const fCmp;
-	AliGPUTPCGMMerger_CompareTracks(AliGPUTPCGMMergedTrack* cmp) : fCmp(cmp) {}
-	bool operator()(const int aa, const int bb)
-	{
-		const AliGPUTPCGMMergedTrack& a = fCmp[aa];
-		const AliGPUTPCGMMergedTrack& b = fCmp[bb];
-		return(fabsf(a.GetParam().GetQPt()) > fabsf(b.GetParam().GetQPt()));
-	}
-};
-
-bool AliGPUTPCGMMerger_CompareParts(const AliGPUTPCGMSliceTrack* a, const AliGPUTPCGMSliceTrack* b)
-{
-  return(a->X() > b->X());
+	unsigned int u;
+	memcpy(&u, &v, sizeof(u));
+	return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
 }
 
-void AliGPUTPCGMMerger::CollectMergedTracks()
+//Stable LSD radix sort of values by keys, 8 bits per pass, passes where all keys share the digit are skipped.
+//Every thread histograms and scatters a contiguous block, so the result does not depend on the number of threads.
+static void AliGPUTPCGMMerger_RadixSort(unsigned int *keys, unsigned int *values, unsigned int *tmpKeys, unsigned int *tmpValues, int n, int nThreads)
 {
-	//Resolve connections for global tracks first
-	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
+	static constexpr int kMaxBlocks = 64;
+	static constexpr int kMinBlockSize = 4096;
+	int nBlocks = CAMath::Min(CAMath::Min(nThreads, kMaxBlocks), (n + kMinBlockSize - 1) / kMinBlockSize);
+	if (nBlocks < 1) nBlocks = 1;
+	const int blockSize = (n + nBlocks - 1) / nBlocks;
+	unsigned int count[kMaxBlocks][256];
+	unsigned int *inKeys = keys, *inValues = values, *outKeys = tmpKeys, *outValues = tmpValues;
+	for (int shift = 0;shift < 32;shift += 8)
 	{
-		for (int itr = SliceTrackInfoGlobalFirst(iSlice); itr < SliceTrackInfoGlobalLast(iSlice); itr++)
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(nBlocks)
+#endif
+		for (int iBlock = 0;iBlock < nBlocks;iBlock++)
 		{
-			AliGPUTPCGMSliceTrack &globalTrack = fSliceTrackInfos[itr];
-			AliGPUTPCGMSliceTrack &localTrack = fSliceTrackInfos[globalTrack.LocalTrackId()];
-			localTrack.SetGlobalTrackId(localTrack.GlobalTrackId(0) != -1, itr);
+			memset(count[iBlock], 0, sizeof(count[iBlock]));
+			const int end = CAMath::Min(n, (iBlock + 1) * blockSize);
+			for (int i = iBlock * blockSize;i < end;i++) count[iBlock][(inKeys[i] >> shift) & 0xFF]++;
+		}
+		unsigned int offset = 0;
+		bool skip = false;
+		for (int digit = 0;digit < 256;digit++)
+		{
+			const unsigned int start = offset;
+			for (int iBlock = 0;iBlock < nBlocks;iBlock++)
+			{
+				const unsigned int tmp = count[iBlock][digit];
+				count[iBlock][digit] = offset;
+				offset += tmp;
+			}
+			if (offset - start == (unsigned int) n) skip = true;
 		}
+		if (skip) continue;
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(nBlocks)
+#endif
+		for (int iBlock = 0;iBlock < nBlocks;iBlock++)
+		{
+			const int end = CAMath::Min(n, (iBlock + 1) * blockSize);
+			for (int i = iBlock * blockSize;i < end;i++)
+			{
+				const unsigned int pos = count[iBlock][(inKeys[i] >> shift) & 0xFF]++;
+				outKeys[pos] = inKeys[i];
+				outValues[pos] = inValues[i];
+			}
+		}
+		std::swap(inKeys, outKeys);
+		std::swap(inValues, outValues);
 	}
+	if (inValues != values) memcpy(values, inValues, n * sizeof(*values));
+}
 
-	//CheckMergedTracks();
-
-	//Now collect the merged tracks
-	fNOutputTracks = 0;
-	int nOutTrackClusters = 0;
-
-	AliGPUTPCGMSliceTrack *trackParts[kMaxParts];
+bool AliGPUTPCGMMerger_CompareParts(const AliGPUTPCGMSliceTrack* a, const AliGPUTPCGMSliceTrack* b)
+{
+  return(a->X() > b->X());
+}
 
-	for (int itr = 0; itr < SliceTrackInfoLocalTotal(); itr++)
+int AliGPUTPCGMMerger::CollectTrackParts(int itr, AliGPUTPCGMSliceTrack **trackParts, int &leg)
+{
+	//Walk the merge graph starting from slice track itr, the parts are chained in fTrackLinks in the order they are found, so that the fill phase can read them back without walking again
+	AliGPUTPCGMSliceTrack &track = fSliceTrackInfos[itr];
+	int nParts = 0;
+	int nHits = 0;
+	leg = 0;
+	AliGPUTPCGMSliceTrack *trbase = &track, *tr = &track;
+	tr->SetPrevSegmentNeighbour(1000000000);
+	while (true)
 	{
-
-		AliGPUTPCGMSliceTrack &track = fSliceTrackInfos[itr];
-
-		if (track.PrevSegmentNeighbour() >= 0) continue;
-		if (track.PrevNeighbour() >= 0) continue;
-		int nParts = 0;
-		int nHits = 0;
-		int leg = 0;
-		AliGPUTPCGMSliceTrack *trbase = &track, *tr = &track;
-		tr->SetPrevSegmentNeighbour(1000000000);
-		while (true)
-		{
-			if (nParts >= kMaxParts) break;
-			if (nHits + tr->NClusters() > kMaxClusters) break;
-			nHits += tr->NClusters();
+		if (nParts >= kMaxParts) break;
+		if (nHits + tr->NClusters() > kMaxClusters) break;
+		nHits += tr->NClusters();
 
 		tr->SetLeg(leg);
 		trackParts[nParts++] = tr;
@@ -1000,135 +1275,214 @@ void AliGPUTPCGMMerger::CollectMergedTracks()
 			continue;
 		}
 		break;
-		}
+	}
+	for (int i = 0;i < nParts;i++) fTrackLinks[trackParts[i] - fSliceTrackInfos] = i + 1 < nParts ? (trackParts[i + 1] - fSliceTrackInfos) : -1;
+	return nParts;
+}
 
-		// unpack and sort clusters
-		if (nParts > 1 && leg == 0)
+int AliGPUTPCGMMerger::CollectTrackClusters(AliGPUTPCGMSliceTrack **trackParts, int nParts, int leg, float qpt, AliGPUTPCSliceOutCluster *trackClusters, uchar2 *clA, int &firstTrackIndex, int &lastTrackIndex)
+{
+	//Unpack, sort and deduplicate the clusters of the parts, returns the number of clusters, or -1 if the track has too few clusters
+	if (nParts > 1 && leg == 0)
+	{
+		std::sort(trackParts, trackParts + nParts, AliGPUTPCGMMerger_CompareParts);
+	}
+
+	int nHits = 0;
+	for( int ipart=0; ipart<nParts; ipart++ )
+	{
+		const AliGPUTPCGMSliceTrack *t = trackParts[ipart];
+		if (DEBUG) printf("Collect Track Part %d QPt %f DzDs %f\n", ipart, t->QPt(), t->DzDs());
+		int nTrackHits = t->NClusters();
+		AliGPUTPCSliceOutCluster *c2 = trackClusters + nHits + nTrackHits-1;
+		for( int i=0; i<nTrackHits; i++, c2-- )
 		{
-			std::sort(trackParts, trackParts + nParts, AliGPUTPCGMMerger_CompareParts);
+		  *c2 = SliceTrackCluster(*t, i);
+		  clA[nHits].x = t->Slice();
+		  clA[nHits++].y = t->Leg();
 		}
+	}
+	if ( nHits < TRACKLET_SELECTOR_MIN_HITS(qpt) ) return -1;
 
-		AliGPUTPCSliceOutCluster trackClusters[kMaxClusters];
-		uchar2 clA[kMaxClusters];
-		nHits = 0;
-		for( int ipart=0; ipart<nParts; ipart++ )
+	int ordered = leg == 0;
+	if (ordered)
+	{
+		for( int i=1; i<nHits; i++ )
 		{
-			const AliGPUTPCGMSliceTrack *t = trackParts[ipart];
-			if (DEBUG) printf("Collect Track %d Part %d QPt %f DzDs %f\n", fNOutputTracks, ipart, t->QPt(), t->DzDs());
-			int nTrackHits = t->NClusters();
-			const AliGPUTPCSliceOutCluster *c= t->OrigTrack()->Clusters();
-			AliGPUTPCSliceOutCluster *c2 = trackClusters + nHits + nTrackHits-1;
-			for( int i=0; i<nTrackHits; i++, c++, c2-- )
+			if ( trackClusters[i].GetX() > trackClusters[i-1].GetX() || trackClusters[i].GetId() == trackClusters[i - 1].GetId())
 			{
-			  *c2 = *c;
-			  clA[nHits].x = t->Slice();
-			  clA[nHits++].y = t->Leg();
+				ordered = 0;
+				break;
 			}
 		}
-		if ( nHits < TRACKLET_SELECTOR_MIN_HITS(track.QPt()) ) continue;
+	}
+	firstTrackIndex = 0;
+	lastTrackIndex = nParts - 1;
+	if (ordered == 0)
+	{
+		int nTmpHits = 0;
+		AliGPUTPCSliceOutCluster trackClustersUnsorted[kMaxClusters];
+		uchar2 clAUnsorted[kMaxClusters];
+		int clusterIndices[kMaxClusters];
+		for (int i = 0;i < nHits;i++)
+		{
+			trackClustersUnsorted[i] = trackClusters[i];
+			clAUnsorted[i] = clA[i];
+			clusterIndices[i] = i;
+		}
 
-		int ordered = leg == 0;
-		if (ordered)
+		if (leg > 0)
 		{
-			for( int i=1; i<nHits; i++ )
+			//Find QPt and DzDs for the segment closest to the vertex, if low/mid Pt
+			float baseZ = 1e9;
+			unsigned char baseLeg = 0;
+			const float factor = trackParts[0]->CSide() ? -1.f : 1.f;
+			for (int i = 0;i < nParts;i++)
 			{
-				if ( trackClusters[i].GetX() > trackClusters[i-1].GetX() || trackClusters[i].GetId() == trackClusters[i - 1].GetId())
+			  if(trackParts[i]->Leg() == 0 || trackParts[i]->Leg() == leg)
+			  {
+				float z = CAMath::Min(SliceTrackCluster(*trackParts[i], 0).GetZ() * factor, SliceTrackCluster(*trackParts[i], trackParts[i]->NClusters() - 1).GetZ() * factor);
+				if (z < baseZ)
 				{
-					ordered = 0;
-					break;
+					baseZ = z;
+					baseLeg = trackParts[i]->Leg();
 				}
+			  }
 			}
-		}
-		int firstTrackIndex = 0;
-		int lastTrackIndex = nParts - 1;
-		if (ordered == 0)
-		{
-			int nTmpHits = 0;
-			AliGPUTPCSliceOutCluster trackClustersUnsorted[kMaxClusters];
-			uchar2 clAUnsorted[kMaxClusters];
-			int clusterIndices[kMaxClusters];
-			for (int i = 0;i < nHits;i++)
+			int iLongest = 1e9;
+			int length = 0;
+			for (int i = (baseLeg ? (nParts - 1) : 0);baseLeg ? (i >= 0) : (i < nParts);baseLeg ? i-- : i++)
 			{
-				trackClustersUnsorted[i] = trackClusters[i];
-				clAUnsorted[i] = clA[i];
-				clusterIndices[i] = i;
+				if (trackParts[i]->Leg() != baseLeg) break;
+				if (trackParts[i]->OrigTrack()->NClusters() > length)
+				{
+					iLongest = i;
+					length = trackParts[i]->OrigTrack()->NClusters();
+				}
 			}
+			bool outwards = (SliceTrackCluster(*trackParts[iLongest], 0).GetZ() > SliceTrackCluster(*trackParts[iLongest], trackParts[iLongest]->NClusters() - 1).GetZ()) ^ trackParts[iLongest]->CSide();
 
-			if (leg > 0)
+			AliGPUTPCGMMerger_CompareClusterIdsLooper::clcomparestruct clusterSort[kMaxClusters];
+			for (int iPart = 0;iPart < nParts;iPart++)
 			{
-				//Find QPt and DzDs for the segment closest to the vertex, if low/mid Pt
-				float baseZ = 1e9;
-				unsigned char baseLeg = 0;
-				const float factor = trackParts[0]->CSide() ? -1.f : 1.f;
-				for (int i = 0;i < nParts;i++)
+				const AliGPUTPCGMSliceTrack *t = trackParts[iPart];
+				int nTrackHits = t->NClusters();
+				for (int j = 0;j < nTrackHits;j++)
 				{
-				  if(trackParts[i]->Leg() == 0 || trackParts[i]->Leg() == leg)
-				  {
-					float z = CAMath::Min(trackParts[i]->OrigTrack()->Clusters()[0].GetZ() * factor, trackParts[i]->OrigTrack()->Clusters()[trackParts[i]->OrigTrack()->NClusters() - 1].GetZ() * factor);
-					if (z < baseZ)
-					{
-						baseZ = z;
-						baseLeg = trackParts[i]->Leg();
-					}
-				  }
+					int i = nTmpHits + j;
+					clusterSort[i].leg = t->Leg();
 				}
-				int iLongest = 1e9;
-				int length = 0;
-				for (int i = (baseLeg ? (nParts - 1) : 0);baseLeg ? (i >= 0) : (i < nParts);baseLeg ? i-- : i++)
-				{
-					if (trackParts[i]->Leg() != baseLeg) break;
-					if (trackParts[i]->OrigTrack()->NClusters() > length)
-					{
-						iLongest = i;
-						length = trackParts[i]->OrigTrack()->NClusters();
-					}
-				}
-				bool outwards = (trackParts[iLongest]->OrigTrack()->Clusters()[0].GetZ() > trackParts[iLongest]->OrigTrack()->Clusters()[trackParts[iLongest]->OrigTrack()->NClusters() - 1].GetZ()) ^ trackParts[iLongest]->CSide();
+				nTmpHits += nTrackHits;
+			}
 
-				AliGPUTPCGMMerger_CompareClusterIdsLooper::clcomparestruct clusterSort[kMaxClusters];
-				for (int iPart = 0;iPart < nParts;iPart++)
-				{
-					const AliGPUTPCGMSliceTrack *t = trackParts[iPart];
-					int nTrackHits = t->NClusters();
-					for (int j = 0;j < nTrackHits;j++)
-					{
-						int i = nTmpHits + j;
-						clusterSort[i].leg = t->Leg();
-					}
-					nTmpHits += nTrackHits;
-				}
+		std::sort(clusterIndices, clusterIndices + nHits, AliGPUTPCGMMerger_CompareClusterIdsLooper(baseLeg, outwards, trackClusters, clusterSort));
+		}
+		else
+		{
+			std::sort(clusterIndices, clusterIndices + nHits, AliGPUTPCGMMerger_CompareClusterIds(trackClusters));
+		}
+		nTmpHits = 0;
+		firstTrackIndex = lastTrackIndex = -1;
+		for (int i = 0;i < nParts;i++)
+		{
+			nTmpHits += trackParts[i]->NClusters();
+			if (nTmpHits > clusterIndices[0] && firstTrackIndex == -1) firstTrackIndex = i;
+			if (nTmpHits > clusterIndices[nHits - 1] && lastTrackIndex == -1) lastTrackIndex = i;
+		}
 
-			std::sort(clusterIndices, clusterIndices + nHits, AliGPUTPCGMMerger_CompareClusterIdsLooper(baseLeg, outwards, trackClusters, clusterSort));
-			}
-			else
-			{
-				std::sort(clusterIndices, clusterIndices + nHits, AliGPUTPCGMMerger_CompareClusterIds(trackClusters));
-			}
-			nTmpHits = 0;
-			firstTrackIndex = lastTrackIndex = -1;
-			for (int i = 0;i < nParts;i++)
-			{
-				nTmpHits += trackParts[i]->NClusters();
-				if (nTmpHits > clusterIndices[0] && firstTrackIndex == -1) firstTrackIndex = i;
-				if (nTmpHits > clusterIndices[nHits - 1] && lastTrackIndex == -1) lastTrackIndex = i;
-			}
+		int nFilteredHits = 0;
+		int indPrev = -1;
+		for (int i = 0;i < nHits;i++)
+		{
+			int ind = clusterIndices[i];
+			if(indPrev >= 0 && trackClustersUnsorted[ind].GetId() == trackClustersUnsorted[indPrev].GetId()) continue;
+			indPrev = ind;
+			trackClusters[nFilteredHits] = trackClustersUnsorted[ind];
+			clA[nFilteredHits] = clAUnsorted[ind];
+			nFilteredHits++;
+		}
+		nHits = nFilteredHits;
+	}
+	return nHits;
+}
 
-			int nFilteredHits = 0;
-			int indPrev = -1;
-			for (int i = 0;i < nHits;i++)
-			{
-				int ind = clusterIndices[i];
-				if(indPrev >= 0 && trackClustersUnsorted[ind].GetId() == trackClustersUnsorted[indPrev].GetId()) continue;
-				indPrev = ind;
-				trackClusters[nFilteredHits] = trackClustersUnsorted[ind];
-				clA[nFilteredHits] = clAUnsorted[ind];
-				nFilteredHits++;
-			}
-			nHits = nFilteredHits;
+void AliGPUTPCGMMerger::CollectMergedTracks()
+{
+	//Resolve connections for global tracks first
+	for (int iSlice = 0; iSlice < fgkNSlices; iSlice++)
+	{
+		for (int itr = SliceTrackInfoGlobalFirst(iSlice); itr < SliceTrackInfoGlobalLast(iSlice); itr++)
+		{
+			AliGPUTPCGMSliceTrack &globalTrack = fSliceTrackInfos[itr];
+			AliGPUTPCGMSliceTrack &localTrack = fSliceTrackInfos[globalTrack.LocalTrackId()];
+			localTrack.SetGlobalTrackId(localTrack.GlobalTrackId(0) != -1, itr);
 		}
+	}
+
+	//CheckMergedTracks();
+
+	//Now collect the merged tracks in parallel phases, which give the same output as collecting them one after another:
+	//walk the chains of parts and count their clusters, unpack and sort the clusters of each chain once into a slot sized for all clusters of its parts,
+	//compact the slots in output order, and fill the tracks in parallel.
+	//The parts of a chain are kept in fTrackLinks, fTmpMem holds the per-chain cluster counts, offsets, legs, and the parts needed for the track parameters and the CE merging.
+	const int nLocalTracks = SliceTrackInfoLocalTotal();
+	int *chainClusters = (int*) fTmpMem;
+	int *chainTrack = chainClusters + nLocalTracks;
+	int *chainLeg = chainTrack + nLocalTracks;
+	int *chainFirstPart = chainLeg + nLocalTracks;
+	int *chainCEPart = chainFirstPart + nLocalTracks;
+
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads)
+#endif
+	for (int itr = 0; itr < nLocalTracks; itr++)
+	{
+		//Chains start at tracks without predecessor, decided before any chain is walked and marked
+		const AliGPUTPCGMSliceTrack &track = fSliceTrackInfos[itr];
+		chainClusters[itr] = (track.PrevSegmentNeighbour() >= 0 || track.PrevNeighbour() >= 0) ? -2 : -1;
+	}
 
-		AliGPUTPCGMMergedTrackHit *cl = fClusters + nOutTrackClusters;
-		int* clid = fGlobalClusterIDs + nOutTrackClusters;
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads) schedule(dynamic, 64)
+#endif
+	for (int itr = 0; itr < nLocalTracks; itr++)
+	{
+		if (chainClusters[itr] == -2) continue;
+		AliGPUTPCGMSliceTrack *trackParts[kMaxParts];
+		const int nParts = CollectTrackParts(itr, trackParts, chainLeg[itr]);
+		int nMaxHits = 0;
+		for (int i = 0;i < nParts;i++) nMaxHits += trackParts[i]->NClusters();
+		chainClusters[itr] = nMaxHits;
+	}
+
+	//Every slice track is part of at most one chain, so the slots fit in the output cluster buffer
+	int nMaxTrackClusters = 0;
+	for (int itr = 0; itr < nLocalTracks; itr++)
+	{
+		if (chainClusters[itr] < 0) continue;
+		chainTrack[itr] = nMaxTrackClusters;
+		nMaxTrackClusters += chainClusters[itr];
+	}
+	if ((unsigned int) nMaxTrackClusters > fNMaxOutputTrackClusters) throw std::runtime_error("fNMaxOutputTrackClusters too small");
+
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads) schedule(dynamic, 64)
+#endif
+	for (int itr = 0; itr < nLocalTracks; itr++)
+	{
+		if (chainClusters[itr] < 0) continue;
+		AliGPUTPCGMSliceTrack *trackParts[kMaxParts];
+		AliGPUTPCSliceOutCluster trackClusters[kMaxClusters];
+		uchar2 clA[kMaxClusters];
+		int nParts = 0;
+		for (int jtr = itr;jtr >= 0;jtr = fTrackLinks[jtr]) trackParts[nParts++] = &fSliceTrackInfos[jtr];
+		int firstTrackIndex, lastTrackIndex;
+		const int nHits = CollectTrackClusters(trackParts, nParts, chainLeg[itr], fSliceTrackInfos[itr].QPt(), trackClusters, clA, firstTrackIndex, lastTrackIndex);
+		chainClusters[itr] = nHits;
+		if (nHits < 0) continue;
+
+		AliGPUTPCGMMergedTrackHit *cl = fClusters + chainTrack[itr];
+		int* clid = fGlobalClusterIDs + chainTrack[itr];
 		for( int i=0; i<nHits; i++ )
 		{
 			cl[i].fX = trackClusters[i].GetX();
@@ -1139,9 +1493,8 @@ void AliGPUTPCGMMerger::CollectMergedTracks()
 			{
 				cl[i].fNum = trackClusters[i].GetId();
 			}
-			else //Produce consecutive numbers for shared cluster flagging
+			else //Consecutive numbers for shared cluster flagging are set once the final position is known
 			{
-				cl[i].fNum = nOutTrackClusters + i;
 				clid[i] = trackClusters[i].GetId();
 			}
 			cl[i].fAmp = trackClusters[i].GetAmp();
@@ -1154,14 +1507,57 @@ void AliGPUTPCGMMerger::CollectMergedTracks()
 #endif
 		}
 
+		const bool CEside = (trackParts[firstTrackIndex]->CSide() != 0) ^ (cl[0].fZ > cl[nHits - 1].fZ);
+		chainFirstPart[itr] = trackParts[firstTrackIndex] - fSliceTrackInfos;
+		chainCEPart[itr] = trackParts[CEside ? lastTrackIndex : firstTrackIndex] - fSliceTrackInfos;
+	}
+
+	//Compact the slots in output order, a slot never moves up, so moving them one after another does not overwrite unmoved slots
+	int nOutTrackClusters = 0;
+	fNOutputTracks = 0;
+	for (int itr = 0; itr < nLocalTracks; itr++)
+	{
+		const int nHits = chainClusters[itr];
+		if (nHits < 0)
+		{
+			chainTrack[itr] = -1;
+			continue;
+		}
+		if (chainTrack[itr] != nOutTrackClusters)
+		{
+			memmove(fClusters + nOutTrackClusters, fClusters + chainTrack[itr], nHits * sizeof(*fClusters));
+			if (mCAParam->rec.NonConsecutiveIDs) memmove(fGlobalClusterIDs + nOutTrackClusters, fGlobalClusterIDs + chainTrack[itr], nHits * sizeof(*fGlobalClusterIDs));
+		}
 		AliGPUTPCGMMergedTrack &mergedTrack = fOutputTracks[fNOutputTracks];
+		mergedTrack.SetNClusters(nHits);
+		mergedTrack.SetFirstClusterRef(nOutTrackClusters);
+		chainTrack[itr] = fNOutputTracks++;
+		nOutTrackClusters += nHits;
+	}
+	fNOutputTrackClusters = nOutTrackClusters;
+
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(mRec->GetDeviceProcessingSettings().nThreads) schedule(dynamic, 64)
+#endif
+	for (int itr = 0; itr < nLocalTracks; itr++)
+	{
+		const int iOutTrack = chainTrack[itr];
+		if (iOutTrack < 0) continue;
+
+		AliGPUTPCGMMergedTrack &mergedTrack = fOutputTracks[iOutTrack];
+		const int clusterOffset = mergedTrack.FirstClusterRef();
+		const int nHits = mergedTrack.NClusters();
+		AliGPUTPCGMMergedTrackHit *cl = fClusters + clusterOffset;
+		if (mCAParam->rec.NonConsecutiveIDs)
+		{
+			for (int i = 0;i < nHits;i++) cl[i].fNum = clusterOffset + i;
+		}
+
 		mergedTrack.SetFlags(0);
 		mergedTrack.SetOK(1);
-		mergedTrack.SetLooper(leg > 0);
-		mergedTrack.SetNClusters( nHits );
-		mergedTrack.SetFirstClusterRef( nOutTrackClusters );
+		mergedTrack.SetLooper(chainLeg[itr] > 0);
 		AliGPUTPCGMTrackParam &p1 = mergedTrack.Param();
-		const AliGPUTPCGMSliceTrack &p2 = *trackParts[firstTrackIndex];
+		const AliGPUTPCGMSliceTrack &p2 = fSliceTrackInfos[chainFirstPart[itr]];
 		mergedTrack.SetCSide(p2.CSide());
 
 		AliGPUTPCGMBorderTrack b;
@@ -1184,20 +1580,26 @@ void AliGPUTPCGMMerger::CollectMergedTracks()
 		p1.QPt()  = p2.QPt();
 		mergedTrack.SetAlpha( p2.Alpha() );
 
-		//if (nParts > 1) printf("Merged %d: QPt %f %d parts %d hits\n", fNOutputTracks, p1.QPt(), nParts, nHits);
+		//if (nParts > 1) printf("Merged %d: QPt %f %d parts %d hits\n", iOutTrack, p1.QPt(), nParts, nHits);
 
-		/*if (AliGPUQA::QAAvailable() && mRec->GetQA() && mRec->GetQA()->SuppressTrack(fNOutputTracks))
+		/*if (AliGPUQA::QAAvailable() && mRec->GetQA() && mRec->GetQA()->SuppressTrack(iOutTrack))
 		{
 			mergedTrack.SetOK(0);
 			mergedTrack.SetNClusters(0);
 		}*/
+	}
 
+	//Filling the CE border tracks appends to per-slice lists, so it stays in output order
+	for (int itr = 0; itr < nLocalTracks; itr++)
+	{
+		const int i = chainTrack[itr];
+		if (i < 0) continue;
+		const AliGPUTPCGMMergedTrack &mergedTrack = fOutputTracks[i];
+		const AliGPUTPCGMMergedTrackHit *cl = fClusters + mergedTrack.FirstClusterRef();
+		const int nHits = mergedTrack.NClusters();
 		bool CEside = (mergedTrack.CSide() != 0) ^ (cl[0].fZ > cl[nHits - 1].fZ);
-		if (mergedTrack.NClusters() && mergedTrack.OK()) MergeCEFill(trackParts[CEside ? lastTrackIndex : firstTrackIndex], cl[CEside ? (nHits - 1) : 0], fNOutputTracks);
-		fNOutputTracks++;
-		nOutTrackClusters += nHits;
+		if (mergedTrack.NClusters() && mergedTrack.OK()) MergeCEFill(&fSliceTrackInfos[chainCEPart[itr]], cl[CEside ? (nHits - 1) : 0], i);
 	}
-	fNOutputTrackClusters = nOutTrackClusters;
 }
 
 void AliGPUTPCGMMerger::PrepareClustersForFit()
@@ -1217,24 +1619,66 @@ void AliGPUTPCGMMerger::PrepareClustersForFit()
 	if (maxId > fNMaxClusters) throw std::runtime_error("fNMaxClusters too small");
 	fMaxID = maxId;
 
+	const int nThreads = mRec->GetDeviceProcessingSettings().nThreads;
 	unsigned int* trackSort = (unsigned int*) fTmpMem;
-	unsigned char* sharedCount = (unsigned char*) (trackSort + fNOutputTracks);
+	unsigned int* sortKeys = trackSort + fNOutputTracks;
+	unsigned int* sortTmp = sortKeys + fNOutputTracks;
+
+	if (fTrackOrderProcess)
+	{
+		//Neighbouring fit threads get tracks with a similar number of clusters, so the threads of a GPU warp run the fit in lock-step, and on the CPU the long tracks are scheduled first
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(nThreads)
+#endif
+		for (int i = 0;i < fNOutputTracks;i++)
+		{
+			fTrackOrderProcess[i] = i;
+			sortKeys[i] = ~(unsigned int) fOutputTracks[i].NClusters();
+		}
+		AliGPUTPCGMMerger_RadixSort(sortKeys, fTrackOrderProcess, sortTmp, sortTmp + fNOutputTracks, fNOutputTracks, nThreads);
+	}
 
 	if (!mCAParam->rec.NonConsecutiveIDs)
 	{
-		for (int i = 0;i < fNOutputTracks;i++) trackSort[i] = i;
-		std::sort(trackSort, trackSort + fNOutputTracks, AliGPUTPCGMMerger_CompareTracks(fOutputTracks));
-		memset(fClusterAttachment, 0, maxId * sizeof(fClusterAttachment[0]));
-		for (int i = 0;i < fNOutputTracks;i++) fTrackOrder[trackSort[i]] = i;
-		for (int i = 0;i < fNOutputTrackClusters;i++) fClusterAttachment[fClusters[i].fNum] = attachAttached | attachGood;
-		for (unsigned int k = 0;k < maxId;k++) sharedCount[k] = 0;
-		for (int k = 0;k < fNOutputTrackClusters;k++)
+		//Order by decreasing |q/pt|, ties by track index
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(nThreads)
+#endif
+		for (int i = 0;i < fNOutputTracks;i++)
 		{
-			sharedCount[fClusters[k].fNum] = (sharedCount[fClusters[k].fNum] << 1) | 1;
+			trackSort[i] = i;
+			sortKeys[i] = ~AliGPUTPCGMMerger_FloatKey(fabsf(fOutputTracks[i].GetParam().GetQPt()));
 		}
-		for (int k = 0;k < fNOutputTrackClusters;k++)
+		AliGPUTPCGMMerger_RadixSort(sortKeys, trackSort, sortTmp, sortTmp + fNOutputTracks, fNOutputTracks, nThreads);
+
+		//fClusterAttachment counts the tracks of each cluster first, shared clusters are flagged, then it is set to the attachment state
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel num_threads(nThreads)
+#endif
 		{
-			if (sharedCount[fClusters[k].fNum] > 1) fClusters[k].fState |= AliGPUTPCGMMergedTrackHit::flagShared;
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp for
+#endif
+			for (int i = 0;i < fNOutputTracks;i++) fTrackOrder[trackSort[i]] = i;
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp for
+#endif
+			for (unsigned int k = 0;k < maxId;k++) fClusterAttachment[k] = 0;
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp for
+#endif
+			for (int k = 0;k < fNOutputTrackClusters;k++) CAMath::AtomicAdd(&fClusterAttachment[fClusters[k].fNum], 1);
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp for
+#endif
+			for (int k = 0;k < fNOutputTrackClusters;k++)
+			{
+				if (fClusterAttachment[fClusters[k].fNum] > 1) fClusters[k].fState |= AliGPUTPCGMMergedTrackHit::flagShared;
+			}
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp for
+#endif
+			for (unsigned int k = 0;k < maxId;k++) fClusterAttachment[k] = fClusterAttachment[k] ? (attachAttached | attachGood) : 0;
 		}
 	}
 }
@@ -24,11 +24,15 @@
 #endif //GPUCA_GPUCODE
 
 class AliGPUTPCSliceTrack;
+class AliGPUTPCSliceOutTrack;
 class AliGPUTPCSliceOutput;
+class AliGPUTPCSliceOutCluster;
+struct AliGPUTPCGMMerger_CECopy;
 class AliGPUTPCGMCluster;
 class AliGPUTPCGMTrackParam;
 class AliGPUTPCTracker;
 class AliGPUChainTracking;
+class AliGPUTPCGMMaterialLUT;
 
 /**
  * @class AliGPUTPCGMMerger
@@ -52,6 +56,8 @@ public:
 
 	void SetSliceData(int index, const AliGPUTPCSliceOutput *SliceData);
 	int CheckSlices();
+	void SetIncremental(bool incremental);
+	bool Incremental() const { return fIncremental; }
 
 	GPUhd() int NOutputTracks() const { return fNOutputTracks; }
 	GPUhd() const AliGPUTPCGMMergedTrack *OutputTracks() const { return fOutputTracks; }
@@ -62,21 +68,28 @@ public:
 	GPUd() const AliGPUTPCGMPolynomialField &Field() const { return fField; }
 	GPUhd() const AliGPUTPCGMPolynomialField *pField() const { return &fField; }
 	void SetField(AliGPUTPCGMPolynomialField *field) { fField = *field; }
+	GPUhd() const AliGPUTPCGMMaterialLUT *MaterialLUT() const { return fMaterialLUT; }
+	void SetMaterialLUT(const AliGPUTPCGMMaterialLUT *lut) { fMaterialLUT = lut; }
 
 	GPUhd() int NClusters() const { return (fNClusters); }
 	GPUhd() int NOutputTrackClusters() const { return (fNOutputTrackClusters); }
 	GPUhd() const AliGPUTPCGMMergedTrackHit *Clusters() const { return (fClusters); }
 	GPUhd() AliGPUTPCGMMergedTrackHit *Clusters() { return (fClusters); }
+	GPUhd() const int *GlobalClusterIDs() const { return (fGlobalClusterIDs); }
 	GPUhd() const AliGPUTPCTracker *SliceTrackers() const { return (fSliceTrackers); }
 	GPUhd() GPUAtomic(int) *ClusterAttachment() const { return (fClusterAttachment); }
 	GPUhd() int MaxId() const { return (fMaxID); }
 	GPUhd() unsigned int *TrackOrder() const { return (fTrackOrder); }
+	GPUhd() unsigned int *TrackOrderProcess() const { return (fTrackOrderProcess); }
+	GPUhd() float *TrackFitTimes() const { return (fTrackFitTimes); }
+	void SetTrackFitTimes(float *v) { fTrackFitTimes = v; }
 
 	enum attachTypes {attachAttached = 0x40000000, attachGood = 0x20000000, attachGoodLeg = 0x10000000, attachTube = 0x08000000, attachHighIncl = 0x04000000, attachTrackMask = 0x03FFFFFF, attachFlagMask = 0xFC000000};
 	
 	short MemoryResMerger() {return mMemoryResMerger;}
 	short MemoryResRefit() {return mMemoryResRefit;}
 
+	void MergeSliceIncremental(int iSlice);
 	void UnpackSlices();
 	void MergeCEInit();
 	void MergeCE();
@@ -90,20 +103,31 @@ public:
 	AliGPUTPCGMMerger(const AliGPUTPCGMMerger &) CON_DELETE;
 	const AliGPUTPCGMMerger &operator=(const AliGPUTPCGMMerger &) const CON_DELETE;
 
+	int UnpackSliceLocalTracks(int iSlice, int first, int *trackIds, const AliGPUTPCSliceOutTrack *&firstGlobalTrack);
+	void CompactIncrementalSlices(int *trackIds);
+	void MergeWithinSlice(int iSlice);
+	void MergeSlicePair(int iSlice, int border0, int border1, bool fromOrig);
 	void MakeBorderTracks(int iSlice, int iBorder, AliGPUTPCGMBorderTrack B[], int &nB, bool fromOrig = false);
 	void MergeBorderTracks(int iSlice1, AliGPUTPCGMBorderTrack B1[], int N1, int iSlice2, AliGPUTPCGMBorderTrack B2[], int N2, int crossCE = 0);
 
 	void MergeCEFill(const AliGPUTPCGMSliceTrack *track, const AliGPUTPCGMMergedTrackHit &cls, int itr);
-	void ResolveMergeSlices(bool fromOrig, bool mergeAll);
+	void MergeCECopyClusters(const AliGPUTPCGMMerger_CECopy *copies, int nCopies);
+	int CollectTrackParts(int itr, AliGPUTPCGMSliceTrack **trackParts, int &leg);
+	int CollectTrackClusters(AliGPUTPCGMSliceTrack **trackParts, int nParts, int leg, float qpt, AliGPUTPCSliceOutCluster *trackClusters, uchar2 *clA, int &firstTrackIndex, int &lastTrackIndex);
+	void ResolveMergeSlices(bool fromOrig, bool mergeAll, int firstTrack, int lastTrack);
 	void MergeSlicesStep(int border0, int border1, bool fromOrig);
-	void ClearTrackLinks(int n);
+	void ClearTrackLinks(int first, int last);
 
 	void PrintMergeGraph(AliGPUTPCGMSliceTrack *trk);
 	void CheckMergedTracks();
 	int GetTrackLabel(AliGPUTPCGMBorderTrack &trk);
 
+	AliGPUTPCSliceOutCluster SliceTrackCluster(const AliGPUTPCGMSliceTrack &track, int i) const;
+	float SliceTrackMinClusterZ(const AliGPUTPCGMSliceTrack &track) const;
+	float SliceTrackMaxClusterZ(const AliGPUTPCGMSliceTrack &track) const;
+
 	int SliceTrackInfoFirst(int iSlice) { return fSliceTrackInfoIndex[iSlice]; }
-	int SliceTrackInfoLast(int iSlice) { return fSliceTrackInfoIndex[iSlice + 1]; }
+	int SliceTrackInfoLast(int iSlice) { return fSliceTrackInfoIndex[iSlice] + fSliceNLocalTracks[iSlice]; }
 	int SliceTrackInfoGlobalFirst(int iSlice) { return fSliceTrackInfoIndex[fgkNSlices + iSlice]; }
 	int SliceTrackInfoGlobalLast(int iSlice) { return fSliceTrackInfoIndex[fgkNSlices + iSlice + 1]; }
 	int SliceTrackInfoLocalTotal() { return fSliceTrackInfoIndex[fgkNSlices]; }
@@ -114,6 +138,7 @@ public:
 	int fPrevSliceInd[fgkNSlices];
 
 	AliGPUTPCGMPolynomialField fField;
+	const AliGPUTPCGMMaterialLUT *fMaterialLUT; // optional material map for the fit, nullptr for the constant TPC gas material
 
 	const AliGPUTPCSliceOutput *fkSlices[fgkNSlices]; //* array of input slice tracks
 
@@ -122,6 +147,7 @@ public:
 	unsigned int fNMaxSliceTracks; //maximum number of incoming slice tracks
 	unsigned int fNMaxTracks; //maximum number of output tracks
 	unsigned int fNMaxSingleSliceTracks; // max N tracks in one slice
+	unsigned int fSliceNMaxTracks[fgkNSlices]; // max N tracks of a slice, size of its region in the border memory, and in incremental mode also in the track infos
 	unsigned int fNMaxOutputTrackClusters; //max number of clusters in output tracks (double-counting shared clusters)
 	unsigned int fNMaxClusters; //max total unique clusters (in event)
 	
@@ -136,15 +162,20 @@ public:
 
 	AliGPUTPCGMSliceTrack *fSliceTrackInfos; //* additional information for slice tracks
 	int fSliceTrackInfoIndex[fgkNSlices * 2 + 1];
+	int fSliceNLocalTracks[fgkNSlices]; // number of unpacked local tracks of a slice
+	bool fIncremental; // the slices are unpacked and merged as soon as their output is ready, see MergeSliceIncremental
+	GPUAtomic(int) fSlicePairReady[fgkNSlices]; // incremental mode: number of finished slices of the pair (slice, next slice)
 	AliGPUTPCGMMergedTrackHit *fClusters;
 	int *fGlobalClusterIDs;
 	GPUAtomic(int) *fClusterAttachment;
 	unsigned int *fTrackOrder;
+	unsigned int *fTrackOrderProcess; // order in which the tracks are fit, nullptr for the natural order
+	float *fTrackFitTimes; // refit time of each output track in seconds, filled by the CPU refit if set (benchmarking)
 	char* fTmpMem;
 	AliGPUTPCGMBorderTrack *fBorderMemory; // memory for border tracks
-	AliGPUTPCGMBorderTrack *fBorder[fgkNSlices];
+	AliGPUTPCGMBorderTrack *fBorder[fgkNSlices]; // border tracks of a slice, 2 x NTracks of the slice, the second half holds the tracks of the previous slice's border
 	AliGPUTPCGMBorderTrack::Range *fBorderRangeMemory;       // memory for border tracks
-	AliGPUTPCGMBorderTrack::Range *fBorderRange[fgkNSlices]; // memory for border tracks
+	AliGPUTPCGMBorderTrack::Range *fBorderRange[fgkNSlices]; // range buffers of a slice pair, 3 x fNMaxSingleSliceTracks: ranges 1, ranges 2, sort buffer
 	int fBorderCETracks[2][fgkNSlices];
 
 	const AliGPUTPCTracker *fSliceTrackers;
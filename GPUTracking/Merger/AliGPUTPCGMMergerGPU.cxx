@@ -1,16 +1,78 @@
 #include "AliGPUTPCGMMergerGPU.h"
 #include "AliGPUConstantMem.h"
-#if defined(GPUCA_HAVE_OPENMP) && !defined(GPUCA_GPUCODE)
+#ifndef GPUCA_GPUCODE
 #include "AliGPUReconstruction.h"
+#include "AliGPUTPCGMTrackFitLanes.h"
+#include "utils/timer.h"
+#endif
+
+GPUdi() static void AliGPUTPCGMMergerTrackFit_RefitTrack(AliGPUTPCGMMerger &merger, int i)
+{
+#ifndef GPUCA_GPUCODE
+	if (merger.TrackFitTimes())
+	{
+		HighResTimer timer;
+		timer.Start();
+		AliGPUTPCGMTrackParam::RefitTrack(merger.OutputTracks()[i], i, &merger, merger.Clusters());
+		merger.TrackFitTimes()[i] = timer.GetCurrentElapsedTime();
+		return;
+	}
+#endif
+	AliGPUTPCGMTrackParam::RefitTrack(merger.OutputTracks()[i], i, &merger, merger.Clusters());
+}
+
+#ifndef GPUCA_GPUCODE
+template <int N> static void AliGPUTPCGMMergerTrackFit_RefitLanes(AliGPUTPCGMMerger &merger)
+{
+	//Blocks of N consecutive tracks in the order sorted by the number of clusters, so the lanes get a similar number of steps
+	const unsigned int *order = merger.TrackOrderProcess();
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel for num_threads(merger.GetRec().GetDeviceProcessingSettings().nThreads) schedule(dynamic)
+#endif
+	for (int ii = 0;ii < merger.NOutputTracks();ii += N)
+	{
+		const int n = CAMath::Min(N, merger.NOutputTracks() - ii);
+		if (merger.TrackFitTimes())
+		{
+			HighResTimer timer;
+			timer.Start();
+			AliGPUTPCGMTrackFitLanes<N>::RefitTracks(merger, order + ii, n);
+			const float time = timer.GetCurrentElapsedTime() / n; //The tracks of a block are fit together, each one gets the average
+			for (int i = 0;i < n;i++) merger.TrackFitTimes()[order[ii + i]] = time;
+			continue;
+		}
+		AliGPUTPCGMTrackFitLanes<N>::RefitTracks(merger, order + ii, n);
+	}
+}
 #endif
 
 template <> GPUd() void AliGPUTPCGMMergerTrackFit::Thread<0>(int nBlocks, int nThreads, int iBlock, int iThread, GPUsharedref() AliGPUTPCSharedMemory &smem, workerType &merger)
 {
+#ifndef GPUCA_GPUCODE
+	const int lanes = merger.GetRec().GetDeviceProcessingSettings().mergerFitLanes;
+	if (lanes && merger.TrackOrderProcess())
+	{
+		if (lanes == 4) AliGPUTPCGMMergerTrackFit_RefitLanes<4>(merger);
+		else if (lanes == 8) AliGPUTPCGMMergerTrackFit_RefitLanes<8>(merger);
+		else AliGPUTPCGMMergerTrackFit_RefitLanes<16>(merger);
+		return;
+	}
+#endif
 #if defined(GPUCA_HAVE_OPENMP) && !defined(GPUCA_GPUCODE)
+	if (merger.TrackOrderProcess())
+	{
+		//The tracks are sorted by cluster count, the long tracks come first and are handed out dynamically to balance the threads
+#pragma omp parallel for num_threads(merger.GetRec().GetDeviceProcessingSettings().nThreads) schedule(dynamic, 16)
+		for (int ii = 0;ii < merger.NOutputTracks();ii++)
+		{
+			AliGPUTPCGMMergerTrackFit_RefitTrack(merger, merger.TrackOrderProcess()[ii]);
+		}
+		return;
+	}
 #pragma omp parallel for num_threads(merger.GetRec().GetDeviceProcessingSettings().nThreads)
 #endif
-	for (int i = get_global_id(0);i < merger.NOutputTracks();i += get_global_size(0))
+	for (int ii = get_global_id(0);ii < merger.NOutputTracks();ii += get_global_size(0))
 	{
-		AliGPUTPCGMTrackParam::RefitTrack(merger.OutputTracks()[i], i, &merger, merger.Clusters());
+		AliGPUTPCGMMergerTrackFit_RefitTrack(merger, merger.TrackOrderProcess() ? merger.TrackOrderProcess()[ii] : ii);
 	}
 }
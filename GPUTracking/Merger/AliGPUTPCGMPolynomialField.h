@@ -44,6 +44,16 @@ class AliGPUTPCGMPolynomialField
         GPUd() void GetFieldIts(float x, float y, float z, float B[3]) const;
 	GPUd() float GetFieldItsBz(float x, float y, float z) const;
 
+	// Evaluate the field at n points given as separate coordinate arrays, the results agree with the per-point functions within float rounding
+	GPUd() void GetField(int n, const float *x, const float *y, const float *z, float *Bx, float *By, float *Bz) const;
+	GPUd() void GetFieldBz(int n, const float *x, const float *y, const float *z, float *Bz) const;
+
+	GPUd() void GetFieldTrd(int n, const float *x, const float *y, const float *z, float *Bx, float *By, float *Bz) const;
+	GPUd() void GetFieldTrdBz(int n, const float *x, const float *y, const float *z, float *Bz) const;
+
+	GPUd() void GetFieldIts(int n, const float *x, const float *y, const float *z, float *Bx, float *By, float *Bz) const;
+	GPUd() void GetFieldItsBz(int n, const float *x, const float *y, const float *z, float *Bz) const;
+
 	void Print() const;
 
 	static CONSTEXPR int fkTpcM = 10;    // number of coefficients
@@ -54,6 +64,12 @@ class AliGPUTPCGMPolynomialField
 	GPUd() static void GetPolynomsTrd(float x, float y, float z, float f[fkTrdM]);
 	GPUd() static void GetPolynomsIts(float x, float y, float z, float f[fkItsM]);
 
+	// Polynomials of the TPC / ITS (quadratic) and TRD (cubic) fields in nested form and their evaluation at n points, used by the batched functions
+	GPUd() static float EvalPolynomTpc(const float c[fkTpcM], float x, float y, float z);
+	GPUd() static float EvalPolynomTrd(const float c[fkTrdM], float x, float y, float z);
+	GPUd() static void EvalBatchTpc(const float coeff[fkTpcM], int n, const float *x, const float *y, const float *z, float *B);
+	GPUd() static void EvalBatchTrd(const float coeff[fkTrdM], int n, const float *x, const float *y, const float *z, float *B);
+
 	const float *GetCoeffTpcBx() const { return fTpcBx; }
 	const float *GetCoeffTpcBy() const { return fTpcBy; }
 	const float *GetCoeffTpcBz() const { return fTpcBz; }
@@ -264,4 +280,73 @@ GPUdi() float AliGPUTPCGMPolynomialField::GetFieldItsBz( float x, float y, float
 	return bz;
 }
 
+GPUdi() float AliGPUTPCGMPolynomialField::EvalPolynomTpc( const float c[fkTpcM], float x, float y, float z )
+{
+	return c[0] + x*(c[1] + c[4]*x + c[5]*y + c[6]*z) + y*(c[2] + c[7]*y + c[8]*z) + z*(c[3] + c[9]*z);
+}
+
+GPUdi() float AliGPUTPCGMPolynomialField::EvalPolynomTrd( const float c[fkTrdM], float x, float y, float z )
+{
+	return c[0] + x*(c[1] + x*(c[4] + c[10]*x + c[11]*y + c[12]*z) + y*(c[5] + c[13]*y + c[14]*z) + z*(c[6] + c[15]*z))
+	            + y*(c[2] + y*(c[7] + c[16]*y + c[17]*z) + z*(c[8] + c[18]*z))
+	            + z*(c[3] + z*(c[9] + c[19]*z));
+}
+
+// The batched functions evaluate one field component at a time. The coefficients are copied to the stack, so that they cannot
+// alias the output array, and the polynomials are evaluated in nested form without temporary arrays. The loops over the points then vectorise.
+
+GPUdi() void AliGPUTPCGMPolynomialField::EvalBatchTpc( const float coeff[fkTpcM], int n, const float *x, const float *y, const float *z, float *B )
+{
+	float c[fkTpcM];
+	for( int j=0; j<fkTpcM; j++) c[j] = coeff[j];
+	for( int i=0; i<n; i++){
+		B[i] = EvalPolynomTpc(c, x[i], y[i], z[i]);
+	}
+}
+
+GPUdi() void AliGPUTPCGMPolynomialField::EvalBatchTrd( const float coeff[fkTrdM], int n, const float *x, const float *y, const float *z, float *B )
+{
+	float c[fkTrdM];
+	for( int j=0; j<fkTrdM; j++) c[j] = coeff[j];
+	for( int i=0; i<n; i++){
+		B[i] = EvalPolynomTrd(c, x[i], y[i], z[i]);
+	}
+}
+
+GPUdi() void AliGPUTPCGMPolynomialField::GetField( int n, const float *x, const float *y, const float *z, float *Bx, float *By, float *Bz ) const
+{
+	EvalBatchTpc(fTpcBx, n, x, y, z, Bx);
+	EvalBatchTpc(fTpcBy, n, x, y, z, By);
+	EvalBatchTpc(fTpcBz, n, x, y, z, Bz);
+}
+
+GPUdi() void AliGPUTPCGMPolynomialField::GetFieldBz( int n, const float *x, const float *y, const float *z, float *Bz ) const
+{
+	EvalBatchTpc(fTpcBz, n, x, y, z, Bz);
+}
+
+GPUdi() void AliGPUTPCGMPolynomialField::GetFieldTrd( int n, const float *x, const float *y, const float *z, float *Bx, float *By, float *Bz ) const
+{
+	EvalBatchTrd(fTrdBx, n, x, y, z, Bx);
+	EvalBatchTrd(fTrdBy, n, x, y, z, By);
+	EvalBatchTrd(fTrdBz, n, x, y, z, Bz);
+}
+
+GPUdi() void AliGPUTPCGMPolynomialField::GetFieldTrdBz( int n, const float *x, const float *y, const float *z, float *Bz ) const
+{
+	EvalBatchTrd(fTrdBz, n, x, y, z, Bz);
+}
+
+GPUdi() void AliGPUTPCGMPolynomialField::GetFieldIts( int n, const float *x, const float *y, const float *z, float *Bx, float *By, float *Bz ) const
+{
+	EvalBatchTpc(fItsBx, n, x, y, z, Bx);
+	EvalBatchTpc(fItsBy, n, x, y, z, By);
+	EvalBatchTpc(fItsBz, n, x, y, z, Bz);
+}
+
+GPUdi() void AliGPUTPCGMPolynomialField::GetFieldItsBz( int n, const float *x, const float *y, const float *z, float *Bz ) const
+{
+	EvalBatchTpc(fItsBz, n, x, y, z, Bz);
+}
+
 #endif
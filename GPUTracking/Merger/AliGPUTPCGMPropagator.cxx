@@ -37,8 +37,8 @@ GPUd()void AliGPUTPCGMPropagator::GetBxByBz(float Alpha, float X, float Y, float
 {
 	// get global coordinates
 
-	float cs = CAMath::Cos(Alpha);
-	float sn = CAMath::Sin(Alpha);
+	float cs, sn;
+	GetAlphaCosSin(Alpha, cs, sn);
 
 #if defined(GMPropagatorUseFullField)
 	const double kCLight = 0.000299792458;
@@ -92,8 +92,8 @@ GPUd() float AliGPUTPCGMPropagator::GetBz(float Alpha, float X, float Y, float Z
 
 	// get global coordinates
 
-	float cs = CAMath::Cos(Alpha);
-	float sn = CAMath::Sin(Alpha);
+	float cs, sn;
+	GetAlphaCosSin(Alpha, cs, sn);
 
 #if defined(GMPropagatorUseFullField)
 	const double kCLight = 0.000299792458;
@@ -261,7 +261,7 @@ GPUd() int AliGPUTPCGMPropagator::RotateToAlpha(float newAlpha)
 		//c[13] = c[13];
 	}
 
-	fAlpha = newAlpha;
+	SetAlpha(newAlpha);
 	fT0 = t0;
 
 	return 0;
@@ -292,6 +292,7 @@ GPUd() int AliGPUTPCGMPropagator::PropagateToXAlpha(float posX, float posAlpha,
 	float dL = CAMath::Abs(dLp * t0e.P());
 
 	if (inFlyDirection) dL = -dL;
+	if (fMaterialLUT) UpdateMaterial(t0e);
 
 	float ey = fT0.SinPhi();
 	float ex = fT0.CosPhi();
@@ -550,6 +551,7 @@ GPUd() int AliGPUTPCGMPropagator::PropagateToXAlphaBz(float posX, float posAlpha
   float dL =  CAMath::Abs(dLp*t0e.P());
 
   if( inFlyDirection ) dL = -dL;
+  if( fMaterialLUT ) UpdateMaterial( t0e );
   
   float k  = -fT0.QPt()*Bz;
   float dx = posX - fT0.X();
@@ -930,6 +932,30 @@ GPUd() void AliGPUTPCGMPropagator::CalculateMaterialCorrection()
 	fMaterial.fSigmadE2 = fMaterial.fSigmadE2 * betheRho; // + fMaterial.fK44;
 }
 
+GPUd() void AliGPUTPCGMPropagator::UpdateMaterial(const AliGPUTPCGMPhysicalTrackModel &t0e)
+{
+	//Take the material at the middle of the step from fT0 to t0e, the corrections are only recalculated when it changes
+	const float x = 0.5f * (fT0.GetX() + t0e.GetX());
+	const float y = 0.5f * (fT0.GetY() + t0e.GetY());
+	const float z = 0.5f * (fT0.GetZ() + t0e.GetZ());
+	float rho, rhoOverRadLen, radLen;
+	if (fMaterialLUT->GetMaterial(CAMath::Sqrt(x * x + y * y), z, CAMath::ATan2(y, x) + fAlpha, rho, rhoOverRadLen))
+	{
+		radLen = rhoOverRadLen > 0.f ? rho / rhoOverRadLen : 0.f;
+	}
+	else
+	{	//Outside of the table, use the constant material
+		rho = fDefaultRho;
+		radLen = fDefaultRadLen;
+		rhoOverRadLen = (radLen > 1.e-4f) ? rho / radLen : 0.f;
+	}
+	if (rho == fMaterial.fRho && rhoOverRadLen == fMaterial.fRhoOverRadLen) return;
+	fMaterial.fRho = rho;
+	fMaterial.fRhoOverRadLen = rhoOverRadLen;
+	fMaterial.fRadLen = radLen;
+	CalculateMaterialCorrection();
+}
+
 GPUd() void AliGPUTPCGMPropagator::Rotate180()
 {
 	fT0.X() = -fT0.X();
@@ -946,6 +972,7 @@ GPUd() void AliGPUTPCGMPropagator::Rotate180()
 	fAlpha = fAlpha + M_PI;
 	while (fAlpha >= M_PI) fAlpha -= 2 * M_PI;
 	while (fAlpha < -M_PI) fAlpha += 2 * M_PI;
+	SetAlpha(fAlpha);
 
 	float *c = fT->Cov();
 	c[6] = -c[6];
@@ -14,6 +14,7 @@
 #include "AliGPUTPCGMOfflineStatisticalErrors.h"
 #include "AliGPUTPCGMPhysicalTrackModel.h"
 #include "AliGPUTPCGMPolynomialField.h"
+#include "AliGPUTPCGMMaterialLUT.h"
 #include "AliGPUCommonMath.h"
 
 class AliGPUTPCGMTrackParam;
@@ -46,6 +47,7 @@ class AliGPUTPCGMPropagator
 	};
 
 	GPUd() void SetMaterial(float radLen, float rho);
+	GPUd() void SetMaterialLUT(const AliGPUTPCGMMaterialLUT *lut) { fMaterialLUT = lut; } // when set, the material is looked up at every propagation step, the constant one is used outside of the table
 
 	GPUd() void SetPolynomialField(const AliGPUTPCGMPolynomialField *field) { fField = field; }
 
@@ -104,15 +106,26 @@ class AliGPUTPCGMPropagator
 	GPUd() void SetStatErrorCurCluster(AliGPUTPCGMMergedTrackHit *c) { fStatErrors.SetCurCluster(c); }
 
   private:
+#ifndef GPUCA_GPUCODE
+	template <int>
+	friend class AliGPUTPCGMTrackFitLanes; // runs the propagation and the update of several tracks in SIMD lanes
+#endif
+
 	GPUd() static float ApproximateBetheBloch(float beta2);
+	GPUd() void SetAlpha(float Alpha);
+	GPUd() void GetAlphaCosSin(float Alpha, float &cs, float &sn) const;
+	GPUd() void UpdateMaterial(const AliGPUTPCGMPhysicalTrackModel &t0e);
 
 	const AliGPUTPCGMPolynomialField *fField;
 	FieldRegion fFieldRegion;
 
 	AliGPUTPCGMTrackParam *fT;
 	float fAlpha; // rotation angle of the track coordinate system
+	float fCosAlpha, fSinAlpha; // cached cos and sin of fAlpha, the field is evaluated in global coordinates at every propagation step
 	AliGPUTPCGMPhysicalTrackModel fT0;
 	MaterialCorrection fMaterial;
+	const AliGPUTPCGMMaterialLUT *fMaterialLUT;
+	float fDefaultRadLen, fDefaultRho; // constant material set with SetMaterial
 	bool fSpecialErrors;
 	bool fFitInProjections; // fit (Y,SinPhi,QPt) and (Z,DzDs) paramteres separatelly
 	bool fToyMCEvents;      // events are simulated with simple home-made simulation
@@ -122,13 +135,15 @@ class AliGPUTPCGMPropagator
 };
 
 GPUd() inline AliGPUTPCGMPropagator::AliGPUTPCGMPropagator()
-    : fField(0), fFieldRegion(TPC), fT(0), fAlpha(0), fT0(), fMaterial(),
+    : fField(0), fFieldRegion(TPC), fT(0), fAlpha(0), fCosAlpha(1.f), fSinAlpha(0.f), fT0(), fMaterial(), fMaterialLUT(0), fDefaultRadLen(fMaterial.fRadLen), fDefaultRho(fMaterial.fRho),
       fSpecialErrors(0), fFitInProjections(1), fToyMCEvents(0), fMaxSinPhi(GPUCA_MAX_SIN_PHI), fStatErrors()
 {
 }
 
 GPUd() inline void AliGPUTPCGMPropagator::SetMaterial(float radLen, float rho)
 {
+	fDefaultRadLen = radLen;
+	fDefaultRho = rho;
 	fMaterial.fRho = rho;
 	fMaterial.fRadLen = radLen;
 	fMaterial.fRhoOverRadLen = (radLen > 1.e-4f) ? rho / radLen : 0.f;
@@ -140,10 +155,31 @@ GPUd() inline void AliGPUTPCGMPropagator::SetTrack(AliGPUTPCGMTrackParam *track,
 	fT = track;
 	if (!fT) return;
 	fT0.Set(*fT);
-	fAlpha = Alpha;
+	SetAlpha(Alpha);
 	CalculateMaterialCorrection();
 }
 
+GPUd() inline void AliGPUTPCGMPropagator::SetAlpha(float Alpha)
+{
+	fAlpha = Alpha;
+	fCosAlpha = CAMath::Cos(Alpha);
+	fSinAlpha = CAMath::Sin(Alpha);
+}
+
+GPUd() inline void AliGPUTPCGMPropagator::GetAlphaCosSin(float Alpha, float &cs, float &sn) const
+{
+	if (Alpha == fAlpha)
+	{
+		cs = fCosAlpha;
+		sn = fSinAlpha;
+	}
+	else
+	{
+		cs = CAMath::Cos(Alpha);
+		sn = CAMath::Sin(Alpha);
+	}
+}
+
 GPUd() inline float AliGPUTPCGMPropagator::GetMirroredYModel() const
 {
 	float Bz = GetBz(fAlpha, fT0.GetX(), fT0.GetY(), fT0.GetZ());
@@ -23,10 +23,8 @@
 #include <cmath>
 #endif
 
-bool AliGPUTPCGMSliceTrack::FilterErrors(const AliGPUParam &param, float maxSinPhi, float sinPhiMargin)
+bool AliGPUTPCGMSliceTrack::FilterErrors(const AliGPUParam &param, float lastX, float maxSinPhi, float sinPhiMargin)
 {
-	float lastX = fOrigTrack->Cluster(fOrigTrack->NClusters() - 1).GetX();
-
 	const int N = 3;
 
 	float bz = -param.ConstBz;
@@ -50,9 +50,6 @@ class AliGPUTPCGMSliceTrack
 	int GlobalTrackId(int n) const { return fGlobalTrackIds[n]; }
 	void SetGlobalTrackId(int n, int v) { fGlobalTrackIds[n] = v; }
 
-	float MaxClusterZ() { return CAMath::Max(fOrigTrack->Clusters()->GetZ(), (fOrigTrack->Clusters() + fOrigTrack->NClusters() - 1)->GetZ()); }
-	float MinClusterZ() { return CAMath::Min(fOrigTrack->Clusters()->GetZ(), (fOrigTrack->Clusters() + fOrigTrack->NClusters() - 1)->GetZ()); }
-
 	void Set(const AliGPUTPCSliceOutTrack *sliceTr, float alpha, int slice)
 	{
 		const AliGPUTPCBaseTrackParam &t = sliceTr->Param();
@@ -104,7 +101,7 @@ class AliGPUTPCGMSliceTrack
 		fAlpha = t.fAlpha;
 	}
 
-	bool FilterErrors(const AliGPUParam &param, float maxSinPhi = GPUCA_MAX_SIN_PHI, float sinPhiMargin = 0.f);
+	bool FilterErrors(const AliGPUParam &param, float lastX, float maxSinPhi = GPUCA_MAX_SIN_PHI, float sinPhiMargin = 0.f);
 
 	bool TransportToX(float x, float Bz, AliGPUTPCGMBorderTrack &b, float maxSinPhi, bool doCov = true) const;
 
@@ -0,0 +1,889 @@
+// **************************************************************************
+// This file is property of and copyright by the ALICE HLT Project          *
+// ALICE Experiment at CERN, All rights reserved.                           *
+//                                                                          *
+// Permission to use, copy, modify and distribute this software and its     *
+// documentation strictly for non-commercial purposes is hereby granted     *
+// without fee, provided that the above copyright notice appears in all     *
+// copies and that both the copyright notice and this permission notice     *
+// appear in the supporting documentation. The authors make no claims       *
+// about the suitability of this software for any purpose. It is            *
+// provided "as is" without express or implied warranty.                    *
+//                                                                          *
+//***************************************************************************
+
+#include "AliGPUTPCDef.h"
+#include "AliGPUTPCGMTrackFitLanes.h"
+#include "AliGPUTPCGMPhysicalTrackModel.h"
+#include "AliGPUTPCGMMergedTrack.h"
+#include "AliGPUTPCGMMerger.h"
+#include "AliGPUParam.h"
+#include <cmath>
+
+static constexpr float kRho = 1.025e-3f;
+static constexpr float kRadLen = 29.532f;
+static constexpr float kDeg2Rad = M_PI / 180.f;
+
+template <int N>
+bool AliGPUTPCGMTrackFitLanes<N>::Eligible(const AliGPUTPCGMMergedTrack &track, const AliGPUTPCGMMergedTrackHit *clusters)
+{
+	if (!track.OK() || track.NClusters() == 0) return false;
+	for (unsigned int i = 1;i < track.NClusters();i++)
+	{
+		if (clusters[i].fLeg != clusters[0].fLeg || (clusters[i].fSlice < 18) != (clusters[0].fSlice < 18)) return false;
+	}
+	return true;
+}
+
+template <int N>
+void AliGPUTPCGMTrackFitLanes<N>::RefitTracks(AliGPUTPCGMMerger &merger, const unsigned int *trackIds, int nTracks)
+{
+	AliGPUTPCGMTrackFitLanes<N> lanes;
+	int nLanes = 0;
+	for (int i = 0;i < nTracks;i++)
+	{
+		AliGPUTPCGMMergedTrack &track = merger.OutputTracks()[trackIds[i]];
+		if (Eligible(track, merger.Clusters() + track.FirstClusterRef()))
+		{
+			lanes.fLane[nLanes].fTrack = &track;
+			lanes.fLane[nLanes++].fITrk = trackIds[i];
+		}
+		else
+		{
+			AliGPUTPCGMTrackParam::RefitTrack(track, trackIds[i], &merger, merger.Clusters());
+		}
+	}
+	if (nLanes) lanes.Fit(merger, nLanes);
+}
+
+template <int N>
+void AliGPUTPCGMTrackFitLanes<N>::Fit(AliGPUTPCGMMerger &merger, int nLanes)
+{
+	const AliGPUParam &param = merger.SliceParam();
+	fNWays = param.rec.NWays;
+	fMaxSinForUpdate = CAMath::Sin(70.f * kDeg2Rad);
+
+	for (int l = 0;l < N;l++)
+	{
+		Lane &lane = fLane[l];
+		lane.fInWay = lane.fAllowModification = false;
+		lane.fX = lane.fY = lane.fZ = 0.f;
+		lane.fClusterState = 0;
+		lane.fGoodRows = 0;
+		if (l >= nLanes) continue;
+		AliGPUTPCGMTrackParam &trk = fTrk[l];
+		AliGPUTPCGMPropagator &prop = fProp[l];
+		lane.fClusters = merger.Clusters() + lane.fTrack->FirstClusterRef();
+		lane.fMaxN = lane.fN = lane.fTrack->NClusters();
+		lane.fNTolerated = 0;
+		lane.fAlpha = lane.fTrack->Alpha();
+		lane.fIHitStart = 0;
+		lane.fCovYYUpd = 0.f;
+		lane.fLastUpdateX = -1.f;
+		lane.fLastRow = lane.fLastSlice = 255;
+		trk = lane.fTrack->Param();
+		prop.SetMaterial(kRadLen, kRho);
+		prop.SetMaterialLUT(merger.MaterialLUT());
+		prop.SetPolynomialField(merger.pField());
+		prop.SetMaxSinPhi(GPUCA_MAX_SIN_PHI);
+		prop.SetToyMCEventsFlag(param.ToyMCEventsFlag);
+		trk.ShiftZ(merger.pField(), lane.fClusters, param, lane.fN);
+	}
+
+	for (fIWay = 0;fIWay < fNWays;fIWay++)
+	{
+		fRefit = fNWays == 1 || fIWay >= 1;
+		const bool inFlyDirection = fIWay & 1;
+		for (int l = 0;l < nLanes;l++)
+		{
+			Lane &lane = fLane[l];
+			AliGPUTPCGMTrackParam &trk = fTrk[l];
+			AliGPUTPCGMPropagator &prop = fProp[l];
+			if (fIWay && param.rec.NWaysOuter && fIWay == fNWays - 1)
+			{
+				AliGPUTPCGMTrackParam::AliGPUTPCOuterParam &outerParam = lane.fTrack->OuterParam();
+				for (int i = 0;i < 5;i++) outerParam.fP[i] = trk.GetPar(i);
+				outerParam.fP[1] += trk.GetZOffset();
+				for (int i = 0;i < 15;i++) outerParam.fC[i] = trk.GetCov(i);
+				outerParam.fX = trk.GetX();
+				outerParam.fAlpha = prop.GetAlpha();
+			}
+			lane.fResetT0 = CAMath::Max(10.f, CAMath::Min(40.f, 150.f / trk.GetQPt()));
+			if (fRefit) prop.SetSpecialErrors(true); //The lanes only run the first attempt
+			trk.ResetCovariance();
+			prop.SetFitInProjections(fIWay != 0);
+			prop.SetTrack(&trk, fIWay ? prop.GetAlpha() : lane.fAlpha);
+			trk.ConstrainSinPhi(prop.GetFitInProjections() ? 0.95f : GPUCA_MAX_SIN_PHI_LOW);
+			lane.fN = 0;
+			lane.fLastUpdateX = -1.f;
+			lane.fIHit = lane.fIHitStart;
+			lane.fNMissed = lane.fNMissed2 = 0;
+			lane.fGoodRows = 0;
+			lane.fInWay = true;
+		}
+
+		//Each pass of the loop processes the next measurement of every lane, lanes which have finished the way are masked
+		for (;;)
+		{
+			int step[N], err[N], retVal[N], clusterState[N], rejectChi2[N];
+			float posX[N], posY[N], posZ[N], err2Y[N], err2Z[N];
+			bool any = false;
+			for (int l = 0;l < N;l++)
+			{
+				step[l] = fLane[l].fInWay ? NextMeasurement(merger, l, err[l]) : (int) kStepNone;
+				if (step[l] == kStepNone) fLane[l].fInWay = false;
+				else any = true;
+				posX[l] = fLane[l].fX;
+			}
+			if (!any) break;
+
+			int mask[N];
+			for (int l = 0;l < N;l++) mask[l] = step[l] == kStepPropagate;
+			PropagateLanes(mask, posX, inFlyDirection, err);
+
+			for (int l = 0;l < N;l++)
+			{
+				if (step[l] != kStepNone) step[l] = CheckPropagation(merger, l, err[l], err2Y[l], err2Z[l], retVal[l]);
+				mask[l] = step[l] == kStepUpdate;
+				posY[l] = fLane[l].fY;
+				posZ[l] = fLane[l].fZ;
+				clusterState[l] = fLane[l].fClusterState;
+				rejectChi2[l] = fLane[l].fAllowModification && fLane[l].fGoodRows > 5;
+			}
+			UpdateLanes(mask, posY, posZ, err2Y, err2Z, clusterState, rejectChi2, retVal);
+
+			for (int l = 0;l < N;l++)
+			{
+				if (step[l] != kStepNone) FinishMeasurement(l, retVal[l]);
+			}
+		}
+		for (int l = 0;l < nLanes;l++)
+		{
+			if (((fNWays - fIWay) & 1)) fTrk[l].ShiftZ(merger.pField(), fLane[l].fClusters, param, fLane[l].fN);
+		}
+	}
+
+	const int nAttempts = param.rec.RefitMaxAttempts;
+	for (int l = 0;l < nLanes;l++)
+	{
+		Lane &lane = fLane[l];
+		bool ok = fTrk[l].FinishFit(fProp[l], param, lane.fN, lane.fNTolerated, lane.fCovYYUpd, lane.fAlpha);
+		if (!ok && nAttempts > 1)
+		{
+			//Further attempts are rare, they run in the scalar code
+			AliGPUTPCGMTrackParam::ResetClusterStates(*lane.fTrack, merger.Clusters());
+			AliGPUTPCGMTrackParam::RefitTrack(*lane.fTrack, lane.fITrk, &merger, merger.Clusters(), 1);
+		}
+		else
+		{
+			AliGPUTPCGMTrackParam::StoreRefitResult(*lane.fTrack, &merger, merger.Clusters(), fTrk[l], ok, lane.fN, lane.fAlpha, false);
+		}
+	}
+}
+
+template <int N>
+int AliGPUTPCGMTrackFitLanes<N>::NextMeasurement(const AliGPUTPCGMMerger &merger, int l, int &err)
+{
+	//Same as the beginning of the hit loop of AliGPUTPCGMTrackParam::Fit, without the looper and central electrode handling
+	const AliGPUParam &param = merger.SliceParam();
+	Lane &lane = fLane[l];
+	AliGPUTPCGMTrackParam &trk = fTrk[l];
+	AliGPUTPCGMPropagator &prop = fProp[l];
+	AliGPUTPCGMMergedTrackHit *clusters = lane.fClusters;
+	const int wayDirection = (fIWay & 1) ? -1 : 1;
+	const bool inFlyDirection = fIWay & 1;
+
+	for (;lane.fIHit >= 0 && lane.fIHit < lane.fMaxN;lane.fIHit += wayDirection)
+	{
+		const int ihit = lane.fIHit;
+		lane.fX = clusters[ihit].fX;
+		lane.fY = clusters[ihit].fY;
+		lane.fZ = clusters[ihit].fZ - trk.GetZOffset();
+		lane.fClusterState = clusters[ihit].fState;
+		const float clAlpha = param.Alpha(clusters[ihit].fSlice);
+		if ((param.rec.RejectMode > 0 && lane.fNMissed >= param.rec.RejectMode) || lane.fNMissed2 >= GPUCA_MERGER_MAXN_MISSED_HARD || clusters[ihit].fState & AliGPUTPCGMMergedTrackHit::flagReject)
+		{
+			if (fIWay + 2 >= fNWays && !(clusters[ihit].fState & AliGPUTPCGMMergedTrackHit::flagReject)) clusters[ihit].fState |= AliGPUTPCGMMergedTrackHit::flagRejectErr;
+			continue;
+		}
+
+		lane.fAllowModification = fRefit && (fIWay == 0 || (((fNWays - fIWay) & 1) ? (ihit >= CAMath::Min(lane.fMaxN / 2, 30)) : (ihit <= CAMath::Max(lane.fMaxN / 2, lane.fMaxN - 30))));
+		lane.fIHitMergeFirst = ihit;
+		prop.SetStatErrorCurCluster(&clusters[ihit]);
+
+		if (trk.MergeDoubleRowClusters(ihit, wayDirection, clusters, param, prop, lane.fX, lane.fY, lane.fZ, lane.fMaxN, clAlpha, lane.fClusterState, lane.fAllowModification) == -1) {lane.fNMissed++;lane.fNMissed2++;continue;}
+
+		if (lane.fAllowModification && lane.fLastRow != 255 && CAMath::Abs(clusters[ihit].fRow - lane.fLastRow) > 1)
+		{
+			trk.AttachClustersPropagate(&merger, clusters[ihit].fSlice, lane.fLastRow, clusters[ihit].fRow, lane.fITrk, clusters[ihit].fLeg == clusters[lane.fMaxN - 1].fLeg, prop, inFlyDirection);
+		}
+
+		if (CAMath::Abs(clAlpha - prop.GetAlpha()) > 1.e-4f) //The rotation to another sector is not done in the lanes
+		{
+			err = prop.PropagateToXAlpha(lane.fX, clAlpha, inFlyDirection);
+			if (err == -2) //Rotation failed, try to bring to new x with old alpha first, rotate, and then propagate to x, alpha
+			{
+				if (prop.PropagateToXAlpha(lane.fX, prop.GetAlpha(), inFlyDirection) == 0)
+					err = prop.PropagateToXAlpha(lane.fX, clAlpha, inFlyDirection);
+			}
+			return kStepPropagated;
+		}
+		return kStepPropagate;
+	}
+	return kStepNone;
+}
+
+template <int N>
+int AliGPUTPCGMTrackFitLanes<N>::CheckPropagation(const AliGPUTPCGMMerger &merger, int l, int err, float &err2Y, float &err2Z, int &retVal)
+{
+	//Same as the checks between the propagation and the update in AliGPUTPCGMTrackParam::Fit
+	const AliGPUParam &param = merger.SliceParam();
+	Lane &lane = fLane[l];
+	AliGPUTPCGMTrackParam &trk = fTrk[l];
+	AliGPUTPCGMPropagator &prop = fProp[l];
+	AliGPUTPCGMMergedTrackHit *clusters = lane.fClusters;
+	const int wayDirection = (fIWay & 1) ? -1 : 1;
+	const int ihit = lane.fIHit;
+
+	if (lane.fLastRow == 255 || CAMath::Abs((int) lane.fLastRow - (int) clusters[ihit].fRow) > 5 || lane.fLastSlice != clusters[ihit].fSlice || (param.rec.RejectMode < 0 && -lane.fNMissed <= param.rec.RejectMode)) lane.fGoodRows = 0;
+	else lane.fGoodRows++;
+	if (err == 0)
+	{
+		lane.fLastRow = clusters[ihit].fRow;
+		lane.fLastSlice = clusters[ihit].fSlice;
+	}
+
+	if (lane.fAllowModification) trk.AttachClusters(&merger, clusters[ihit].fSlice, clusters[ihit].fRow, lane.fITrk, clusters[ihit].fLeg == clusters[lane.fMaxN - 1].fLeg);
+
+	const int err2 = trk.GetNDF() > 0 && CAMath::Abs(prop.GetSinPhi0()) >= fMaxSinForUpdate;
+	if (err || err2)
+	{
+		if (trk.GetY() > GPUCA_MERGER_COV_LIMIT || trk.GetSinPhi() > GPUCA_MERGER_COV_LIMIT)
+		{
+			lane.fInWay = false;
+			return kStepNone;
+		}
+		trk.MarkClusters(clusters, lane.fIHitMergeFirst, ihit, wayDirection, AliGPUTPCGMMergedTrackHit::flagNotFit);
+		lane.fNMissed2++;
+		lane.fNTolerated++;
+		lane.fIHit += wayDirection;
+		return kStepNone;
+	}
+
+	float threshold = 3.f + (lane.fLastUpdateX >= 0 ? (CAMath::Abs(trk.GetX() - lane.fLastUpdateX) / 2) : 0.f);
+	if (trk.GetNDF() > 5 && (CAMath::Abs(lane.fY - trk.GetY()) > threshold || CAMath::Abs(lane.fZ - trk.GetZ()) > threshold))
+	{
+		retVal = 2;
+		return kStepResult;
+	}
+	if (trk.GetNDF() == -5) //The first measurement sets the track parameters
+	{
+		retVal = prop.Update(lane.fY, lane.fZ, clusters[ihit].fRow, param, lane.fClusterState, lane.fAllowModification && lane.fGoodRows > 5, fRefit);
+		return kStepResult;
+	}
+	prop.GetErr2(err2Y, err2Z, param, lane.fZ, clusters[ihit].fRow, lane.fClusterState);
+	return kStepUpdate;
+}
+
+template <int N>
+void AliGPUTPCGMTrackFitLanes<N>::FinishMeasurement(int l, int retVal)
+{
+	Lane &lane = fLane[l];
+	AliGPUTPCGMTrackParam &trk = fTrk[l];
+	AliGPUTPCGMPropagator &prop = fProp[l];
+	const int wayDirection = (fIWay & 1) ? -1 : 1;
+
+	if (retVal == 0) // track is updated
+	{
+		lane.fLastUpdateX = trk.GetX();
+		lane.fCovYYUpd = trk.GetCov(0);
+		lane.fNMissed = lane.fNMissed2 = 0;
+		trk.UnmarkClusters(lane.fClusters, lane.fIHitMergeFirst, lane.fIHit, wayDirection, AliGPUTPCGMMergedTrackHit::flagNotFit);
+		lane.fN++;
+		lane.fIHitStart = lane.fIHit;
+		float dy = trk.GetY() - prop.Model().Y();
+		float dz = trk.GetZ() - prop.Model().Z();
+		if (CAMath::Abs(trk.GetQPt()) > 10 && --lane.fResetT0 <= 0 && CAMath::Abs(trk.GetSinPhi()) < 0.15f && dy * dy + dz * dz > 1)
+		{
+			prop.SetTrack(&trk, prop.GetAlpha());
+		}
+	}
+	else if (retVal == 2) // cluster far away form the track
+	{
+		if (lane.fAllowModification) trk.MarkClusters(lane.fClusters, lane.fIHitMergeFirst, lane.fIHit, wayDirection, AliGPUTPCGMMergedTrackHit::flagRejectDistance);
+		lane.fNMissed++;
+		lane.fNMissed2++;
+	}
+	else // bad chi2 for the whole track, stop the fit
+	{
+		lane.fInWay = false;
+		return;
+	}
+	lane.fIHit += wayDirection;
+}
+
+template <int N>
+void AliGPUTPCGMTrackFitLanes<N>::PropagateLanes(const int *mask, const float *posX, bool inFlyDirection, int *err)
+{
+	//AliGPUTPCGMPropagator::PropagateToXAlpha without rotation for all lanes in mask.
+	//The track states are copied to arrays with one entry per lane, all lanes are computed, and the results are copied back only
+	//for the lanes in mask and without error. Masked lanes get the state of the first active lane, so that they compute valid numbers.
+	int first = -1;
+	for (int l = 0;l < N;l++)
+	{
+		if (mask[l])
+		{
+			first = l;
+			break;
+		}
+	}
+	if (first == -1) return;
+
+	const float kMinPx = 1.f - GPUCA_MAX_SIN_PHI;
+	const bool fitInProjections = fProp[first].fFitInProjections;
+	const bool toyMC = fProp[first].fToyMCEvents;
+	const AliGPUTPCGMPolynomialField &field = *fProp[first].fField;
+
+	float x0[N], y0[N], z0[N], px0[N], py0[N], pz0[N], q0[N], sinPhi0[N], cosPhi0[N], secPhi0[N], dzDs0[N], qPt0[N], cs[N], sn[N], maxSinPhi[N], toX[N];
+	float p[5][N], c[15][N];
+	int ndf[N];
+	for (int l = 0;l < N;l++)
+	{
+		const int s = mask[l] ? l : first;
+		AliGPUTPCGMPhysicalTrackModel &t0 = fProp[s].fT0;
+		x0[l] = t0.X();
+		y0[l] = t0.Y();
+		z0[l] = t0.Z();
+		px0[l] = t0.Px();
+		py0[l] = t0.Py();
+		pz0[l] = t0.Pz();
+		q0[l] = t0.Q();
+		sinPhi0[l] = t0.SinPhi();
+		cosPhi0[l] = t0.CosPhi();
+		secPhi0[l] = t0.SecPhi();
+		dzDs0[l] = t0.DzDs();
+		qPt0[l] = t0.QPt();
+		cs[l] = fProp[s].fCosAlpha;
+		sn[l] = fProp[s].fSinAlpha;
+		maxSinPhi[l] = fProp[s].fMaxSinPhi;
+		toX[l] = posX[s];
+		for (int i = 0;i < 5;i++) p[i][l] = fTrk[s].GetPar(i);
+		for (int i = 0;i < 15;i++) c[i][l] = fTrk[s].GetCov(i);
+		ndf[l] = fTrk[s].GetNDF();
+	}
+
+	// field in local coordinates, AliGPUTPCGMPropagator::GetBxByBz
+	float bx[N], by[N], bz[N];
+	for (int l = 0;l < N;l++)
+	{
+		float bb[3];
+		field.GetField(x0[l] * cs[l] - y0[l] * sn[l], x0[l] * sn[l] + y0[l] * cs[l], z0[l], bb);
+		bx[l] = bb[0] * cs[l] + bb[1] * sn[l];
+		by[l] = -bb[0] * sn[l] + bb[1] * cs[l];
+		bz[l] = bb[2];
+	}
+
+	// propagate fT0 to t0e, AliGPUTPCGMPhysicalTrackModel::PropagateToXBxByBz
+	float xe[N], ye[N], ze[N], pxe[N], pye[N], pze[N], dLp[N];
+	float sinPhiE[N], cosPhiE[N], secPhiE[N], dzDsE[N], dlDsE[N], qPtE[N], pE[N], ptE[N];
+	int fail[N];
+	for (int l = 0;l < N;l++)
+	{
+		const float Bx = bx[l], By = by[l], Bz = bz[l];
+		float bt = CAMath::Sqrt(Bz * Bz + By * By);
+		float bb = CAMath::Sqrt(Bx * Bx + By * By + Bz * Bz);
+		const bool rotate = bt > 1.e-4f;
+		const float btd = rotate ? bt : 1.f, bbd = rotate ? bb : 1.f;
+		float c1 = rotate ? Bz / btd : 1.f;
+		float s1 = rotate ? By / btd : 0.f;
+		float c2 = rotate ? bt / bbd : 1.f;
+		float s2 = rotate ? -Bx / bbd : 0.f;
+
+		float R0[3] = {c2, s1 * s2, c1 * s2};
+		float R1[3] = {0, c1, -s1};
+		float R2[3] = {-s2, s1 * c2, c1 * c2};
+
+		float lx = x0[l], ly = y0[l], lz = z0[l], lpx = px0[l], lpy = py0[l], lpz = pz0[l];
+		float tx = R0[0] * lx + R0[1] * ly + R0[2] * lz;
+		float ty = R1[0] * lx + R1[1] * ly + R1[2] * lz;
+		float tz = R2[0] * lx + R2[1] * ly + R2[2] * lz;
+		float tpx = R0[0] * lpx + R0[1] * lpy + R0[2] * lpz;
+		float tpy = R1[0] * lpx + R1[1] * lpy + R1[2] * lpz;
+		float tpz = R2[0] * lpx + R2[1] * lpy + R2[2] * lpz;
+
+		float dx = toX[l] - x0[l];
+		float xr = tx + dx;
+
+		// transport in the rotated coordinate system, PropagateToXBzLightNoUpdate
+		bool bad = false;
+		float dLpl = 0.f;
+		{
+			if (tpx < kMinPx) tpx = kMinPx;
+			float b = q0[l] * bb;
+			float pt2 = tpx * tpx + tpy * tpy;
+			float dxl = xr - tx;
+			float pyel = tpy - dxl * b;
+			float pxe2 = pt2 - pyel * pyel;
+			bad |= tpx < kMinPx || pxe2 < kMinPx * kMinPx;
+			float pxel = CAMath::Sqrt(bad ? 1.f : pxe2);
+			float pti = 1.f / CAMath::Sqrt(pt2);
+			float tyl = (tpy + pyel) / (tpx + pxel);
+			float dyl = dxl * tyl;
+			float chord = dxl * CAMath::Sqrt(1.f + tyl * tyl);
+			float sa = 0.5f * chord * b * pti;
+			float sa2 = sa * sa;
+			const float k2 = 1.f / 6.f;
+			const float k4 = 3.f / 40.f;
+			float dS = chord + chord * sa2 * (k2 + k4 * sa2);
+			dLpl = pti * dS;
+			tz += tpz * dLpl;
+			tx = xr;
+			ty += dyl;
+			tpx = pxel;
+			tpy = pyel;
+		}
+
+		// rotate back
+		lx = tx, ly = ty, lz = tz, lpx = tpx, lpy = tpy, lpz = tpz;
+		tx = R0[0] * lx + R1[0] * ly + R2[0] * lz;
+		ty = R0[1] * lx + R1[1] * ly + R2[1] * lz;
+		tz = R0[2] * lx + R1[2] * ly + R2[2] * lz;
+		tpx = R0[0] * lpx + R1[0] * lpy + R2[0] * lpz;
+		tpy = R0[1] * lpx + R1[1] * lpy + R2[1] * lpz;
+		tpz = R0[2] * lpx + R1[2] * lpy + R2[2] * lpz;
+
+		// the small additional step to X=x in Bz
+		{
+			if (tpx < kMinPx) tpx = kMinPx;
+			float b = q0[l] * Bz;
+			float pt2 = tpx * tpx + tpy * tpy;
+			float dxl = toX[l] - tx;
+			float pyel = tpy - dxl * b;
+			float pxe2 = pt2 - pyel * pyel;
+			bad |= tpx < kMinPx || pxe2 < kMinPx * kMinPx;
+			float pxel = CAMath::Sqrt(bad ? 1.f : pxe2);
+			float pti = 1.f / CAMath::Sqrt(pt2);
+			float tyl = (tpy + pyel) / (tpx + pxel);
+			float dyl = dxl * tyl;
+			float chord = dxl * CAMath::Sqrt(1.f + tyl * tyl);
+			float sa = 0.5f * chord * b * pti;
+			float sa2 = sa * sa;
+			const float k2 = 1.f / 6.f;
+			const float k4 = 3.f / 40.f;
+			float dS = chord + chord * sa2 * (k2 + k4 * sa2);
+			float ddLp = pti * dS;
+			dLpl += ddLp;
+			tz += tpz * ddLp;
+			tx = toX[l];
+			ty += dyl;
+			tpx = pxel;
+			tpy = pyel;
+		}
+
+		// AliGPUTPCGMPhysicalTrackModel::UpdateValues
+		float px = tpx;
+		if (CAMath::Abs(px) < 1.e-4f) px = copysign(1.e-4f, px);
+		float pt = CAMath::Sqrt(px * px + tpy * tpy);
+		float pti = 1.f / pt;
+		float pp = CAMath::Sqrt(px * px + tpy * tpy + tpz * tpz);
+
+		xe[l] = tx;
+		ye[l] = ty;
+		ze[l] = tz;
+		pxe[l] = tpx;
+		pye[l] = tpy;
+		pze[l] = tpz;
+		ptE[l] = pt;
+		pE[l] = pp;
+		sinPhiE[l] = tpy * pti;
+		cosPhiE[l] = px * pti;
+		secPhiE[l] = pt / px;
+		dzDsE[l] = tpz * pti;
+		dlDsE[l] = pp * pti;
+		qPtE[l] = q0[l] * pti;
+		dLp[l] = dLpl;
+		fail[l] = bad;
+	}
+
+	// lanes which cannot be transported with the full field use the fallbacks of the scalar code, the others check the result
+	for (int l = 0;l < N;l++)
+	{
+		if (!mask[l]) continue;
+		if (fail[l])
+		{
+			err[l] = fProp[l].PropagateToXAlpha(posX[l], fProp[l].fAlpha, inFlyDirection);
+			continue;
+		}
+		err[l] = CAMath::Abs(sinPhiE[l]) >= maxSinPhi[l] ? -3 : 0;
+		if (err[l] == 0 && fProp[l].fMaterialLUT)
+		{
+			AliGPUTPCGMPhysicalTrackModel t0e;
+			t0e.X() = xe[l];
+			t0e.Y() = ye[l];
+			t0e.Z() = ze[l];
+			fProp[l].UpdateMaterial(t0e);
+		}
+	}
+
+	float dLMax[N], eP2[N], sigmadE2[N], k22[N], k33[N], k43[N], k44[N];
+	for (int l = 0;l < N;l++)
+	{
+		const AliGPUTPCGMPropagator::MaterialCorrection &m = fProp[mask[l] ? l : first].fMaterial;
+		dLMax[l] = m.fDLMax;
+		eP2[l] = m.fEP2;
+		sigmadE2[l] = m.fSigmadE2;
+		k22[l] = toyMC ? 0.f : m.fK22; //no multiple scattering for the toy MC, without a branch in the vectorized loop
+		k33[l] = toyMC ? 0.f : m.fK33;
+		k43[l] = toyMC ? 0.f : m.fK43;
+		k44[l] = toyMC ? 0.f : m.fK44;
+	}
+
+	// propagate track and cov matrix with derivatives for (0,0,Bz) field
+	const float dLSign = inFlyDirection ? -1.f : 1.f; //the branch on inFlyDirection inside the loop would prevent the vectorization
+	int ret[N];
+	for (int l = 0;l < N;l++)
+	{
+		float dS = dLp[l] * ptE[l];
+		float dL = dLSign * CAMath::Abs(dLp[l] * pE[l]);
+
+		float ey = sinPhi0[l];
+		float ex = cosPhi0[l];
+		float exi = secPhi0[l];
+		float ey1 = sinPhiE[l];
+		float ex1 = cosPhiE[l];
+		float ex1i = secPhiE[l];
+
+		float Bz = bz[l];
+		float k = -qPt0[l] * Bz;
+		float dx = toX[l] - x0[l];
+		float kdx = k * dx;
+		float cc = ex + ex1;
+		float cci = 1.f / cc;
+
+		float dxcci = dx * cci;
+		float hh = dxcci * ex1i * (1.f + ex * ex1 + ey * ey1);
+
+		float j02 = exi * hh;
+		float j04 = -Bz * dxcci * hh;
+		float j13 = dS;
+		float j24 = -dx * Bz;
+
+		float d0 = p[0][l] - y0[l];
+		float d1 = p[1][l] - z0[l];
+		float d2 = p[2][l] - sinPhi0[l];
+		float d3 = p[3][l] - dzDs0[l];
+		float d4 = p[4][l] - qPt0[l];
+
+		float newSinPhi = ey1 + d2 + j24 * d4;
+		const int bad4 = (ndf[l] >= 15) & (CAMath::Abs(newSinPhi) > GPUCA_MAX_SIN_PHI); //int masks and & instead of bool and &&, which the vectorizer cannot mix
+
+		p[0][l] = ye[l] + d0 + j02 * d2 + j04 * d4;
+		p[1][l] = ze[l] + d1 + j13 * d3;
+		p[2][l] = newSinPhi;
+		p[3][l] = dzDsE[l] + d3;
+		p[4][l] = qPtE[l] + d4;
+
+		float c00 = c[0][l];
+		float c10 = c[1][l];
+		float c11 = c[2][l];
+		float c20 = c[3][l];
+		float c21 = c[4][l];
+		float c22 = c[5][l];
+		float c30 = c[6][l];
+		float c31 = c[7][l];
+		float c32 = c[8][l];
+		float c33 = c[9][l];
+		float c40 = c[10][l];
+		float c41 = c[11][l];
+		float c42 = c[12][l];
+		float c43 = c[13][l];
+		float c44 = c[14][l];
+
+		// both variants are computed, the projection one is used for fitInProjections or before the first update
+		const int projection = fitInProjections | (ndf[l] <= 0);
+		float n[15];
+		{
+			float c20ph04c42 = c20 + j04 * c42;
+			float j02c22 = j02 * c22;
+			float j04c44 = j04 * c44;
+
+			float n6 = c30 + j02 * c32 + j04 * c43;
+			float n7 = c31 + j13 * c33;
+			float n10 = c40 + j02 * c42 + j04c44;
+			float n11 = c41 + j13 * c43;
+			float n12 = c42 + j24 * c44;
+
+			n[0] = c00 + (j02 * j02c22 + j04 * j04c44 + 2.f * (j02 * c20ph04c42 + j04 * c40));
+			n[1] = c10 + (j02 * c21 + j04 * c41 + j13 * n6);
+			n[2] = c11 + (j13 * (c31 + n7));
+			n[3] = c20ph04c42 + j02c22 + j24 * n10;
+			n[4] = c21 + j13 * c32 + j24 * n11;
+			n[5] = c22 + j24 * (c42 + n12);
+			n[6] = n6;
+			n[7] = n7;
+			n[8] = c32 + c43 * j24;
+			n[10] = n10;
+			n[11] = n11;
+			n[12] = n12;
+		}
+		int badXX;
+		{
+			float ss = ey + ey1;
+			float tg = ss * cci;
+			float xx = 1.f - 0.25f * kdx * kdx * (1.f + tg * tg);
+			badXX = xx < 1.e-8f;
+			xx = CAMath::Sqrt(badXX ? 1.f : xx);
+			float yy = CAMath::Sqrt(ss * ss + cc * cc);
+
+			float j12 = dx * dzDs0[l] * tg * (2.f + tg * (ey * exi + ey1 * ex1i)) / (xx * yy);
+			const int largeQPt = CAMath::Abs(qPt0[l]) > 1.e-6f;
+			float j14a = (2.f * xx * ex1i * dx / yy - dS) * dzDs0[l] / (largeQPt ? qPt0[l] : 1.f);
+			float j14b = -dzDs0[l] * Bz * dx * dx * exi * exi * exi * (0.5f * ey + (1.f / 3.f) * kdx * (1 + 2.f * ey * ey) * exi * exi);
+			float j14 = largeQPt ? j14a : j14b;
+
+			float h00 = c00 + c20 * j02 + c40 * j04;
+			float h02 = c20 + c22 * j02 + c42 * j04;
+			float h04 = c40 + c42 * j02 + c44 * j04;
+
+			float h10 = c10 + c20 * j12 + c30 * j13 + c40 * j14;
+			float h11 = c11 + c21 * j12 + c31 * j13 + c41 * j14;
+			float h12 = c21 + c22 * j12 + c32 * j13 + c42 * j14;
+			float h13 = c31 + c32 * j12 + c33 * j13 + c43 * j14;
+			float h14 = c41 + c42 * j12 + c43 * j13 + c44 * j14;
+
+			float h20 = c20 + c40 * j24;
+			float h21 = c21 + c41 * j24;
+			float h22 = c22 + c42 * j24;
+			float h23 = c32 + c43 * j24;
+			float h24 = c42 + c44 * j24;
+
+			p[1][l] = projection ? p[1][l] : p[1][l] + (j12 * d2 + j14 * d4);
+			n[0] = projection ? n[0] : h00 + h02 * j02 + h04 * j04;
+			n[1] = projection ? n[1] : h10 + h12 * j02 + h14 * j04;
+			n[2] = projection ? n[2] : h11 + h12 * j12 + h13 * j13 + h14 * j14;
+			n[3] = projection ? n[3] : h20 + h22 * j02 + h24 * j04;
+			n[4] = projection ? n[4] : h21 + h22 * j12 + h23 * j13 + h24 * j14;
+			n[5] = projection ? n[5] : h22 + h24 * j24;
+			n[6] = projection ? n[6] : c30 + c32 * j02 + c43 * j04;
+			n[7] = projection ? n[7] : c31 + c32 * j12 + c33 * j13 + c43 * j14;
+			n[8] = projection ? n[8] : c32 + c43 * j24;
+			n[10] = projection ? n[10] : c40 + c42 * j02 + c44 * j04;
+			n[11] = projection ? n[11] : c41 + c42 * j12 + c43 * j13 + c44 * j14;
+			n[12] = projection ? n[12] : c42 + c44 * j24;
+		}
+		n[9] = c33;
+		n[13] = c43;
+		n[14] = c44;
+
+		// Energy Loss
+		float dLmask = CAMath::Abs(dL) < dLMax[l] ? dL : 0.f;
+		float dLabs = CAMath::Abs(dLmask);
+		float corr = 1.f - eP2[l] * dLmask;
+		float corrInv = 1.f / corr;
+		pxe[l] *= corrInv;
+		pye[l] *= corrInv;
+		pze[l] *= corrInv;
+		ptE[l] *= corrInv;
+		pE[l] *= corrInv;
+		qPtE[l] *= corr;
+
+		p[4][l] *= corr;
+
+		n[10] *= corr;
+		n[11] *= corr;
+		n[12] *= corr;
+		n[13] *= corr;
+		n[14] = n[14] * corr * corr + dLabs * sigmadE2[l];
+
+		//  Multiple Scattering
+		n[5] += dLabs * k22[l] * cosPhiE[l] * cosPhiE[l];
+		n[9] += dLabs * k33[l];
+		n[13] += dLabs * k43[l];
+		n[14] += dLabs * k44[l];
+
+		for (int i = 0;i < 15;i++) c[i][l] = n[i];
+		ret[l] = bad4 ? -4 : (badXX & !projection) ? -1 : 0;
+	}
+
+	// copy back, the rare error -1 modifies the state only partially, it is repeated by the scalar code
+	for (int l = 0;l < N;l++)
+	{
+		if (!mask[l] || fail[l] || err[l]) continue;
+		if (ret[l] == -1)
+		{
+			err[l] = fProp[l].PropagateToXAlpha(posX[l], fProp[l].fAlpha, inFlyDirection);
+			continue;
+		}
+		err[l] = ret[l];
+		if (err[l]) continue;
+		AliGPUTPCGMPhysicalTrackModel &t0 = fProp[l].fT0;
+		t0.X() = xe[l];
+		t0.Y() = ye[l];
+		t0.Z() = ze[l];
+		t0.Px() = pxe[l];
+		t0.Py() = pye[l];
+		t0.Pz() = pze[l];
+		t0.SinPhi() = sinPhiE[l];
+		t0.CosPhi() = cosPhiE[l];
+		t0.SecPhi() = secPhiE[l];
+		t0.DzDs() = dzDsE[l];
+		t0.DlDs() = dlDsE[l];
+		t0.QPt() = qPtE[l];
+		t0.P() = pE[l];
+		t0.Pt() = ptE[l];
+		fTrk[l].X() = xe[l];
+		for (int i = 0;i < 5;i++) fTrk[l].Par()[i] = p[i][l];
+		for (int i = 0;i < 15;i++) fTrk[l].Cov()[i] = c[i][l];
+	}
+}
+
+template <int N>
+void AliGPUTPCGMTrackFitLanes<N>::UpdateLanes(const int *mask, const float *posY, const float *posZ, const float *err2Y, const float *err2Z, const int *clusterState, const int *rejectChi2, int *retVal)
+{
+	//AliGPUTPCGMPropagator::Update for all lanes in mask, with the same masking as in PropagateLanes
+	int first = -1;
+	for (int l = 0;l < N;l++)
+	{
+		if (mask[l])
+		{
+			first = l;
+			break;
+		}
+	}
+	if (first == -1) return;
+
+	const bool fitInProjections = fProp[first].fFitInProjections;
+	const int flagsRejectTight = AliGPUTPCGMMergedTrackHit::flagSplit | AliGPUTPCGMMergedTrackHit::flagShared;
+	const int flagsRejectEdge = AliGPUTPCGMMergedTrackHit::flagEdge | AliGPUTPCGMMergedTrackHit::flagSingle;
+
+	float y[N], z[N], ey[N], ez[N], chi2[N];
+	float p[5][N], c[15][N];
+	int ndf[N], state[N], reject[N];
+	for (int l = 0;l < N;l++)
+	{
+		const int s = mask[l] ? l : first;
+		y[l] = posY[s];
+		z[l] = posZ[s];
+		ey[l] = err2Y[s];
+		ez[l] = err2Z[s];
+		state[l] = clusterState[s];
+		reject[l] = fProp[s].fSpecialErrors && rejectChi2[s];
+		for (int i = 0;i < 5;i++) p[i][l] = fTrk[s].GetPar(i);
+		for (int i = 0;i < 15;i++) c[i][l] = fTrk[s].GetCov(i);
+		chi2[l] = fTrk[s].GetChi2();
+		ndf[l] = fTrk[s].GetNDF();
+	}
+
+	int ret[N];
+	for (int l = 0;l < N;l++)
+	{
+		float d00 = c[0][l], d01 = c[1][l], d02 = c[3][l], d03 = c[6][l], d04 = c[10][l];
+		float d10 = c[1][l], d11 = c[2][l], d12 = c[4][l], d13 = c[7][l], d14 = c[11][l];
+
+		float z0 = y[l] - p[0][l];
+		float z1 = z[l] - p[1][l];
+
+		// both variants are computed like in PropagateLanes
+		const int projection = fitInProjections | (ndf[l] <= 0);
+		float w0, w1, w2, chiY, chiZ;
+		int badDet;
+		{
+			float v0 = d11 + ez[l], v1 = d10, v2 = d00 + ey[l];
+			float det = v0 * v2 - v1 * v1;
+			badDet = CAMath::Abs(det) < 1.e-10f;
+			det = 1.f / (badDet ? 1.f : det);
+			float pw0 = 1.f / (ey[l] + d00);
+			float pw2 = 1.f / (ez[l] + d11);
+			w0 = projection ? pw0 : v0 * det;
+			w1 = projection ? 0.f : -v1 * det;
+			w2 = projection ? pw2 : v2 * det;
+			chiY = projection ? w0 * z0 * z0 : CAMath::Abs((w0 * z0 + w1 * z1) * z0);
+			chiZ = projection ? w2 * z1 * z1 : CAMath::Abs((w1 * z0 + w2 * z1) * z1);
+		}
+		float dChi2 = chiY + chiZ;
+		const int rejected = (chiY > 9.f) | (chiZ > 9.f) | (((chiY > 6.25f) | (chiZ > 6.25f)) & ((state[l] & flagsRejectTight) != 0)) | (((chiY > 1.f) | (chiZ > 6.25f)) & ((state[l] & flagsRejectEdge) != 0));
+		ret[l] = (badDet & !projection) ? -1 : (reject[l] & rejected) ? 2 : 0;
+
+		chi2[l] += dChi2;
+		ndf[l] += 2;
+
+		// both variants of the gain are computed as well, the projection one for fitInProjections or up to the first 2D update
+		const int projectionK = fitInProjections | (ndf[l] <= 0);
+		float np[5], n[15];
+		for (int i = 0;i < 15;i++) n[i] = c[i][l];
+		{
+			float k00 = d00 * w0;
+			float k20 = d02 * w0;
+			float k40 = d04 * w0;
+			float k11 = d11 * w2;
+			float k31 = d13 * w2;
+			np[0] = p[0][l] + k00 * z0;
+			np[1] = p[1][l] + k11 * z1;
+			np[2] = p[2][l] + k20 * z0;
+			np[3] = p[3][l] + k31 * z1;
+			np[4] = p[4][l] + k40 * z0;
+
+			n[0] -= k00 * d00;
+			n[2] -= k11 * d11;
+			n[3] -= k20 * d00;
+			n[5] -= k20 * d02;
+			n[7] -= k31 * d11;
+			n[9] -= k31 * d13;
+			n[10] -= k00 * d04;
+			n[12] -= k40 * d02;
+			n[14] -= k40 * d04;
+		}
+		{
+			float k00 = d00 * w0 + d01 * w1;
+			float k01 = d00 * w1 + d10 * w2;
+			float k10 = d01 * w0 + d11 * w1;
+			float k11 = d01 * w1 + d11 * w2;
+			float k20 = d02 * w0 + d12 * w1;
+			float k21 = d02 * w1 + d12 * w2;
+			float k30 = d03 * w0 + d13 * w1;
+			float k31 = d03 * w1 + d13 * w2;
+			float k40 = d04 * w0 + d14 * w1;
+			float k41 = d04 * w1 + d14 * w2;
+
+			np[0] = projectionK ? np[0] : p[0][l] + (k00 * z0 + k01 * z1);
+			np[1] = projectionK ? np[1] : p[1][l] + (k10 * z0 + k11 * z1);
+			np[2] = projectionK ? np[2] : p[2][l] + (k20 * z0 + k21 * z1);
+			np[3] = projectionK ? np[3] : p[3][l] + (k30 * z0 + k31 * z1);
+			np[4] = projectionK ? np[4] : p[4][l] + (k40 * z0 + k41 * z1);
+
+			//The scalar code updates the off-diagonal block only for ndf >= 0, which always holds in this variant
+			n[0] = projectionK ? n[0] : c[0][l] - (k00 * d00 + k01 * d10);
+			n[1] = projectionK ? n[1] : c[1][l] - (k10 * d00 + k11 * d10);
+			n[2] = projectionK ? n[2] : c[2][l] - (k10 * d01 + k11 * d11);
+			n[3] = projectionK ? n[3] : c[3][l] - (k20 * d00 + k21 * d10);
+			n[4] = projectionK ? n[4] : c[4][l] - (k20 * d01 + k21 * d11);
+			n[5] = projectionK ? n[5] : c[5][l] - (k20 * d02 + k21 * d12);
+			n[6] = projectionK ? n[6] : c[6][l] - (k30 * d00 + k31 * d10);
+			n[7] = projectionK ? n[7] : c[7][l] - (k30 * d01 + k31 * d11);
+			n[8] = projectionK ? n[8] : c[8][l] - (k30 * d02 + k31 * d12);
+			n[9] = projectionK ? n[9] : c[9][l] - (k30 * d03 + k31 * d13);
+			n[10] = projectionK ? n[10] : c[10][l] - (k40 * d00 + k41 * d10);
+			n[11] = projectionK ? n[11] : c[11][l] - (k40 * d01 + k41 * d11);
+			n[12] = projectionK ? n[12] : c[12][l] - (k40 * d02 + k41 * d12);
+			n[13] = projectionK ? n[13] : c[13][l] - (k40 * d03 + k41 * d13);
+			n[14] = projectionK ? n[14] : c[14][l] - (k40 * d04 + k41 * d14);
+		}
+		for (int i = 0;i < 5;i++) p[i][l] = np[i];
+		for (int i = 0;i < 15;i++) c[i][l] = n[i];
+	}
+
+	for (int l = 0;l < N;l++)
+	{
+		if (!mask[l]) continue;
+		retVal[l] = ret[l];
+		if (ret[l]) continue;
+		for (int i = 0;i < 5;i++) fTrk[l].Par()[i] = p[i][l];
+		for (int i = 0;i < 15;i++) fTrk[l].Cov()[i] = c[i][l];
+		fTrk[l].Chi2() = chi2[l];
+		fTrk[l].NDF() = ndf[l];
+	}
+}
+
+template class AliGPUTPCGMTrackFitLanes<4>;
+template class AliGPUTPCGMTrackFitLanes<8>;
+template class AliGPUTPCGMTrackFitLanes<16>;
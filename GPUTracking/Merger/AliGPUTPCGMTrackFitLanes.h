@@ -0,0 +1,89 @@
+//-*- Mode: C++ -*-
+//*************************************************************************
+// This file is property of and copyright by the ALICE HLT Project        *
+// ALICE Experiment at CERN, All rights reserved.                         *
+// See cxx source for full Copyright notice                               *
+//                                                                        *
+//*************************************************************************
+
+#ifndef AliGPUTPCGMTrackFitLanes_H
+#define AliGPUTPCGMTrackFitLanes_H
+
+#include "AliGPUTPCGMTrackParam.h"
+#include "AliGPUTPCGMPropagator.h"
+
+class AliGPUTPCGMMerger;
+class AliGPUTPCGMMergedTrack;
+class AliGPUTPCGMMergedTrackHit;
+
+/**
+ * @class AliGPUTPCGMTrackFitLanes
+ *
+ * CPU refit of up to N merged tracks in lock-step, one track per SIMD lane.
+ * All lanes run the same way of the fit together and advance by one measurement per step. The propagation to the X of the
+ * measurement and the Kalman filter update are computed for all lanes at once on structure-of-arrays copies of the track
+ * states, lanes without a measurement in the step are masked. The decisions between the steps (cluster rejection, double-row
+ * merging, attachment, rotations to another sector, error checks) use the scalar code of AliGPUTPCGMTrackParam per lane, so
+ * the result agrees with AliGPUTPCGMTrackParam::RefitTrack within float rounding.
+ * Only tracks with all clusters in one leg and on one side of the central electrode are packed, they never follow a looper
+ * or cross the central electrode. The other tracks and failed first attempts are refit with the scalar code.
+ */
+template <int N>
+class AliGPUTPCGMTrackFitLanes
+{
+  public:
+	/// Whether the track can be refit in a lane, otherwise it needs AliGPUTPCGMTrackParam::RefitTrack
+	static bool Eligible(const AliGPUTPCGMMergedTrack &track, const AliGPUTPCGMMergedTrackHit *clusters);
+
+	/// Refit nTracks <= N tracks, the eligible ones in lanes, the others one by one
+	static void RefitTracks(AliGPUTPCGMMerger &merger, const unsigned int *trackIds, int nTracks);
+
+  private:
+	/// Scalar fit state of a lane, the same variables as in AliGPUTPCGMTrackParam::Fit
+	struct Lane
+	{
+		AliGPUTPCGMMergedTrack *fTrack;
+		AliGPUTPCGMMergedTrackHit *fClusters;
+		int fITrk;
+		int fMaxN, fN, fNTolerated;
+		float fAlpha;
+		int fIHitStart, fIHit, fIHitMergeFirst;
+		int fNMissed, fNMissed2, fGoodRows, fResetT0;
+		float fCovYYUpd, fLastUpdateX;
+		unsigned char fLastRow, fLastSlice;
+		bool fInWay; // the lane has measurements left in the current way
+		bool fAllowModification;
+		float fX, fY, fZ; // current measurement
+		unsigned char fClusterState;
+	};
+
+	AliGPUTPCGMTrackFitLanes() {}
+
+	/// What a lane does in the current step of the lock-step loop
+	enum Step
+	{
+		kStepNone = 0,       ///< no measurement in this step
+		kStepPropagate = 1,  ///< propagation in the lanes
+		kStepPropagated = 2, ///< propagated by the scalar code (rotation)
+		kStepUpdate = 3,     ///< filter update in the lanes
+		kStepResult = 4      ///< update result known from the scalar code
+	};
+
+	void Fit(AliGPUTPCGMMerger &merger, int nLanes);
+	int NextMeasurement(const AliGPUTPCGMMerger &merger, int l, int &err);
+	int CheckPropagation(const AliGPUTPCGMMerger &merger, int l, int err, float &err2Y, float &err2Z, int &retVal);
+	void FinishMeasurement(int l, int retVal);
+
+	void PropagateLanes(const int *mask, const float *posX, bool inFlyDirection, int *err);
+	void UpdateLanes(const int *mask, const float *posY, const float *posZ, const float *err2Y, const float *err2Z, const int *clusterState, const int *rejectChi2, int *retVal);
+
+	int fNWays, fIWay; // current way, the same for all lanes
+	bool fRefit;
+	float fMaxSinForUpdate;
+
+	AliGPUTPCGMTrackParam fTrk[N];
+	AliGPUTPCGMPropagator fProp[N];
+	Lane fLane[N];
+};
+
+#endif
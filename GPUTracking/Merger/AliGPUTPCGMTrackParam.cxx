@@ -50,7 +50,7 @@ static constexpr float kRadLen = 29.532f;//28.94;
 static constexpr float kDeg2Rad = M_PI / 180.f;
 static constexpr float kSectAngle = 2 * M_PI / 18.f;
 
-GPUd() bool AliGPUTPCGMTrackParam::Fit(const AliGPUTPCGMMerger *merger, int iTrk, AliGPUTPCGMMergedTrackHit *clusters, int &N, int &NTolerated, float &Alpha, int attempt, float maxSinPhi, AliGPUTPCOuterParam *outerParam)
+GPUd() bool AliGPUTPCGMTrackParam::Fit(const AliGPUTPCGMMerger *merger, int iTrk, AliGPUTPCGMMergedTrackHit *clusters, int &N, int &NTolerated, float &Alpha, int attempt, float maxSinPhi, AliGPUTPCOuterParam *outerParam, int *looperBudget)
 {
 	const AliGPUParam &param = merger->SliceParam();
 
@@ -58,6 +58,7 @@ GPUd() bool AliGPUTPCGMTrackParam::Fit(const AliGPUTPCGMMerger *merger, int iTrk
 
 	AliGPUTPCGMPropagator prop;
 	prop.SetMaterial(kRadLen, kRho);
+	prop.SetMaterialLUT(merger->MaterialLUT());
 	prop.SetPolynomialField(merger->pField());
 	prop.SetMaxSinPhi(maxSinPhi);
 	prop.SetToyMCEventsFlag(param.ToyMCEventsFlag);
@@ -136,11 +137,11 @@ GPUd() bool AliGPUTPCGMTrackParam::Fit(const AliGPUTPCGMMerger *merger, int iTrk
 		bool changeDirection = (clusters[ihit].fLeg - lastLeg) & 1;
 		CADEBUG(if(changeDirection) printf("\t\tChange direction\n");)
 		CADEBUG(printf("\tLeg %3d%14sTrack   Alpha %8.3f %s, X %8.3f - Y %8.3f, Z %8.3f   -   QPt %7.2f (%7.2f), SP %5.2f (%5.2f) %28s    ---   Cov sY %8.3f sZ %8.3f sSP %8.3f sPt %8.3f   -   YPt %8.3f\n", (int) clusters[ihit].fLeg, "", prop.GetAlpha(), (CAMath::Abs(prop.GetAlpha() - clAlpha) < 0.01 ? "   " : " R!"), fX, fP[0], fP[1], fP[4], prop.GetQPt0(), fP[2], prop.GetSinPhi0(), "", sqrtf(fC[0]), sqrtf(fC[2]), sqrtf(fC[5]), sqrtf(fC[14]), fC[10]);)
-		if (allowModification && changeDirection && !noFollowCircle && !noFollowCircle2)
+		if (allowModification && changeDirection && !noFollowCircle && !noFollowCircle2 && !(looperBudget && *looperBudget < 0))
 		{
 			const AliGPUTPCGMTrackParam backup = *this;
 			const float backupAlpha = prop.GetAlpha();
-			if (lastRow != 255 && FollowCircle(merger, prop, lastSlice, lastRow, iTrk, clusters[ihit].fLeg == clusters[maxN - 1].fLeg, clAlpha, xx, yy, clusters[ihit].fSlice, clusters[ihit].fRow, inFlyDirection))
+			if (lastRow != 255 && (FollowCircle(merger, prop, lastSlice, lastRow, iTrk, clusters[ihit].fLeg == clusters[maxN - 1].fLeg, clAlpha, xx, yy, clusters[ihit].fSlice, clusters[ihit].fRow, inFlyDirection, looperBudget) || !UseLooperBudget(looperBudget)))
 			{
 				CADEBUG(printf("Error during follow circle, resetting track!\n");)
 				*this = backup;
@@ -188,10 +189,10 @@ GPUd() bool AliGPUTPCGMTrackParam::Fit(const AliGPUTPCGMMerger *merger, int iTrk
 		{
 			const float mirrordY = prop.GetMirroredYTrack();
 			CADEBUG(printf(" -- MiroredY: %f --> %f", fP[0], mirrordY);)
-			if (CAMath::Abs(yy - fP[0]) > CAMath::Abs(yy - mirrordY))
+			if (CAMath::Abs(yy - fP[0]) > CAMath::Abs(yy - mirrordY) && UseLooperBudget(looperBudget))
 			{
 				CADEBUG(printf(" - Mirroring!!!");)
-				if (allowModification) AttachClustersMirror(merger, clusters[ihit].fSlice, clusters[ihit].fRow, iTrk, yy, prop); //Never true, will always call FollowCircle above
+				if (allowModification) AttachClustersMirror(merger, clusters[ihit].fSlice, clusters[ihit].fRow, iTrk, yy, prop, looperBudget); //Only if FollowCircle above failed or was skipped
 				MirrorTo(prop, yy, zz, inFlyDirection, param, clusters[ihit].fRow, clusterState, true);
 				noFollowCircle = false;
 
@@ -255,6 +256,11 @@ GPUd() bool AliGPUTPCGMTrackParam::Fit(const AliGPUTPCGMMerger *merger, int iTrk
 		}
 		if (((nWays - iWay) & 1)) ShiftZ(merger->pField(), clusters, param, N);
 	}
+	return FinishFit(prop, param, N, NTolerated, covYYUpd, Alpha);
+}
+
+GPUd() bool AliGPUTPCGMTrackParam::FinishFit(AliGPUTPCGMPropagator &prop, const AliGPUParam &param, int N, int NTolerated, float covYYUpd, float &Alpha)
+{
 	ConstrainSinPhi();
 
 	bool ok = N + NTolerated >= TRACKLET_SELECTOR_MIN_HITS(fP[4]) && CheckNumericalQuality(covYYUpd);
@@ -433,7 +439,7 @@ GPUd() bool AliGPUTPCGMTrackParam::FollowCircleChk(float lrFactor, float toY, fl
 	       (up ? (-fP[0] * lrFactor > toX || (right ^ (fP[2] > 0))) : (-fP[0] * lrFactor < toX || (right ^ (fP[2] < 0)))); //don't overshoot in X
 }
 
-GPUd() int AliGPUTPCGMTrackParam::FollowCircle(const AliGPUTPCGMMerger *Merger, AliGPUTPCGMPropagator &prop, int slice, int iRow, int iTrack, bool goodLeg, float toAlpha, float toX, float toY, int toSlice, int toRow, bool inFlyDirection)
+GPUd() int AliGPUTPCGMTrackParam::FollowCircle(const AliGPUTPCGMMerger *Merger, AliGPUTPCGMPropagator &prop, int slice, int iRow, int iTrack, bool goodLeg, float toAlpha, float toX, float toY, int toSlice, int toRow, bool inFlyDirection, int *looperBudget)
 {
 	if (Merger->SliceParam().rec.DisableRefitAttachment & 4) return 1;
 	const AliGPUParam &param = Merger->SliceParam();
@@ -459,6 +465,11 @@ GPUd() int AliGPUTPCGMTrackParam::FollowCircle(const AliGPUTPCGMMerger *Merger,
 	{
 		while ((slice != toSlice) ? (CAMath::Abs(fX) <= CAMath::Abs(fP[0]) * CAMath::Tan(kSectAngle / 2.f)) : FollowCircleChk(lrFactor, toY, toX, up, right))
 		{
+			if (!UseLooperBudget(looperBudget)) //The caller resets the track and does not follow further loops
+			{
+				prop.RotateToAlpha(prop.GetAlpha() - (M_PI / 2.f) * lrFactor);
+				return 1;
+			}
 			int err = prop.PropagateToXAlpha(fX + 1.f, prop.GetAlpha(), inFlyDirection);
 			if (err)
 			{
@@ -520,7 +531,18 @@ GPUd() int AliGPUTPCGMTrackParam::FollowCircle(const AliGPUTPCGMMerger *Merger,
 	return(0);
 }
 
-GPUd() void AliGPUTPCGMTrackParam::AttachClustersMirror(const AliGPUTPCGMMerger* Merger, int slice, int iRow, int iTrack, float toY, AliGPUTPCGMPropagator& prop)
+GPUd() bool AliGPUTPCGMTrackParam::UseLooperBudget(int *looperBudget)
+{
+	//Take one step of loop following (circle propagation, mirroring, mirrored attachment) from the budget, nullptr for unlimited
+	//Once the budget is used up, it is marked as exceeded (-1) and every further step is refused
+	if (looperBudget == 0) return true;
+	if ((*looperBudget)-- > 0) return true;
+	CADEBUG(printf("looper budget exceeded\n");)
+	*looperBudget = -1;
+	return false;
+}
+
+GPUd() void AliGPUTPCGMTrackParam::AttachClustersMirror(const AliGPUTPCGMMerger* Merger, int slice, int iRow, int iTrack, float toY, AliGPUTPCGMPropagator& prop, int *looperBudget)
 {
 	if (Merger->SliceParam().rec.DisableRefitAttachment & 8) return;
 	float X = fP[2] > 0 ? fP[0] : -fP[0];
@@ -540,6 +562,7 @@ GPUd() void AliGPUTPCGMTrackParam::AttachClustersMirror(const AliGPUTPCGMMerger*
 	//printf("X %f Y %f Z %f SinPhi %f, count %d dx %f (to: %f)\n", X, Y, Z, SinPhi, count, dx, X + count * dx);
 	while (count--)
 	{
+		if (!UseLooperBudget(looperBudget)) return;
 		float ex = CAMath::Sqrt(1 - SinPhi * SinPhi);
 		float exi = 1.f / ex;
 		float dxBzQ = dx * -b * fP[4];
@@ -681,41 +704,53 @@ void AliGPUTPCGMTrackParam::SetExtParam( const AliExternalTrackParam &T )
 }
 #endif
 
-GPUd() void AliGPUTPCGMTrackParam::RefitTrack(AliGPUTPCGMMergedTrack &track, int iTrk, const AliGPUTPCGMMerger* merger, AliGPUTPCGMMergedTrackHit* clusters)
+GPUd() void AliGPUTPCGMTrackParam::RefitTrack(AliGPUTPCGMMergedTrack &track, int iTrk, const AliGPUTPCGMMerger* merger, AliGPUTPCGMMergedTrackHit* clusters, int attempt)
 {
 	if( !track.OK() ) return;
 
 	CADEBUG(cadebug_nTracks++;)
 	CADEBUG(if (DEBUG_SINGLE_TRACK >= 0 && cadebug_nTracks != DEBUG_SINGLE_TRACK) {track.SetNClusters(0);track.SetOK(0);return;})
 
-	const int nAttempts = 2;
-	for (int attempt = 0;;)
+	const int nAttempts = merger->SliceParam().rec.RefitMaxAttempts;
+	int looperBudget = CAMath::Max(0, merger->SliceParam().rec.RefitMaxLooperSteps); //Shared by all attempts, negative settings mean unlimited like 0
+	int *pLooperBudget = looperBudget > 0 ? &looperBudget : 0;
+	for (;;)
 	{
 		int nTrackHits = track.NClusters();
 		int NTolerated = 0; //Clusters not fit but tollerated for track length cut
 		AliGPUTPCGMTrackParam t = track.Param();
 		float Alpha = track.Alpha();
 		CADEBUG(int nTrackHitsOld = nTrackHits; float ptOld = t.QPt();)
-		bool ok = t.Fit( merger, iTrk, clusters + track.FirstClusterRef(), nTrackHits, NTolerated, Alpha, attempt, GPUCA_MAX_SIN_PHI, &track.OuterParam() );
+		bool ok = t.Fit( merger, iTrk, clusters + track.FirstClusterRef(), nTrackHits, NTolerated, Alpha, attempt, GPUCA_MAX_SIN_PHI, &track.OuterParam(), pLooperBudget );
 		CADEBUG(printf("Finished Fit Track %d\n", cadebug_nTracks);)
-
-		if ( CAMath::Abs( t.QPt() ) < 1.e-4f ) t.QPt() = 1.e-4f;
-
 		CADEBUG(printf("OUTPUT hits %d -> %d+%d = %d, QPt %f -> %f, SP %f, ok %d chi2 %f chi2ndf %f\n", nTrackHitsOld, nTrackHits, NTolerated, nTrackHits + NTolerated, ptOld, t.QPt(), t.SinPhi(), (int) ok, t.Chi2(), t.Chi2() / CAMath::Max(1,nTrackHits));)
 
-		if (!ok && ++attempt < nAttempts)
+		if (!ok && ++attempt < nAttempts && looperBudget >= 0) //No further attempt once the looper budget is exceeded
 		{
-			for (unsigned int i = 0;i < track.NClusters();i++) clusters[track.FirstClusterRef() + i].fState &= AliGPUTPCGMMergedTrackHit::hwcfFlags;
+			ResetClusterStates(track, clusters);
 			CADEBUG(printf("Track rejected, running refit\n");)
 			continue;
 		}
 
-		track.SetOK(ok);
-		track.SetNClustersFitted( nTrackHits );
-		track.Param() = t;
-		track.Alpha() = Alpha;
+		StoreRefitResult(track, merger, clusters, t, ok, nTrackHits, Alpha, looperBudget < 0);
 		break;
 	}
+}
+
+GPUd() void AliGPUTPCGMTrackParam::ResetClusterStates(const AliGPUTPCGMMergedTrack &track, AliGPUTPCGMMergedTrackHit* clusters)
+{
+	for (unsigned int i = 0;i < track.NClusters();i++) clusters[track.FirstClusterRef() + i].fState &= AliGPUTPCGMMergedTrackHit::hwcfFlags;
+}
+
+GPUd() void AliGPUTPCGMTrackParam::StoreRefitResult(AliGPUTPCGMMergedTrack &track, const AliGPUTPCGMMerger* merger, const AliGPUTPCGMMergedTrackHit* clusters, AliGPUTPCGMTrackParam t, bool ok, int nTrackHits, float Alpha, bool fitBudgetExceeded)
+{
+	if ( CAMath::Abs( t.QPt() ) < 1.e-4f ) t.QPt() = 1.e-4f;
+
+	track.SetOK(ok);
+	track.SetFitBudgetExceeded(fitBudgetExceeded);
+	track.SetNClustersFitted( nTrackHits );
+	track.Param() = t;
+	track.Alpha() = Alpha;
 
 	if (track.OK())
 	{
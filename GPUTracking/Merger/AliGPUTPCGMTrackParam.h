@@ -106,16 +106,17 @@ class AliGPUTPCGMTrackParam
 	GPUd() bool CheckNumericalQuality(float overrideCovYY = -1.f) const;
 	GPUd() bool CheckCov() const;
 
-	GPUd() bool Fit(const AliGPUTPCGMMerger *merger, int iTrk, AliGPUTPCGMMergedTrackHit *clusters, int &N, int &NTolerated, float &Alpha, int attempt = 0, float maxSinPhi = GPUCA_MAX_SIN_PHI, AliGPUTPCOuterParam *outerParam = 0);
+	GPUd() bool Fit(const AliGPUTPCGMMerger *merger, int iTrk, AliGPUTPCGMMergedTrackHit *clusters, int &N, int &NTolerated, float &Alpha, int attempt = 0, float maxSinPhi = GPUCA_MAX_SIN_PHI, AliGPUTPCOuterParam *outerParam = 0, int *looperBudget = 0);
+	GPUd() bool FinishFit(AliGPUTPCGMPropagator &prop, const AliGPUParam &param, int N, int NTolerated, float covYYUpd, float &Alpha);
 	GPUd() void MirrorTo(AliGPUTPCGMPropagator &prop, float toY, float toZ, bool inFlyDirection, const AliGPUParam &param, unsigned char row, unsigned char clusterState, bool mirrorParameters);
 	GPUd() int MergeDoubleRowClusters(int ihit, int wayDirection, AliGPUTPCGMMergedTrackHit *clusters, const AliGPUParam &param, AliGPUTPCGMPropagator &prop, float &xx, float &yy, float &zz, int maxN, float clAlpha, unsigned char &clusterState, bool rejectChi2);
 
-	GPUd() void AttachClustersMirror(const AliGPUTPCGMMerger *Merger, int slice, int iRow, int iTrack, float toY, AliGPUTPCGMPropagator &prop);
+	GPUd() void AttachClustersMirror(const AliGPUTPCGMMerger *Merger, int slice, int iRow, int iTrack, float toY, AliGPUTPCGMPropagator &prop, int *looperBudget = 0);
 	GPUd() void AttachClustersPropagate(const AliGPUTPCGMMerger *Merger, int slice, int lastRow, int toRow, int iTrack, bool goodLeg, AliGPUTPCGMPropagator &prop, bool inFlyDirection, float maxSinPhi = GPUCA_MAX_SIN_PHI);
 	GPUd() void AttachClusters(const AliGPUTPCGMMerger *Merger, int slice, int iRow, int iTrack, bool goodLeg);
 	GPUd() void AttachClusters(const AliGPUTPCGMMerger *Merger, int slice, int iRow, int iTrack, bool goodLeg, float Y, float Z);
 
-	GPUd() int FollowCircle(const AliGPUTPCGMMerger *Merger, AliGPUTPCGMPropagator &prop, int slice, int iRow, int iTrack, bool goodLeg, float toAlpha, float toX, float toY, int toSlice, int toRow, bool inFlyDirection);
+	GPUd() int FollowCircle(const AliGPUTPCGMMerger *Merger, AliGPUTPCGMPropagator &prop, int slice, int iRow, int iTrack, bool goodLeg, float toAlpha, float toX, float toY, int toSlice, int toRow, bool inFlyDirection, int *looperBudget = 0);
 
 	GPUd() void MarkClusters(AliGPUTPCGMMergedTrackHit *clusters, int ihitFirst, int ihitLast, int wayDirection, unsigned char state)
 	{
@@ -150,7 +151,9 @@ class AliGPUTPCGMTrackParam
 		if (mask) x = v;
 	}
 
-	GPUd() static void RefitTrack(AliGPUTPCGMMergedTrack &track, int iTrk, const AliGPUTPCGMMerger *merger, AliGPUTPCGMMergedTrackHit *clusters);
+	GPUd() static void RefitTrack(AliGPUTPCGMMergedTrack &track, int iTrk, const AliGPUTPCGMMerger *merger, AliGPUTPCGMMergedTrackHit *clusters, int attempt = 0);
+	GPUd() static void ResetClusterStates(const AliGPUTPCGMMergedTrack &track, AliGPUTPCGMMergedTrackHit *clusters);
+	GPUd() static void StoreRefitResult(AliGPUTPCGMMergedTrack &track, const AliGPUTPCGMMerger *merger, const AliGPUTPCGMMergedTrackHit *clusters, AliGPUTPCGMTrackParam t, bool ok, int nTrackHits, float Alpha, bool fitBudgetExceeded);
 
 #if defined(GPUCA_ALIROOT_LIB) & !defined(GPUCA_GPUCODE)
 	bool GetExtParam(AliExternalTrackParam &T, double alpha) const;
@@ -167,6 +170,7 @@ class AliGPUTPCGMTrackParam
 
   private:
 	GPUd() bool FollowCircleChk(float lrFactor, float toY, float toX, bool up, bool right);
+	GPUd() static bool UseLooperBudget(int *looperBudget);
 
 	float fX; // x position
 	float fZOffset;
@@ -37,4 +37,26 @@ struct AliGPUTPCClusterData
 #endif
 };
 
+/**
+ * Column-wise alternative to an array of AliGPUTPCClusterData, one array per member with one entry per cluster.
+ * Building the slice data reads only the row, y and z columns instead of the full cluster records.
+ */
+struct AliGPUTPCClusterDataSoA
+{
+      const int* fId;
+      const short* fRow;
+      const short* fFlags;
+      const float* fX;
+      const float* fY;
+      const float* fZ;
+      const float* fAmp;
+#ifdef GPUCA_FULL_CLUSTERDATA
+      const float* fPad;
+      const float* fTime;
+      const float* fAmpMax;
+      const float* fSigmaPad2;
+      const float* fSigmaTime2;
+#endif
+};
+
 #endif // CLUSTERDATA_H
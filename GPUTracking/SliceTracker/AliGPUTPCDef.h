@@ -125,11 +125,13 @@ struct cahit2{cahit x, y;};
 #endif
 
 #ifdef EXTERN_ROW_HITS
-	#define GETRowHit(iRow) tracker.TrackletRowHits()[iRow * s.fNTracklets + r.fItr]
-	#define SETRowHit(iRow, val) tracker.TrackletRowHits()[iRow * s.fNTracklets + r.fItr] = val
+	#define GETRowHit(iRow) r.fRowHits[iRow * s.fNTracklets + r.fItr]
+	#define SETRowHit(iRow, val) r.fRowHits[iRow * s.fNTracklets + r.fItr] = val
+	#define SETRowHitBase(r, rowHits, tracklets) (r).fRowHits = (rowHits)
 #else
 	#define GETRowHit(iRow) tracklet.RowHit(iRow)
 	#define SETRowHit(iRow, val) tracklet.SetRowHit(iRow, val)
+	#define SETRowHitBase(r, rowHits, tracklets) (r).fTracklets = (tracklets)
 #endif
 
 #ifdef GPUCA_GPUCODE
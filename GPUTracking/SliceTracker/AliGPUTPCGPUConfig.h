@@ -58,9 +58,17 @@
 #define GPUCA_TRACKLET_SELECTOR_HITS_REG_SIZE 12
 #define GPUCA_TRACKLET_SELECTOR_SLICE_COUNT 8		//Currently must be smaller than avaiable MultiProcessors on GPU or will result in wrong results
 
-#define GPUCA_MAX_TRACKLETS 65536					//Max Number of Tracklets that can be processed by GPU Tracker, Should be divisible by 16 at least
-#define GPUCA_MAX_TRACKS 32768						//Max number of Tracks that can be processd by GPU Tracker per sector, must be below 2^24 for track ID format!!!
-#define GPUCA_MAX_ROWSTARTHITS 20000				//Maximum number of start hits per row
+//Buffer sizes of the slice tracker are estimated from the number of clusters in the slice (see AliGPUTPCTracker::SetMaxData)
+//A slice that overflows its buffers is processed again with the capacities scaled up by GPUCA_CAPACITY_SCALE_STEP
+#define GPUCA_MIN_TRACKLETS 16384					//Minimum number of tracklets per slice
+#define GPUCA_TRACKLETS_PER_HIT 0.5f				//Estimated number of tracklets per cluster
+#define GPUCA_MIN_TRACKS 8192						//Minimum number of tracks per slice
+#define GPUCA_TRACKS_PER_HIT 0.25f					//Estimated number of tracks per cluster
+#define GPUCA_MAX_TRACKS ((1 << 24) - 1)			//Max number of Tracks per sector, must be below 2^24 for track ID format!!!
+#define GPUCA_MIN_ROWSTARTHITS 4096					//Minimum number of start hits per row
+#define GPUCA_ROWSTARTHITS_PER_HIT 0.15f			//Estimated maximum number of start hits in a row per cluster in the slice
+#define GPUCA_CAPACITY_SCALE_STEP 2.f				//Factor to enlarge the buffers of a slice after an overflow
+#define GPUCA_MAX_CAPACITY_SCALE 16.f				//Give up enlarging the buffers beyond this scale
 
 #define GPUCA_TRACKER_CONSTANT_MEM 65000			//Amount of Constant Memory to reserve
 
@@ -0,0 +1,156 @@
+// **************************************************************************
+// This file is property of and copyright by the ALICE HLT Project          *
+// ALICE Experiment at CERN, All rights reserved.                           *
+//                                                                          *
+// Primary Authors: Sergey Gorbunov <sergey.gorbunov@kip.uni-heidelberg.de> *
+//                  Ivan Kisel <kisel@kip.uni-heidelberg.de>                *
+//                  David Rohr <drohr@kip.uni-heidelberg.de>                *
+//                  for The ALICE HLT Project.                              *
+//                                                                          *
+// Permission to use, copy, modify and distribute this software and its     *
+// documentation strictly for non-commercial purposes is hereby granted     *
+// without fee, provided that the above copyright notice appears in all     *
+// copies and that both the copyright notice and this permission notice     *
+// appear in the supporting documentation. The authors make no claims       *
+// about the suitability of this software for any purpose. It is            *
+// provided "as is" without express or implied warranty.                    *
+//                                                                          *
+//***************************************************************************
+
+#include "AliGPUTPCGlobalTracking.h"
+#include "AliGPUTPCDef.h"
+#include "AliGPUTPCTracker.h"
+#include "AliGPUTPCTrack.h"
+#include "AliGPUTPCTrackParam.h"
+#include "AliGPUTPCTrackLinearisation.h"
+#include "AliGPUTPCTracklet.h"
+#include "AliGPUCommonMath.h"
+
+GPUd() int AliGPUTPCGlobalTracking::GlobalTrackingSliceLeft(int iSlice)
+{
+	int sliceLeft = (iSlice + (GPUCA_NSLICES / 2 - 1)) % (GPUCA_NSLICES / 2);
+	if (iSlice >= GPUCA_NSLICES / 2) sliceLeft += GPUCA_NSLICES / 2;
+	return sliceLeft;
+}
+
+GPUd() int AliGPUTPCGlobalTracking::GlobalTrackingSliceRight(int iSlice)
+{
+	int sliceRight = (iSlice + 1) % (GPUCA_NSLICES / 2);
+	if (iSlice >= GPUCA_NSLICES / 2) sliceRight += GPUCA_NSLICES / 2;
+	return sliceRight;
+}
+
+GPUd() int AliGPUTPCGlobalTracking::PerformGlobalTrackingRun(workerType &tracker, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &smem, workerType &sliceSource, int iTrack, int rowIndex, float angle, int direction, int iSlot)
+{
+	//Prolong track iTrack of the neighbouring slice into this slice, the row hits are collected in the global tracking slot iSlot
+	AliGPUTPCTrackParam tParam;
+	tParam.InitParam();
+	tParam.SetCov( 0, 0.05 );
+	tParam.SetCov( 2, 0.05 );
+	tParam.SetCov( 5, 0.001 );
+	tParam.SetCov( 9, 0.001 );
+	tParam.SetCov( 14, 0.05 );
+	tParam.SetParam(sliceSource.Tracks()[iTrack].Param());
+
+	if (!tParam.Rotate(angle, GPUCA_MAX_SIN_PHI)) return(0);
+
+	int maxRowGap = 10;
+	AliGPUTPCTrackLinearisation t0( tParam );
+	do
+	{
+		rowIndex += direction;
+		if (!tParam.TransportToX(tracker.Row(rowIndex).X(), t0, tracker.Param().ConstBz, GPUCA_MAX_SIN_PHI)) return(0); //Reuse t0 linearization until we are in the next sector
+		if (--maxRowGap == 0) return(0);
+	} while (CAMath::Abs(tParam.Y()) > tracker.Row(rowIndex).MaxY());
+
+	float err2Y, err2Z;
+	tracker.GetErrors2( rowIndex, tParam.Z(), tParam.SinPhi(), tParam.DzDs(), err2Y, err2Z );
+	if (tParam.GetCov(0) < err2Y) tParam.SetCov(0, err2Y);
+	if (tParam.GetCov(2) < err2Z) tParam.SetCov(2, err2Z);
+
+	int nHits = AliGPUTPCTrackletConstructor::AliGPUTPCTrackletConstructorGlobalTracking(tracker, smem, tParam, rowIndex, direction, iSlot);
+	if (nHits >= GLOBAL_TRACKING_MIN_HITS)
+	{
+		int trackId = CAMath::AtomicAdd(tracker.NTracks(), 1);
+		int hitId = CAMath::AtomicAdd(tracker.NTrackHits(), nHits);
+		int i = direction == 1 ? 0 : (nHits - 1);
+		while (i >= 0 && i < nHits)
+		{
+#ifdef EXTERN_ROW_HITS
+			const calink rowHit = tracker.GlobalTrackingRowHits()[rowIndex * smem.fNTracklets + iSlot];
+#else
+			const calink rowHit = tracker.GlobalTrackingTracklets()[iSlot].RowHit(rowIndex);
+#endif
+			if (rowHit != CALINK_INVAL)
+			{
+				tracker.TrackHits()[hitId + i].Set(rowIndex, rowHit);
+				i += direction;
+			}
+			rowIndex += direction;
+		}
+		GPUglobalref() MEM_GLOBAL(AliGPUTPCTrack) &track = tracker.Tracks()[trackId];
+		track.SetAlive(1);
+		track.SetParam(tParam.GetParam());
+		track.SetNHits(nHits);
+		track.SetFirstHitID(hitId);
+		track.SetLocalTrackId((sliceSource.ISlice() << 24) | sliceSource.Tracks()[iTrack].LocalTrackId());
+	}
+
+	return(nHits >= GLOBAL_TRACKING_MIN_HITS);
+}
+
+GPUd() void AliGPUTPCGlobalTracking::ProcessTrack(workerType &tracker, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &smem, workerType &sliceSource, int iTrack, bool rightBorder, int iSlot)
+{
+	//Try both ends of a local track of the neighbouring slice, only tracks close to the border shared with this slice are prolonged
+	const float angle = rightBorder ? tracker.Param().DAlpha : -tracker.Param().DAlpha;
+	for (int upper = 0;upper < 2;upper++)
+	{
+		const int tmpHit = sliceSource.Tracks()[iTrack].FirstHitID() + (upper ? (sliceSource.Tracks()[iTrack].NHits() - 1) : 0);
+		const int rowIndex = sliceSource.TrackHits()[tmpHit].RowIndex();
+		if (upper ? (rowIndex >= GPUCA_ROW_COUNT - GLOBAL_TRACKING_MIN_ROWS || rowIndex < GPUCA_ROW_COUNT - GLOBAL_TRACKING_RANGE) : (rowIndex < GLOBAL_TRACKING_MIN_ROWS || rowIndex >= GLOBAL_TRACKING_RANGE)) continue;
+
+		GPUglobalref() const MEM_GLOBAL(AliGPUTPCRow) &row = sliceSource.Row(rowIndex);
+		const float Y = (float) sliceSource.HitDataY(row, sliceSource.TrackHits()[tmpHit].HitIndex()) * row.HstepY() + row.Grid().YMin();
+		const bool nearBorder = rightBorder ? (Y > row.MaxY() * (upper ? GLOBAL_TRACKING_Y_RANGE_UPPER_RIGHT : GLOBAL_TRACKING_Y_RANGE_LOWER_RIGHT)) : (Y < -row.MaxY() * (upper ? GLOBAL_TRACKING_Y_RANGE_UPPER_LEFT : GLOBAL_TRACKING_Y_RANGE_LOWER_LEFT));
+		if (!nearBorder) continue;
+		if (*tracker.NTracks() >= tracker.NMaxTracks())
+		{
+#ifndef GPUCA_GPUCODE
+			printf("Insufficient memory for global tracking (%d:%c %d / %d)\n", sliceSource.ISlice(), rightBorder ? 'r' : 'l', *tracker.NTracks(), tracker.NMaxTracks());
+#endif
+			continue;
+		}
+		PerformGlobalTrackingRun(tracker, smem, sliceSource, iTrack, rowIndex, angle, upper ? 1 : -1, iSlot);
+	}
+}
+
+template <> GPUd() void AliGPUTPCGlobalTracking::Thread<0>(int nBlocks, int nThreads, int iBlock, int iThread, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &sMem, workerType &tracker)
+{
+	//The hits of the prolonged tracks are collected in the global tracking slots of the tracker, fNTracklets is the row stride of these slots
+	if (get_local_id(0) == 0) sMem.fNTracklets = GLOBAL_TRACKING_SLOTS;
+#ifdef GPUCA_GPUCODE
+	for (unsigned int i = get_local_id(0);i < GPUCA_ROW_COUNT * sizeof(MEM_PLAIN(AliGPUTPCRow)) / sizeof(int);i += get_local_size(0))
+	{
+		reinterpret_cast<GPUsharedref() int*>(&sMem.fRows)[i] = reinterpret_cast<GPUglobalref() int*>(tracker.SliceDataRows())[i];
+	}
+#endif
+	GPUbarrier();
+
+	if (tracker.NHitsTotal() < 1) return;
+	const int nSlots = CAMath::Min((int) get_global_size(0), GLOBAL_TRACKING_SLOTS);
+	if ((int) get_global_id(0) >= nSlots) return;
+
+	//The source trackers are the neighbours of this tracker in the tracker array
+	GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker) *pTracker = &tracker - tracker.ISlice();
+	workerType &sliceLeft = pTracker[GlobalTrackingSliceLeft(tracker.ISlice())];
+	workerType &sliceRight = pTracker[GlobalTrackingSliceRight(tracker.ISlice())];
+	const int nLeft = sliceLeft.NLocalTracks();
+	const int nRight = sliceRight.NLocalTracks();
+
+	for (int i = get_global_id(0);i < nLeft + nRight;i += nSlots)
+	{
+		//Tracks of the left neighbour leave it through its right border, and vice versa
+		if (i < nLeft) ProcessTrack(tracker, sMem, sliceLeft, i, true, get_global_id(0));
+		else ProcessTrack(tracker, sMem, sliceRight, i - nLeft, false, get_global_id(0));
+	}
+}
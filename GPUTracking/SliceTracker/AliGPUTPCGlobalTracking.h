@@ -0,0 +1,44 @@
+//-*- Mode: C++ -*-
+// ************************************************************************
+// This file is property of and copyright by the ALICE HLT Project        *
+// ALICE Experiment at CERN, All rights reserved.                         *
+// See cxx source for full Copyright notice                               *
+//                                                                        *
+//*************************************************************************
+
+#ifndef ALIGPUTPCGLOBALTRACKING_H
+#define ALIGPUTPCGLOBALTRACKING_H
+
+#include "AliGPUTPCDef.h"
+#include "AliGPUTPCTrackletConstructor.h"
+#include "AliGPUGeneralKernels.h"
+#include "AliGPUConstantMem.h"
+
+MEM_CLASS_PRE()
+class AliGPUTPCTracker;
+
+/**
+ * @class AliGPUTPCGlobalTracking
+ * Extends the local tracks of the two neighbouring slices into the slice of the tracker the kernel runs on.
+ * The kernel must run after the tracklet selector of the slice and of both neighbours,
+ * and it is the only one adding tracks to its slice, so all slices can be processed in parallel.
+ */
+class AliGPUTPCGlobalTracking
+{
+public:
+	typedef AliGPUTPCTrackletConstructor::MEM_LOCAL(AliGPUTPCSharedMemory) AliGPUTPCSharedMemory;
+
+	typedef GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker) workerType;
+	GPUhdi() static AliGPUDataTypes::RecoStep GetRecoStep() {return GPUCA_RECO_STEP::TPCSliceTracking;}
+	MEM_TEMPLATE() GPUhdi() static workerType* Worker(MEM_TYPE(AliGPUConstantMem) &workers) {return workers.tpcTrackers;}
+	template <int iKernel = 0> GPUd() static void Thread(int nBlocks, int nThreads, int iBlock, int iThread, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &smem, workerType &tracker);
+
+	GPUd() static int GlobalTrackingSliceLeft(int iSlice);
+	GPUd() static int GlobalTrackingSliceRight(int iSlice);
+
+private:
+	GPUd() static void ProcessTrack(workerType &tracker, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &smem, workerType &sliceSource, int iTrack, bool rightBorder, int iSlot);
+	GPUd() static int PerformGlobalTrackingRun(workerType &tracker, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &smem, workerType &sliceSource, int iTrack, int rowIndex, float angle, int direction, int iSlot);
+};
+
+#endif //ALIGPUTPCGLOBALTRACKING_H
@@ -20,12 +20,13 @@
 class AliGPUTPCHitId
 {
   public:
-	GPUhd() void Set( int row, int hit ) { fId = ( hit << 8 ) | row; }
+	GPUhd() void Set( int row, int hit ) { fId = ( (unsigned int) hit << 8 ) | row; }
 	GPUhd() int RowIndex() const { return fId & 0xff; }
 	GPUhd() int HitIndex() const { return fId >> 8; }
 
   private:
-	int fId;
+	unsigned int fId; //unsigned, such that the full 24 bits can be used for the hit index
+
 };
 
 #endif // ALIHLTTPCCAHITID_H
@@ -132,6 +132,9 @@ template <> GPUd() void AliGPUTPCNeighboursFinder::Thread<0>(int /*nBlocks*/, in
 
 	float chi2Cut = 3.f * 3.f * 4 * (s.fUpDx * s.fUpDx + s.fDnDx * s.fDnDx);
 	//float chi2Cut = 3.*3.*(s.fUpDx*s.fUpDx + s.fDnDx*s.fDnDx ); //SG
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_NEIGHBOURS_FINDER_GENERIC)
+	FindNeighboursCPU(nThreads, iThread, s, tracker, chi2Cut);
+#else
 #ifdef GPUCA_GPUCODE
 	GPUsharedref() const MEM_LOCAL(AliGPUTPCRow) &row = s.fRow;
 	GPUsharedref() const MEM_LOCAL(AliGPUTPCRow) &rowUp = s.fRowUp;
@@ -263,7 +266,132 @@ template <> GPUd() void AliGPUTPCNeighboursFinder::Thread<0>(int /*nBlocks*/, in
 			}
 		}
 
+		tracker.SetHitLinkUpData(row, ih, linkUp);
+		tracker.SetHitLinkDownData(row, ih, linkDn);
+	}
+#endif //!GPUCA_GPUCODE && !GPUCA_NEIGHBOURS_FINDER_GENERIC
+}
+
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_NEIGHBOURS_FINDER_GENERIC)
+int AliGPUTPCNeighboursFinder::FetchCandidates(AliGPUTPCSharedMemory &s, const workerType &tracker, const AliGPUTPCRow &row, const AliGPUTPCHitArea &area, HitAreaCursor &cursor,
+                                               float dx, float y, float z, float *candY, float *candZ, calink *candIdx, int maxN)
+{
+	//Collect up to maxN hits of the area starting at the cursor, same order as AliGPUTPCHitArea::GetNext.
+	//The hits of a bin range are dequantized in batches first, so that the conversion vectorizes.
+	const float y0 = row.Grid().YMin();
+	const float z0 = row.Grid().ZMin();
+	const float stepY = row.HstepY();
+	const float stepZ = row.HstepZ();
+	const float minY = area.MinY(), maxY = area.MaxY(), minZ = area.MinZ(), maxZ = area.MaxZ();
+	const cahit2 *hitData = tracker.Data().HitData(row);
+	const calink *firstHitInBin = tracker.Data().FirstHitInBin(row);
+
+	int n = 0;
+	while (n < maxN)
+	{
+		while (cursor.fIh >= cursor.fIhEnd)
+		{
+			if (cursor.fIz >= area.BZmax()) return n;
+			cursor.fIz++;
+			cursor.fIndYmin += area.Ny();
+			cursor.fIh = firstHitInBin[cursor.fIndYmin];
+			cursor.fIhEnd = firstHitInBin[cursor.fIndYmin + area.BDY()];
+		}
+
+		const int ihStart = cursor.fIh;
+		const int nBin = CAMath::Min(cursor.fIhEnd - ihStart, GPUCA_NEIGHBOURS_FINDER_CPU_BATCH);
+		for (int k = 0; k < nBin; k++)
+		{
+			s.fBinY[k] = y0 + hitData[ihStart + k].x * stepY;
+			s.fBinZ[k] = z0 + hitData[ihStart + k].y * stepZ;
+		}
+		int k = 0;
+		for (; k < nBin && n < maxN; k++)
+		{
+			if (s.fBinZ[k] > maxZ || s.fBinZ[k] < minZ || s.fBinY[k] < minY || s.fBinY[k] > maxY) continue;
+			candY[n] = dx * (s.fBinY[k] - y);
+			candZ[n] = dx * (s.fBinZ[k] - z);
+			candIdx[n] = ihStart + k;
+			n++;
+		}
+		cursor.fIh = ihStart + k;
+	}
+	return n;
+}
+
+void AliGPUTPCNeighboursFinder::FindNeighboursCPU(int nThreads, int iThread, AliGPUTPCSharedMemory &s, workerType &tracker, float chi2Cut)
+{
+	//CPU version of the neighbours search, same result as the generic code.
+	//Candidates of both rows are stored as SoA, and the distances of all pairs of a batch of lower row candidates
+	//to the upper row candidates are computed in one vectorizable loop before the best pair is selected.
+	const AliGPUTPCRow &row = tracker.Row(s.fIRow);
+	const AliGPUTPCRow &rowUp = tracker.Row(s.fIRowUp);
+	const AliGPUTPCRow &rowDn = tracker.Row(s.fIRowDn);
+	const float y0 = row.Grid().YMin();
+	const float z0 = row.Grid().ZMin();
+	const float stepY = row.HstepY();
+	const float stepZ = row.HstepZ();
+	const float kAngularMultiplier = tracker.Param().rec.SearchWindowDZDR;
+	const float kAreaSize = tracker.Param().rec.NeighboursSearchArea;
+
+	for (int ih = iThread; ih < s.fNHits; ih += nThreads)
+	{
+		int linkUp = -1;
+		int linkDn = -1;
+
+		if (s.fDnNHits > 0 && s.fUpNHits > 0)
+		{
+			const float y = y0 + tracker.HitDataY(row, ih) * stepY;
+			const float z = z0 + tracker.HitDataZ(row, ih) * stepZ;
+
+			AliGPUTPCHitArea areaDn, areaUp;
+			areaUp.Init(rowUp, tracker.Data(), y * s.fUpTx, kAngularMultiplier != 0.f ? z : (z * s.fUpTx), kAreaSize, kAngularMultiplier != 0.f ? (s.fUpDx * kAngularMultiplier) : kAreaSize);
+			areaDn.Init(rowDn, tracker.Data(), y * s.fDnTx, kAngularMultiplier != 0.f ? z : (z * s.fDnTx), kAreaSize, kAngularMultiplier != 0.f ? (-s.fDnDx * kAngularMultiplier) : kAreaSize);
+
+			HitAreaCursor cursorUp = {areaUp.Iz(), areaUp.IndYmin(), areaUp.HitYfst(), areaUp.HitYlst()};
+			const int nNeighUp = FetchCandidates(s, tracker, rowUp, areaUp, cursorUp, s.fDnDx, y, z, s.fUpY, s.fUpZ, s.fUpIdx, GPUCA_MAXN);
+
+			if (nNeighUp > 0)
+			{
+				HitAreaCursor cursorDn = {areaDn.Iz(), areaDn.IndYmin(), areaDn.HitYfst(), areaDn.HitYlst()};
+				int bestDn = -1, bestUp = -1;
+				float bestD = 1.e10f;
+				int nNeighDn;
+				do
+				{
+					nNeighDn = FetchCandidates(s, tracker, rowDn, areaDn, cursorDn, s.fUpDx, y, z, s.fDnY, s.fDnZ, s.fDnIdx, GPUCA_NEIGHBOURS_FINDER_CPU_BATCH);
+					for (int iDn = 0; iDn < nNeighDn; iDn++)
+					{
+						for (int iUp = 0; iUp < nNeighUp; iUp++)
+						{
+							const float dy = s.fDnY[iDn] - s.fUpY[iUp];
+							const float dz = s.fDnZ[iDn] - s.fUpZ[iUp];
+							s.fD[iDn * nNeighUp + iUp] = dy * dy + dz * dz;
+						}
+					}
+					//Scan in the order of the generic code, so that ties are resolved identically
+					const int nPairs = nNeighDn * nNeighUp;
+					for (int iPair = 0; iPair < nPairs; iPair++)
+					{
+						if (s.fD[iPair] < bestD)
+						{
+							bestD = s.fD[iPair];
+							bestDn = s.fDnIdx[iPair / nNeighUp];
+							bestUp = iPair % nNeighUp;
+						}
+					}
+				} while (nNeighDn == GPUCA_NEIGHBOURS_FINDER_CPU_BATCH);
+
+				if (bestD <= chi2Cut)
+				{
+					linkUp = s.fUpIdx[bestUp];
+					linkDn = bestDn;
+				}
+			}
+		}
+
 		tracker.SetHitLinkUpData(row, ih, linkUp);
 		tracker.SetHitLinkDownData(row, ih, linkDn);
 	}
 }
+#endif //!GPUCA_GPUCODE && !GPUCA_NEIGHBOURS_FINDER_GENERIC
@@ -16,6 +16,7 @@
 #include "AliGPUConstantMem.h"
 MEM_CLASS_PRE()
 class AliGPUTPCTracker;
+class AliGPUTPCHitArea;
 
 /**
  * @class AliGPUTPCNeighboursFinder
@@ -61,6 +62,17 @@ public:
 		calink fB[ALIHLTTPCCANEIGHBOURS_FINDER_MAX_NNEIGHUP]; // temp memory
 #endif
 #endif //ALIHLTTPCCANEIGHBOURS_FINDER_MAX_NNEIGHUP > 0
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_NEIGHBOURS_FINDER_GENERIC)
+		float fUpY[GPUCA_MAXN];                                       // dequantized candidates in the next row, scaled by fDnDx
+		float fUpZ[GPUCA_MAXN];                                       // see fUpY
+		calink fUpIdx[GPUCA_MAXN];                                    // hit indices of the candidates in the next row
+		float fDnY[GPUCA_NEIGHBOURS_FINDER_CPU_BATCH];                // dequantized candidates in the previous row, scaled by fUpDx
+		float fDnZ[GPUCA_NEIGHBOURS_FINDER_CPU_BATCH];                // see fDnY
+		calink fDnIdx[GPUCA_NEIGHBOURS_FINDER_CPU_BATCH];             // hit indices of the candidates in the previous row
+		float fBinY[GPUCA_NEIGHBOURS_FINDER_CPU_BATCH];               // dequantized hits of the current bin range
+		float fBinZ[GPUCA_NEIGHBOURS_FINDER_CPU_BATCH];               // see fBinY
+		float fD[GPUCA_NEIGHBOURS_FINDER_CPU_BATCH * GPUCA_MAXN];    // distances of all up / down candidate pairs of a batch
+#endif //!GPUCA_GPUCODE && !GPUCA_NEIGHBOURS_FINDER_GENERIC
 		MEM_LG(AliGPUTPCRow)
 		fRow, fRowUp, fRowDown;
 	};
@@ -69,6 +81,21 @@ public:
 	GPUhdi() static AliGPUDataTypes::RecoStep GetRecoStep() {return GPUCA_RECO_STEP::TPCSliceTracking;}
 	MEM_TEMPLATE() GPUhdi() static workerType* Worker(MEM_TYPE(AliGPUConstantMem) &workers) {return workers.tpcTrackers;}
 	template <int iKernel = 0> GPUd() static void Thread(int nBlocks, int nThreads, int iBlock, int iThread, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &smem, workerType &tracker);
+
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_NEIGHBOURS_FINDER_GENERIC)
+  private:
+	struct HitAreaCursor
+	{
+		int fIz;      // current z bin
+		int fIndYmin; // first bin index of the current z bin
+		int fIh;      // next hit to check
+		int fIhEnd;   // end of the hit range of the current z bin
+	};
+
+	static void FindNeighboursCPU(int nThreads, int iThread, AliGPUTPCSharedMemory &s, workerType &tracker, float chi2Cut);
+	static int FetchCandidates(AliGPUTPCSharedMemory &s, const workerType &tracker, const AliGPUTPCRow &row, const AliGPUTPCHitArea &area, HitAreaCursor &cursor,
+	                           float dx, float y, float z, float *candY, float *candZ, calink *candIdx, int maxN);
+#endif //!GPUCA_GPUCODE && !GPUCA_NEIGHBOURS_FINDER_GENERIC
 };
 
 #endif //ALIHLTTPCCANEIGHBOURSFINDER_H
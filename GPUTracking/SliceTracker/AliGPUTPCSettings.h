@@ -19,6 +19,7 @@
 #define GLOBAL_TRACKING_Y_RANGE_LOWER_RIGHT 0.85
 #define GLOBAL_TRACKING_MIN_ROWS 10					//Min num of rows an additional global track must span over
 #define GLOBAL_TRACKING_MIN_HITS 8					//Min num of hits for an additional global track
+#define GLOBAL_TRACKING_SLOTS 1						//Number of tracklet slots in the host scratch memory of a tracker for the row hits of prolonged tracks, one per thread of the global tracking kernel, which runs single-threaded on the host for each slice
 
 //#define MERGE_CE_ROWLIMIT 15						//Distance from first / last row in order to attempt merging accross CE
 
@@ -26,7 +27,12 @@
 #define MERGE_HORIZONTAL_DOUBLE_QPT_LIMIT 2			//Min Q/Pt to attempt second horizontal merge between slices after a vertical merge was found
 
 #define GPUCA_Y_FACTOR 4							//Weight of y residual vs z residual in tracklet constructor
+#define GPUCA_GRID_MAX_BINS_PER_HIT 2				//Maximum number of grid bins per hit in a row for the grid adapted to the hit density, sets the size of the grid buffer
+#define GPUCA_GRID_DENSITY_CELL_HITS 16				//Average number of hits per cell of the coarse histogram used to measure the hit density when creating the row grids
 #define GPUCA_MAXN 40							//Maximum number of neighbor hits to consider in one row in neightbors finder
+#define GPUCA_NEIGHBOURS_FINDER_CPU_BATCH 16		//Number of hits dequantized / lower row candidates paired at once by the CPU neighbours finder
+//#define GPUCA_NEIGHBOURS_FINDER_GENERIC				//Use the generic (GPU) neighbours finder also on the CPU instead of the batched CPU version
+#define GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH 8		//Number of tracklets the CPU tracklet constructor moves over the rows together
 #define TRACKLET_CONSTRUCTOR_MAX_ROW_GAP 4			//Maximum number of consecutive rows without hit in track following
 #define TRACKLET_CONSTRUCTOR_MAX_ROW_GAP_SEED 2		//Same, but during fit of seed
 #define GPUCA_MERGER_MAXN_MISSED_HARD 10			//Hard limit for number of missed rows in fit / propagation
@@ -50,11 +56,19 @@
 //#define GPUCA_MERGER_BY_MC_LABEL
 #define REPRODUCIBLE_CLUSTER_SORTING
 
-#ifdef GPUCA_O2_LIB
-typedef unsigned int calink;
-typedef unsigned int cahit;
+//Precision of the slice data, can be selected per build:
+//calink: index of a hit inside a row / of a grid bin, limits the number of hits and bins per row
+//cahit: fixed point y / z coordinate of a hit relative to the row grid (at most 24 bits are used, to stay within float precision)
+//The 16 bit versions need half the memory / bandwidth in the neighbours finder and tracklet constructor, but support at most 65534 hits per row
+//The build option GPUCA_COMPACT_LINKS selects 16 bit calink, GPUCA_COMPACT_HITS selects 16 bit cahit (CONFIG_COMPACT_LINKS / CONFIG_COMPACT_HITS in the standalone build)
+#ifdef GPUCA_COMPACT_LINKS
+typedef unsigned short calink;
 #else
 typedef unsigned int calink;
+#endif
+#ifdef GPUCA_COMPACT_HITS
+typedef unsigned short cahit;
+#else
 typedef unsigned int cahit;
 #endif
 
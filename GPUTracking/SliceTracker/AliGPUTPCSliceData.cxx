@@ -40,6 +40,51 @@ static inline float fastInvSqrt(float _x)
 	return x.f;
 }
 
+//Access to the row, y and z of the input clusters, for both the record and the column-wise layout
+struct ClusterAccessAoS
+{
+	const AliGPUTPCClusterData* fData;
+	inline int Row(int i) const {return fData[i].fRow;}
+	inline float Y(int i) const {return fData[i].fY;}
+	inline float Z(int i) const {return fData[i].fZ;}
+};
+
+struct ClusterAccessSoA
+{
+	const AliGPUTPCClusterDataSoA* fData;
+	inline int Row(int i) const {return fData->fRow[i];}
+	inline float Y(int i) const {return fData->fY[i];}
+	inline float Z(int i) const {return fData->fZ[i];}
+};
+
+template <class T> static inline void CountClustersInRows(const T& cl, int nClusters, int* nClustersInRow, int& firstRow, int& lastRow)
+{
+	for (int i = 0; i < nClusters; i++)
+	{
+		const int tmpRow = cl.Row(i);
+		nClustersInRow[tmpRow]++;
+		if (tmpRow > lastRow) lastRow = tmpRow;
+		if (tmpRow < firstRow) firstRow = tmpRow;
+	}
+}
+
+template <class T> static inline void SortClustersByRow(const T& cl, int nClusters, const int* rowOffset, float2* YZData, int* tmpHitIndex, float& maxZ)
+{
+	int RowsFilled[GPUCA_ROW_COUNT];
+	memset(RowsFilled, 0, GPUCA_ROW_COUNT * sizeof(int));
+	for (int i = 0; i < nClusters; i++)
+	{
+		float2 tmp;
+		tmp.x = cl.Y(i);
+		tmp.y = cl.Z(i);
+		if (fabsf(tmp.y) > maxZ) maxZ = fabsf(tmp.y);
+		int tmpRow = cl.Row(i);
+		int newIndex = rowOffset[tmpRow] + (RowsFilled[tmpRow])++;
+		YZData[newIndex] = tmp;
+		tmpHitIndex[newIndex] = i;
+	}
+}
+
 inline void AliGPUTPCSliceData::CreateGrid(AliGPUTPCRow *row, const float2 *data, int ClusterDataHitNumberOffset)
 {
 	// grid creation
@@ -71,10 +116,52 @@ inline void AliGPUTPCSliceData::CreateGrid(AliGPUTPCRow *row, const float2 *data
 		tfFactor = dz / 250.;
 		dz = 250.;
 	}
-	const float norm = fastInvSqrt(row->fNHits / tfFactor);
-	row->fGrid.Create(yMin, yMax, zMin, zMax,
-	                  CAMath::Max((yMax - yMin) * norm, 2.f),
-	                  CAMath::Max(dz * norm, 2.f));
+	float norm = fastInvSqrt(row->fNHits / tfFactor);
+	float stepY = CAMath::Max((yMax - yMin) * norm, 2.f);
+	float stepZ = CAMath::Max(dz * norm, 2.f);
+
+	// The bin size above assumes the hits to be distributed uniformly over the row, yielding about 1 hit per bin.
+	// Measure the fraction of the row that is actually occupied with a coarse histogram and shrink the bins accordingly,
+	// such that densely populated regions (e.g. in continuous data) do not end up with many hits per bin.
+	static const int kMaxCells = 32;
+	const int nCells = CAMath::Max(1, CAMath::Min(kMaxCells, (int) CAMath::Sqrt((float) row->fNHits / GPUCA_GRID_DENSITY_CELL_HITS)));
+	if (nCells > 1)
+	{
+		int count[kMaxCells * kMaxCells] = {0};
+		const float cellYInv = nCells / CAMath::Max(yMax - yMin, 1.e-3f) * 0.9999f;
+		const float cellZInv = nCells / CAMath::Max(zMax - zMin, 1.e-3f) * 0.9999f;
+		for (int i = ClusterDataHitNumberOffset; i < ClusterDataHitNumberOffset + row->fNHits; ++i)
+		{
+			count[(int) ((data[i].y - zMin) * cellZInv) * nCells + (int) ((data[i].x - yMin) * cellYInv)]++;
+		}
+		// Occupied fraction from the second moment of the cell counts, n * (n - 1) removes the Poisson bias so that a uniform distribution yields 1
+		double sum2 = 0.;
+		for (int i = 0; i < nCells * nCells; i++)
+		{
+			sum2 += (double) count[i] * (count[i] - 1);
+		}
+		if (sum2 > 0.)
+		{
+			const float occupiedFraction = CAMath::Max(1.f / (nCells * nCells), CAMath::Min(1.f, (float) ((double) row->fNHits * row->fNHits / (nCells * nCells * sum2))));
+			norm *= CAMath::Sqrt(occupiedFraction);
+			// The finer bins are limited to GPUCA_GRID_MAX_BINS_PER_HIT bins per hit, for which fFirstHitInBin is sized.
+			// Coarsen them if needed, but never beyond the uniform bins.
+			float stepYFine = CAMath::Max((yMax - yMin) * norm, 2.f);
+			float stepZFine = CAMath::Max(dz * norm, 2.f);
+			while ((float) (int) ((yMax - yMin) / stepYFine + 1.f) * (float) (int) ((zMax - zMin) / stepZFine + 1.f) > GPUCA_GRID_MAX_BINS_PER_HIT * row->fNHits)
+			{
+				stepYFine *= 1.1f;
+				stepZFine *= 1.1f;
+			}
+			if (stepYFine <= stepY && stepZFine <= stepZ)
+			{
+				stepY = stepYFine;
+				stepZ = stepZFine;
+			}
+		}
+	}
+
+	row->fGrid.Create(yMin, yMax, zMin, zMax, stepY, stepZ);
 }
 
 inline int AliGPUTPCSliceData::PackHitData(AliGPUTPCRow *const row, const AliGPUTPCHit* binSortedHits)
@@ -135,6 +222,15 @@ void AliGPUTPCSliceData::InitializeRows(const AliGPUParam &p)
 void AliGPUTPCSliceData::SetClusterData(const AliGPUTPCClusterData *data, int nClusters, int clusterIdOffset)
 {
 	fClusterData = data;
+	fClusterDataSoA = nullptr;
+	fNumberOfHits = nClusters;
+	fClusterIdOffset = clusterIdOffset;
+}
+
+void AliGPUTPCSliceData::SetClusterData(const AliGPUTPCClusterDataSoA *data, int nClusters, int clusterIdOffset)
+{
+	fClusterData = nullptr;
+	fClusterDataSoA = data;
 	fNumberOfHits = nClusters;
 	fClusterIdOffset = clusterIdOffset;
 }
@@ -146,11 +242,17 @@ void AliGPUTPCSliceData::SetMaxData()
 	fNumberOfHitsPlusAlign = nextMultipleOf<(kVectorAlignment > sizeof(GPUCA_ROWALIGNMENT) ? kVectorAlignment : sizeof(GPUCA_ROWALIGNMENT)) / sizeof(int)>(hitMemCount);
 }
 
+int AliGPUTPCSliceData::FirstHitInBinSize() const
+{
+	//A row needs grid.N() + grid.Ny() + 3 entries plus alignment, with grid.Ny() <= grid.N().
+	//The uniform grid has at most about nHits + 2 * sqrt(nHits) + 1 bins, CreateGrid limits the grid adapted to the hit density to GPUCA_GRID_MAX_BINS_PER_HIT * nHits bins.
+	return (23 + sizeof(GPUCA_ROWALIGNMENT) / sizeof(int)) * GPUCA_ROW_COUNT + 2 * GPUCA_GRID_MAX_BINS_PER_HIT * fNumberOfHits + 3;
+}
+
 void* AliGPUTPCSliceData::SetPointersInput(void* mem)
 {
-	const int firstHitInBinSize = (23 + sizeof(GPUCA_ROWALIGNMENT) / sizeof(int)) * GPUCA_ROW_COUNT + 4 * fNumberOfHits + 3;
 	computePointerWithAlignment(mem, fHitData, fNumberOfHitsPlusAlign);
-	computePointerWithAlignment(mem, fFirstHitInBin, firstHitInBinSize);
+	computePointerWithAlignment(mem, fFirstHitInBin, FirstHitInBinSize());
 	if (mRec->GetRecoStepsGPU() & AliGPUReconstruction::RecoStep::TPCMerging)
 	{
 		mem = SetPointersScratchHost(mem);
@@ -203,19 +305,14 @@ int AliGPUTPCSliceData::InitFromClusterData()
 	fFirstRow = GPUCA_ROW_COUNT;
 	fLastRow = 0;
 
-	for (int i = 0; i < fNumberOfHits; i++)
-	{
-		const int tmpRow = fClusterData[i].fRow;
-		NumberOfClustersInRow[tmpRow]++;
-		if (tmpRow > fLastRow) fLastRow = tmpRow;
-		if (tmpRow < fFirstRow) fFirstRow = tmpRow;
-	}
+	if (fClusterData) CountClustersInRows(ClusterAccessAoS{fClusterData}, fNumberOfHits, NumberOfClustersInRow, fFirstRow, fLastRow);
+	else CountClustersInRows(ClusterAccessSoA{fClusterDataSoA}, fNumberOfHits, NumberOfClustersInRow, fFirstRow, fLastRow);
 	int tmpOffset = 0;
 	for (int i = fFirstRow; i <= fLastRow; i++)
 	{
-		if ((long long int) NumberOfClustersInRow[i] >= ((long long int) 1 << (sizeof(calink) * 8)))
+		if ((long long int) NumberOfClustersInRow[i] >= ((long long int) 1 << (sizeof(calink) * 8)) - 1) //Last index is reserved for CALINK_INVAL
 		{
-			printf("Too many clusters in row %d for row indexing (%d >= %lld), indexing insufficient\n", i, NumberOfClustersInRow[i], ((long long int) 1 << (sizeof(calink) * 8)));
+			printf("Too many clusters in row %d for row indexing (%d >= %lld), indexing insufficient, build with 32 bit calink (without GPUCA_COMPACT_LINKS)\n", i, NumberOfClustersInRow[i], ((long long int) 1 << (sizeof(calink) * 8)) - 1);
 			return (1);
 		}
 		if (NumberOfClustersInRow[i] >= (1 << 24))
@@ -227,21 +324,8 @@ int AliGPUTPCSliceData::InitFromClusterData()
 		tmpOffset += NumberOfClustersInRow[i];
 	}
 
-	{
-		int RowsFilled[GPUCA_ROW_COUNT];
-		memset(RowsFilled, 0, GPUCA_ROW_COUNT * sizeof(int));
-		for (int i = 0; i < fNumberOfHits; i++)
-		{
-			float2 tmp;
-			tmp.x = fClusterData[i].fY;
-			tmp.y = fClusterData[i].fZ;
-			if (fabsf(tmp.y) > fMaxZ) fMaxZ = fabsf(tmp.y);
-			int tmpRow = fClusterData[i].fRow;
-			int newIndex = RowOffset[tmpRow] + (RowsFilled[tmpRow])++;
-			YZData[newIndex] = tmp;
-			tmpHitIndex[newIndex] = i;
-		}
-	}
+	if (fClusterData) SortClustersByRow(ClusterAccessAoS{fClusterData}, fNumberOfHits, RowOffset, YZData, tmpHitIndex, fMaxZ);
+	else SortClustersByRow(ClusterAccessSoA{fClusterDataSoA}, fNumberOfHits, RowOffset, YZData, tmpHitIndex, fMaxZ);
 	if (fFirstRow == GPUCA_ROW_COUNT) fFirstRow = 0;
 
 	////////////////////////////////////
@@ -309,6 +393,13 @@ int AliGPUTPCSliceData::InitFromClusterData()
 			delete[] tmpHitIndex;
 			return (1);
 		}
+		if ((int) row.fFirstHitInBinOffset + numberOfBins + (int) grid.Ny() + 3 > FirstHitInBinSize())
+		{
+			printf("Too many bins in row %d for the grid buffer (%d bins at offset %d, size %d)\n", rowIndex, numberOfBins, (int) row.fFirstHitInBinOffset, FirstHitInBinSize());
+			delete[] YZData;
+			delete[] tmpHitIndex;
+			return (1);
+		}
 
 		int binCreationMemorySizeNew = numberOfBins * 2 + 6 + row.fNHits + sizeof(GPUCA_ROWALIGNMENT) / sizeof(unsigned short) * numberOfRows + 1;
 		if (binCreationMemorySizeNew > binCreationMemorySize)
@@ -368,7 +459,7 @@ int AliGPUTPCSliceData::InitFromClusterData()
 			fFirstHitInBin[row.fFirstHitInBinOffset + i] = c[i]; // global bin-sorted hit index
 		}
 		const calink a = c[numberOfBins];
-		// grid.N is <= row.fNHits
+		// The size of fFirstHitInBin was checked above
 		const int nn = numberOfBins + grid.Ny() + 3;
 		for (int i = numberOfBins; i < nn; ++i)
 		{
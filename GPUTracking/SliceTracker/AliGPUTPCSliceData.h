@@ -26,6 +26,7 @@
 #include "AliGPUMemoryResource.h"
 
 struct AliGPUTPCClusterData;
+struct AliGPUTPCClusterDataSoA;
 class AliGPUTPCHit;
 
 MEM_CLASS_PRE() class AliGPUTPCSliceData : public AliGPUProcessor
@@ -35,7 +36,7 @@ public:
 		AliGPUProcessor(),
 		mMemoryResInput(-1), mMemoryResScratch(-1), mMemoryResScratchHost(-1), mMemoryResRows(-1),
 		fFirstRow(0), fLastRow(GPUCA_ROW_COUNT - 1), fNumberOfHits(0), fNumberOfHitsPlusAlign(0), fClusterIdOffset(0), fMaxZ(0.f),
-		fGPUTextureBase(0), fRows(0), fLinkUpData(0), fLinkDownData(0), fClusterData(0)
+		fGPUTextureBase(0), fRows(0), fLinkUpData(0), fLinkDownData(0), fClusterData(0), fClusterDataSoA(0)
 	{
 	}
 
@@ -53,6 +54,7 @@ public:
 
 	void SetMaxData();
 	void SetClusterData(const AliGPUTPCClusterData *data, int nClusters, int clusterIdOffset);
+	void SetClusterData(const AliGPUTPCClusterDataSoA *data, int nClusters, int clusterIdOffset);
 	void* SetPointersInput(void* mem);
 	void* SetPointersScratch(void* mem);
 	void* SetPointersScratchHost(void* mem);
@@ -134,6 +136,7 @@ public:
 
 #if !defined(__OPENCL__)
     GPUhi() const AliGPUTPCClusterData* ClusterData() const {return fClusterData;}
+    GPUhi() const AliGPUTPCClusterDataSoA* ClusterDataSoA() const {return fClusterDataSoA;}
 #endif
 
 	float MaxZ() const { return fMaxZ; }
@@ -144,6 +147,7 @@ public:
 
 #ifndef GPUCA_GPUCODE
 	void CreateGrid(AliGPUTPCRow *row, const float2* data, int ClusterDataHitNumberOffset );
+	int FirstHitInBinSize() const;
 	int PackHitData(AliGPUTPCRow *row, const AliGPUTPCHit* binSortedHits );
 #endif
 
@@ -181,6 +185,7 @@ public:
 	GPUglobalref() GPUAtomic(int) *fHitWeights;          // the weight of the longest tracklet crossed the cluster
 
 	GPUglobalref() const AliGPUTPCClusterData *fClusterData;
+	GPUglobalref() const AliGPUTPCClusterDataSoA *fClusterDataSoA; // column-wise input, used if fClusterData is not set
 };
 
 MEM_CLASS_PRE() MEM_TEMPLATE() GPUdi() calink MEM_LG(AliGPUTPCSliceData)::HitLinkUpData  ( const MEM_TYPE(AliGPUTPCRow) &row, const calink &hitIndex ) const
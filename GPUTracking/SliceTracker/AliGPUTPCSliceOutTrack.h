@@ -20,7 +20,7 @@
  * The class contains:
  * - fitted track parameters at its first row, the covariance matrix, \Chi^2, NDF (number of degrees of freedom )
  * - n of clusters assigned to the track
- * - clusters in corresponding cluster arrays
+ * - clusters in corresponding cluster arrays, or only the indices of the clusters in the input cluster data of the slice
  *
  * The class is used to transport the data between AliGPUTPCTracker{Component} and AliGPUTPCGBMerger{Component}
  *
@@ -33,23 +33,26 @@ class AliGPUTPCSliceOutTrack
 	GPUhd() const AliGPUTPCSliceOutCluster &Cluster(int i) const { return fClusters[i]; }
 	GPUhd() const AliGPUTPCSliceOutCluster *Clusters() const { return fClusters; }
 
+	GPUhd() unsigned int ClusterIndex(int i) const { return reinterpret_cast<const unsigned int *>(fClusters)[i]; }
+
 	GPUhd() void SetNClusters(int v) { fNClusters = v; }
 	GPUhd() void SetParam(const AliGPUTPCBaseTrackParam &v) { fParam = v; }
 	GPUhd() void SetCluster(int i, const AliGPUTPCSliceOutCluster &v) { fClusters[i] = v; }
+	GPUhd() void SetClusterIndex(int i, unsigned int v) { reinterpret_cast<unsigned int *>(fClusters)[i] = v; }
 
-	GPUhd() static int GetSize(int nClust) { return sizeof(AliGPUTPCSliceOutTrack) + nClust * sizeof(AliGPUTPCSliceOutCluster); }
+	GPUhd() static int GetSize(int nClust, bool clusterIndex = false) { return sizeof(AliGPUTPCSliceOutTrack) + nClust * (clusterIndex ? sizeof(unsigned int) : sizeof(AliGPUTPCSliceOutCluster)); }
 
 	GPUhd() int LocalTrackId() const { return fLocalTrackId; }
 	GPUhd() void SetLocalTrackId(int v) { fLocalTrackId = v; }
 
-	GPUhd() AliGPUTPCSliceOutTrack *NextTrack()
+	GPUhd() AliGPUTPCSliceOutTrack *NextTrack(bool clusterIndex = false)
 	{
-		return (AliGPUTPCSliceOutTrack *) (((char *) this) + GetSize(fNClusters));
+		return (AliGPUTPCSliceOutTrack *) (((char *) this) + GetSize(fNClusters, clusterIndex));
 	}
 
-	GPUhd() const AliGPUTPCSliceOutTrack *GetNextTrack() const
+	GPUhd() const AliGPUTPCSliceOutTrack *GetNextTrack(bool clusterIndex = false) const
 	{
-		return (AliGPUTPCSliceOutTrack *) (((char *) this) + GetSize(fNClusters));
+		return (AliGPUTPCSliceOutTrack *) (((char *) this) + GetSize(fNClusters, clusterIndex));
 	}
 
   private:
@@ -21,17 +21,17 @@
 #include "AliGPUTPCSliceOutput.h"
 #include "AliGPUCommonMath.h"
 
-unsigned int AliGPUTPCSliceOutput::EstimateSize(unsigned int nOfTracks, unsigned int nOfTrackClusters)
+unsigned int AliGPUTPCSliceOutput::EstimateSize(unsigned int nOfTracks, unsigned int nOfTrackClusters, bool clusterIndex)
 {
 	// calculate the amount of memory [bytes] needed for the event
-	return sizeof(AliGPUTPCSliceOutput) + sizeof(AliGPUTPCSliceOutTrack) * nOfTracks + sizeof(AliGPUTPCSliceOutCluster) * nOfTrackClusters;
+	return sizeof(AliGPUTPCSliceOutput) + sizeof(AliGPUTPCSliceOutTrack) * nOfTracks + (clusterIndex ? sizeof(unsigned int) : sizeof(AliGPUTPCSliceOutCluster)) * nOfTrackClusters;
 }
 
 #ifndef GPUCA_GPUCODE
-void AliGPUTPCSliceOutput::Allocate(AliGPUTPCSliceOutput* &ptrOutput, int nTracks, int nTrackHits, AliGPUOutputControl *outputControl, void* &internalMemory)
+void AliGPUTPCSliceOutput::Allocate(AliGPUTPCSliceOutput* &ptrOutput, int nTracks, int nTrackHits, AliGPUOutputControl *outputControl, void* &internalMemory, bool clusterIndex)
 {
 	//Allocate All memory needed for slice output
-	const size_t memsize = EstimateSize(nTracks, nTrackHits);
+	const size_t memsize = EstimateSize(nTracks, nTrackHits, clusterIndex);
 
 	if (outputControl->OutputType != AliGPUOutputControl::AllocateInternal)
 	{
@@ -51,5 +51,6 @@ void AliGPUTPCSliceOutput::Allocate(AliGPUTPCSliceOutput* &ptrOutput, int nTrack
 		ptrOutput = (AliGPUTPCSliceOutput *) internalMemory;
 	}
 	ptrOutput->SetMemorySize(memsize);
+	ptrOutput->SetClusterIndexOutput(clusterIndex);
 }
 #endif
@@ -32,7 +32,8 @@ struct AliGPUOutputControl;
  *
  * The class contains all the necessary information about TPC tracks, reconstructed in one slice.
  * This includes the reconstructed track parameters and some compressed information
- * about the assigned clusters: clusterId, position and amplitude.
+ * about the assigned clusters: clusterId, position and amplitude,
+ * or only the indices of the clusters in the input cluster data if the output is created with clusterIndex.
  *
  */
 class AliGPUTPCSliceOutput
@@ -45,6 +46,7 @@ class AliGPUTPCSliceOutput
 	}
 	GPUhd() unsigned int NLocalTracks() const { return fNLocalTracks; }
 	GPUhd() unsigned int NTrackClusters() const { return fNTrackClusters; }
+	GPUhd() bool ClusterIndexOutput() const { return fClusterIndexOutput; }
 #ifndef GPUCA_GPUCODE
 	GPUhd() const AliGPUTPCSliceOutTrack *GetFirstTrack() const
 	{
@@ -57,8 +59,8 @@ class AliGPUTPCSliceOutput
 		return (fMemorySize);
 	}
 
-	static unsigned int EstimateSize(unsigned int nOfTracks, unsigned int nOfTrackClusters);
-	static void Allocate(AliGPUTPCSliceOutput* &ptrOutput, int nTracks, int nTrackHits, AliGPUOutputControl *outputControl, void* &internalMemory);
+	static unsigned int EstimateSize(unsigned int nOfTracks, unsigned int nOfTrackClusters, bool clusterIndex = false);
+	static void Allocate(AliGPUTPCSliceOutput* &ptrOutput, int nTracks, int nTrackHits, AliGPUOutputControl *outputControl, void* &internalMemory, bool clusterIndex = false);
 
 	GPUhd() void SetNTracks(unsigned int v) { fNTracks = v; }
 	GPUhd() void SetNLocalTracks(unsigned int v) { fNLocalTracks = v; }
@@ -66,17 +68,19 @@ class AliGPUTPCSliceOutput
 
   private:
 	AliGPUTPCSliceOutput()
-	    : fNTracks(0), fNLocalTracks(0), fNTrackClusters(0), fMemorySize(0) {}
+	    : fNTracks(0), fNLocalTracks(0), fNTrackClusters(0), fClusterIndexOutput(0), fMemorySize(0) {}
 
 	~AliGPUTPCSliceOutput() {}
 	AliGPUTPCSliceOutput(const AliGPUTPCSliceOutput &);
 	AliGPUTPCSliceOutput &operator=(const AliGPUTPCSliceOutput &) { return *this; }
 
 	GPUh() void SetMemorySize(size_t val) { fMemorySize = val; }
+	GPUh() void SetClusterIndexOutput(bool v) { fClusterIndexOutput = v; }
 
 	unsigned int fNTracks; // number of reconstructed tracks
 	unsigned int fNLocalTracks;
 	unsigned int fNTrackClusters; // total number of track clusters
+	unsigned int fClusterIndexOutput; // the tracks store the indices of their clusters in the input cluster data instead of the clusters
 	size_t fMemorySize;  // Amount of memory really used
 
 	//Must be last element of this class, user has to make sure to allocate anough memory consecutive to class memory!
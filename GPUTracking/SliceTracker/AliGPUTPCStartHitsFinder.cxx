@@ -44,13 +44,13 @@ template <> GPUd() void AliGPUTPCStartHitsFinder::Thread<0>(int /*nBlocks*/, int
 		if (tracker.HitLinkDownData(row, ih) == CALINK_INVAL && tracker.HitLinkUpData(row, ih) != CALINK_INVAL && tracker.HitLinkUpData(rowUp, tracker.HitLinkUpData(row, ih)) != CALINK_INVAL)
 		{
 #ifdef GPUCA_SORT_STARTHITS
-			GPUglobalref() AliGPUTPCHitId *const startHits = tracker.TrackletTmpStartHits() + s.fIRow * GPUCA_MAX_ROWSTARTHITS;
+			GPUglobalref() AliGPUTPCHitId *const startHits = tracker.TrackletTmpStartHits() + s.fIRow * tracker.NMaxRowStartHits();
 			int nextRowStartHits = CAMath::AtomicAddShared(&s.fNRowStartHits, 1);
-			if (nextRowStartHits >= GPUCA_MAX_ROWSTARTHITS)
+			if (nextRowStartHits >= tracker.NMaxRowStartHits())
 #else
 			GPUglobalref() AliGPUTPCHitId *const startHits = tracker.TrackletStartHits();
 			int nextRowStartHits = CAMath::AtomicAdd(tracker.NTracklets(), 1);
-			if (nextRowStartHits >= GPUCA_MAX_TRACKLETS)
+			if (nextRowStartHits >= tracker.NMaxTracklets())
 #endif
 			{
 				tracker.GPUParameters()->fGPUError = GPUCA_ERROR_TRACKLET_OVERFLOW;
@@ -68,7 +68,7 @@ template <> GPUd() void AliGPUTPCStartHitsFinder::Thread<0>(int /*nBlocks*/, int
 		int nOffset = CAMath::AtomicAdd(tracker.NTracklets(), s.fNRowStartHits);
 #ifdef GPUCA_GPUCODE
 		tracker.RowStartHitCountOffset()[s.fIRow] = s.fNRowStartHits;
-		if (nOffset + s.fNRowStartHits >= GPUCA_MAX_TRACKLETS)
+		if (nOffset + s.fNRowStartHits > tracker.NMaxTracklets())
 		{
 			tracker.GPUParameters()->fGPUError = GPUCA_ERROR_TRACKLET_OVERFLOW;
 			CAMath::AtomicExch(tracker.NTracklets(), 0);
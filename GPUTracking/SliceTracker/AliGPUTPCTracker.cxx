@@ -52,9 +52,11 @@ AliGPUTPCTracker::AliGPUTPCTracker() :
 	fISlice(-1),
 	fData(),
 	fNMaxStartHits( 0 ),
+	fNMaxRowStartHits( 0 ),
 	fNMaxTracklets( 0 ),
 	fNMaxTracks( 0 ),
 	fNMaxTrackHits( 0 ),
+	fCapacityScale( 1.f ),
 	mMemoryResScratch( -1 ),
 	mMemoryResScratchHost( -1 ),
 	mMemoryResCommon( -1 ),
@@ -69,15 +71,20 @@ AliGPUTPCTracker::AliGPUTPCTracker() :
 	fTrackletStartHits( nullptr ),
 	fTracklets( nullptr ),
 	fTrackletRowHits( nullptr ),
+	fGlobalTrackingTracklets( nullptr ),
+	fGlobalTrackingRowHits( nullptr ),
 	fTracks( nullptr ),
 	fTrackHits( nullptr ),
 	fOutput( nullptr ),
-	fOutputMemory(nullptr)
+	fOutputMemory(nullptr),
+	fTrackSortMemory(nullptr),
+	fTrackSortMemorySize(0)
 {}
 	
 AliGPUTPCTracker::~AliGPUTPCTracker()
 {
 	if (fOutputMemory) free(fOutputMemory);
+	if (fTrackSortMemory) free(fTrackSortMemory);
 }
 
 // ----------------------------------------------------------------------------------
@@ -101,7 +108,7 @@ void* AliGPUTPCTracker::SetPointersScratch(void* mem)
 	}
 	if (mRec->IsGPU())
 	{
-		computePointerWithAlignment(mem, fTrackletTmpStartHits, GPUCA_ROW_COUNT * GPUCA_MAX_ROWSTARTHITS);
+		computePointerWithAlignment(mem, fTrackletTmpStartHits, GPUCA_ROW_COUNT * fNMaxRowStartHits);
 		computePointerWithAlignment(mem, fRowStartHitCountOffset, GPUCA_ROW_COUNT);
 	}
 	return mem;
@@ -110,6 +117,12 @@ void* AliGPUTPCTracker::SetPointersScratch(void* mem)
 void* AliGPUTPCTracker::SetPointersScratchHost(void* mem)
 {
 	computePointerWithAlignment(mem, fLinkTmpMemory, mRec->Res(fData.MemoryResScratch()).Size());
+	//The global tracking runs on the host, it collects the hits of the prolonged tracks in its own tracklet slots
+#ifdef EXTERN_ROW_HITS
+	computePointerWithAlignment(mem, fGlobalTrackingRowHits, GLOBAL_TRACKING_SLOTS * GPUCA_ROW_COUNT);
+#else
+	computePointerWithAlignment(mem, fGlobalTrackingTracklets, GLOBAL_TRACKING_SLOTS);
+#endif
 	return mem;
 }
 
@@ -158,21 +171,32 @@ GPUhd() void* AliGPUTPCTracker::SetPointersTrackHits(void* mem)
 
 void AliGPUTPCTracker::SetMaxData()
 {
-	fNMaxStartHits = fData.NumberOfHits();
-	fNMaxTracklets = GPUCA_MAX_TRACKLETS;
-	fNMaxTracks = GPUCA_MAX_TRACKS;
-	fNMaxTrackHits = fData.NumberOfHits() + 1000;
+	//Estimate the buffer sizes from the number of clusters in the slice.
+	//There cannot be more start hits (and thus tracklets) than clusters, so the estimates never exceed this bound.
+	const int nHits = fData.NumberOfHits();
+	fNMaxStartHits = nHits;
+	fNMaxRowStartHits = CAMath::Min(nHits, CAMath::Max(GPUCA_MIN_ROWSTARTHITS, (int) (nHits * GPUCA_ROWSTARTHITS_PER_HIT * fCapacityScale)));
+	fNMaxTracklets = CAMath::Min(nHits, CAMath::Max(GPUCA_MIN_TRACKLETS, (int) (nHits * GPUCA_TRACKLETS_PER_HIT * fCapacityScale)));
+	fNMaxTracks = CAMath::Min(GPUCA_MAX_TRACKS, CAMath::Max(GPUCA_MIN_TRACKS, (int) (nHits * GPUCA_TRACKS_PER_HIT * fCapacityScale)));
+	fNMaxTrackHits = (int) ((nHits + 1000) * fCapacityScale);
+	if (mRec->GetDeviceProcessingSettings().memoryAllocationStrategy == AliGPUMemoryResource::ALLOCATION_INDIVIDUAL)
+	{
+		//Tracklets are allocated after the start hits are counted, see UpdateMaxData
+		fNMaxTracklets = fNMaxStartHits;
+	}
 	if (mRec->IsGPU())
 	{
-		if (fNMaxStartHits > GPUCA_MAX_ROWSTARTHITS * GPUCA_ROW_COUNT) fNMaxStartHits = GPUCA_MAX_ROWSTARTHITS * GPUCA_ROW_COUNT;
+		if (fNMaxStartHits > fNMaxRowStartHits * GPUCA_ROW_COUNT) fNMaxStartHits = fNMaxRowStartHits * GPUCA_ROW_COUNT;
+		if (fNMaxTracklets > fNMaxStartHits) fNMaxTracklets = fNMaxStartHits;
 	}
 }
 
 void AliGPUTPCTracker::UpdateMaxData()
 {
+	//Second pass, size the buffers by the number of start hits found
 	fNMaxTracklets = fCommonMem->fNTracklets * 2;
-	fNMaxTracks = fCommonMem->fNTracklets * 2 + 50;
-	fNMaxTrackHits = fNMaxStartHits * 2;
+	fNMaxTracks = CAMath::Min(GPUCA_MAX_TRACKS, (int) ((fCommonMem->fNTracklets * 2 + 50) * fCapacityScale));
+	fNMaxTrackHits = (int) (fNMaxStartHits * 2 * fCapacityScale);
 }
 
 void AliGPUTPCTracker::SetupCommonMemory()
@@ -198,6 +222,7 @@ int AliGPUTPCTracker::ReadEvent()
 	if (mRec->GetDeviceProcessingSettings().memoryAllocationStrategy == AliGPUMemoryResource::ALLOCATION_INDIVIDUAL)
 	{
 		fNMaxStartHits = fData.NumberOfHits();
+		fNMaxTracklets = fNMaxStartHits;
 	}
 	return 0;
 }
@@ -207,7 +232,7 @@ GPUh() int AliGPUTPCTracker::CheckEmptySlice()
 	//Check if the Slice is empty, if so set the output apropriate and tell the reconstuct procesdure to terminate
 	if ( NHitsTotal() < 1 )
 	{
-		fCommonMem->fNTracks = fCommonMem->fNTrackHits = 0;
+		fCommonMem->fNTracklets = fCommonMem->fNTracks = fCommonMem->fNTrackHits = 0;
 		WriteOutputPrepare();
 		fOutput->SetNTracks( 0 );
 		fOutput->SetNTrackClusters( 0 );
@@ -218,12 +243,34 @@ GPUh() int AliGPUTPCTracker::CheckEmptySlice()
 
 GPUh() void AliGPUTPCTracker::WriteOutputPrepare()
 {
-	AliGPUTPCSliceOutput::Allocate(fOutput, fCommonMem->fNTracks, fCommonMem->fNTrackHits, &mRec->OutputControl(), fOutputMemory);
+	AliGPUTPCSliceOutput::Allocate(fOutput, fCommonMem->fNTracks, fCommonMem->fNTrackHits, &mRec->OutputControl(), fOutputMemory, mRec->GetDeviceProcessingSettings().sliceOutputClusterIndex);
+}
+
+GPUh() void AliGPUTPCTracker::GetOutputCluster(AliGPUTPCSliceOutCluster &c, unsigned int clusterIndex) const
+{
+	if (fData.ClusterData())
+	{
+		const AliGPUTPCClusterData &cl = fData.ClusterData()[clusterIndex];
+		c.Set( cl.fId, cl.fRow, cl.fFlags, cl.fAmp, cl.fX, cl.fY, cl.fZ );
+#ifdef GMPropagatePadRowTime
+		c.fPad = cl.fPad;
+		c.fTime = cl.fTime;
+#endif
+	}
+	else
+	{
+		const AliGPUTPCClusterDataSoA &cl = *fData.ClusterDataSoA();
+		c.Set( cl.fId[clusterIndex], cl.fRow[clusterIndex], cl.fFlags[clusterIndex], cl.fAmp[clusterIndex], cl.fX[clusterIndex], cl.fY[clusterIndex], cl.fZ[clusterIndex] );
+#ifdef GMPropagatePadRowTime
+		c.fPad = cl.fPad[clusterIndex];
+		c.fTime = cl.fTime[clusterIndex];
+#endif
+	}
 }
 
 template <class T> static inline bool SortComparison(const T& a, const T& b)
 {
-	return(a.fSortVal < b.fSortVal);
+	return(a.fSortVal < b.fSortVal || (a.fSortVal == b.fSortVal && a.fFirstHit < b.fFirstHit));
 }
 
 GPUh() void AliGPUTPCTracker::WriteOutput()
@@ -244,12 +291,21 @@ GPUh() void AliGPUTPCTracker::WriteOutput()
 	int nStoredLocalTracks = 0;
 
 	AliGPUTPCSliceOutTrack *out = fOutput->FirstTrack();
+	const bool clusterIndexOutput = fOutput->ClusterIndexOutput();
 	
-	trackSortData* trackOrder = new trackSortData[fCommonMem->fNTracks];
+	if (fCommonMem->fNTracks > fTrackSortMemorySize)
+	{
+		if (fTrackSortMemory) free(fTrackSortMemory);
+		fTrackSortMemorySize = fCommonMem->fNTracks;
+		fTrackSortMemory = (trackSortData*) malloc(fTrackSortMemorySize * sizeof(trackSortData));
+	}
+	trackSortData* trackOrder = fTrackSortMemory;
 	for (int i = 0;i < fCommonMem->fNTracks;i++)
 	{
+		const AliGPUTPCHitId &firstHit = fTrackHits[fTracks[i].FirstHitID()];
 		trackOrder[i].fTtrack = i;
-		trackOrder[i].fSortVal = fTracks[trackOrder[i].fTtrack].NHits() / 1000.f + fTracks[trackOrder[i].fTtrack].Param().GetZ() * 100.f + fTracks[trackOrder[i].fTtrack].Param().GetY();
+		trackOrder[i].fSortVal = fTracks[i].NHits() / 1000.f + fTracks[i].Param().GetZ() * 100.f + fTracks[i].Param().GetY();
+		trackOrder[i].fFirstHit = ((unsigned int) firstHit.RowIndex() << 24) | firstHit.HitIndex();
 	}
 	std::sort(trackOrder, trackOrder + fCommonMem->fNLocalTracks, SortComparison<trackSortData>);
 	std::sort(trackOrder + fCommonMem->fNLocalTracks, trackOrder + fCommonMem->fNTracks, SortComparison<trackSortData>);
@@ -290,19 +346,16 @@ GPUh() void AliGPUTPCTracker::WriteOutput()
 			}
 #endif
 
-			float origX = fData.ClusterData()[clusterIndex].fX;
-			float origY = fData.ClusterData()[clusterIndex].fY;
-			float origZ = fData.ClusterData()[clusterIndex].fZ;
-			int id = fData.ClusterData()[clusterIndex].fId;
-			unsigned char flags = fData.ClusterData()[clusterIndex].fFlags;
-			unsigned short amp = fData.ClusterData()[clusterIndex].fAmp;
-			AliGPUTPCSliceOutCluster c;
-			c.Set( id, iRow, flags, amp, origX, origY, origZ );
-#ifdef GMPropagatePadRowTime
-			c.fPad = fData.ClusterData()[clusterIndex].fPad;
-			c.fTime = fData.ClusterData()[clusterIndex].fTime;
-#endif
-			out->SetCluster( nClu, c );
+			if (clusterIndexOutput)
+			{
+				out->SetClusterIndex( nClu, clusterIndex );
+			}
+			else
+			{
+				AliGPUTPCSliceOutCluster c;
+				GetOutputCluster( c, clusterIndex );
+				out->SetCluster( nClu, c );
+			}
 			nClu++;
 		}
 
@@ -310,9 +363,8 @@ GPUh() void AliGPUTPCTracker::WriteOutput()
 		if (iTr < fCommonMem->fNLocalTracks) nStoredLocalTracks++;
 		nStoredHits+=nClu;
 		out->SetNClusters( nClu );
-		out = out->NextTrack();
+		out = out->NextTrack( clusterIndexOutput );
 	}
-	delete[] trackOrder;
 
 	fOutput->SetNTracks( nStoredTracks );
 	fOutput->SetNLocalTracks( nStoredLocalTracks );
@@ -320,172 +372,4 @@ GPUh() void AliGPUTPCTracker::WriteOutput()
 	if (mCAParam->debugLevel >= 3) printf("Slice %d, Output: Tracks %d, local tracks %d, hits %d\n", fISlice, nStoredTracks, nStoredLocalTracks, nStoredHits);
 }
 
-GPUh() int AliGPUTPCTracker::PerformGlobalTrackingRun(AliGPUTPCTracker& sliceNeighbour, int iTrack, int rowIndex, float angle, int direction)
-{
-	/*for (int j = 0;j < fTracks[j].NHits();j++)
-	{
-		printf("Hit %3d: Row %3d: X %3.7lf Y %3.7lf\n", j, fTrackHits[fTracks[iTrack].FirstHitID() + j].RowIndex(), Row(fTrackHits[fTracks[iTrack].FirstHitID() + j].RowIndex()).X(),
-		(float) Data().HitDataY(Row(fTrackHits[fTracks[iTrack].FirstHitID() + j].RowIndex()), fTrackHits[fTracks[iTrack].FirstHitID() + j].HitIndex()) * Row(fTrackHits[fTracks[iTrack].FirstHitID() + j].RowIndex()).HstepY() + Row(fTrackHits[fTracks[iTrack].FirstHitID() + j].RowIndex()).Grid().YMin());
-	}*/
-
-	if (sliceNeighbour.fCommonMem->fNTracklets == 0) return(0);
-
-	AliGPUTPCTrackParam tParam;
-	tParam.InitParam();
-	tParam.SetCov( 0, 0.05 );
-	tParam.SetCov( 2, 0.05 );
-	tParam.SetCov( 5, 0.001 );
-	tParam.SetCov( 9, 0.001 );
-	tParam.SetCov( 14, 0.05 );
-	tParam.SetParam(fTracks[iTrack].Param());
-
-	//printf("Parameters X %f Y %f Z %f SinPhi %f DzDs %f QPt %f SignCosPhi %f\n", tParam.X(), tParam.Y(), tParam.Z(), tParam.SinPhi(), tParam.DzDs(), tParam.QPt(), tParam.SignCosPhi());
-	if (!tParam.Rotate(angle, GPUCA_MAX_SIN_PHI)) return(0);
-	//printf("Rotated X %f Y %f Z %f SinPhi %f DzDs %f QPt %f SignCosPhi %f\n", tParam.X(), tParam.Y(), tParam.Z(), tParam.SinPhi(), tParam.DzDs(), tParam.QPt(), tParam.SignCosPhi());
-
-	int maxRowGap = 10;
-	AliGPUTPCTrackLinearisation t0( tParam );
-	do
-	{
-		rowIndex += direction;
-		if (!tParam.TransportToX(sliceNeighbour.Row(rowIndex).X(), t0, mCAParam->ConstBz, GPUCA_MAX_SIN_PHI)) return(0); //Reuse t0 linearization until we are in the next sector
-		//printf("Transported X %f Y %f Z %f SinPhi %f DzDs %f QPt %f SignCosPhi %f (MaxY %f)\n", tParam.X(), tParam.Y(), tParam.Z(), tParam.SinPhi(), tParam.DzDs(), tParam.QPt(), tParam.SignCosPhi(), sliceNeighbour.Row(rowIndex).MaxY());
-		if (--maxRowGap == 0) return(0);
-	} while (fabsf(tParam.Y()) > sliceNeighbour.Row(rowIndex).MaxY());
-
-	float err2Y, err2Z;
-	GetErrors2( rowIndex, tParam.Z(), tParam.SinPhi(), tParam.DzDs(), err2Y, err2Z );
-	if (tParam.GetCov(0) < err2Y) tParam.SetCov(0, err2Y);
-	if (tParam.GetCov(2) < err2Z) tParam.SetCov(2, err2Z);
-
-	int nHits = AliGPUTPCTrackletConstructor::AliGPUTPCTrackletConstructorGlobalTracking(sliceNeighbour, tParam, rowIndex, direction, 0);
-	if (nHits >= GLOBAL_TRACKING_MIN_HITS)
-	{
-		//printf("%d hits found\n", nHits);
-		int trackId = CAMath::AtomicAdd(&sliceNeighbour.fCommonMem->fNTracks, 1);
-		int hitId = CAMath::AtomicAdd(&sliceNeighbour.fCommonMem->fNTrackHits, nHits);
-		if (direction == 1)
-		{
-			int i = 0;
-			while (i < nHits)
-			{
-#ifdef EXTERN_ROW_HITS
-				const calink rowHit = sliceNeighbour.TrackletRowHits()[rowIndex * *sliceNeighbour.NTracklets()];
-#else
-				const calink rowHit = sliceNeighbour.Tracklet(0).RowHit(rowIndex);
-#endif
-				if (rowHit != CALINK_INVAL)
-				{
-					//printf("New track: entry %d, row %d, hitindex %d\n", i, rowIndex, sliceNeighbour.fTrackletRowHits[rowIndex * sliceNeighbour.fCommonMem->fNTracklets]);
-					sliceNeighbour.fTrackHits[hitId + i].Set(rowIndex, rowHit);
-					//if (i == 0) tParam.TransportToX(sliceNeighbour.Row(rowIndex).X(), mCAParam->ConstBz(), GPUCA_MAX_SIN_PHI); //Use transport with new linearisation, we have changed the track in between - NOT needed, fitting will always start at outer end of global track!
-					i++;
-				}
-				rowIndex++;
-			}
-		}
-		else
-		{
-			int i = nHits - 1;
-			while (i >= 0)
-			{
-#ifdef EXTERN_ROW_HITS
-				const calink rowHit = sliceNeighbour.TrackletRowHits()[rowIndex * *sliceNeighbour.NTracklets()];
-#else
-				const calink rowHit = sliceNeighbour.Tracklet(0).RowHit(rowIndex);
-#endif
-				if (rowHit != CALINK_INVAL)
-				{
-					//printf("New track: entry %d, row %d, hitindex %d\n", i, rowIndex, sliceNeighbour.fTrackletRowHits[rowIndex * sliceNeighbour.fCommonMem->fNTracklets]);
-					sliceNeighbour.fTrackHits[hitId + i].Set(rowIndex, rowHit);
-					i--;
-				}
-				rowIndex--;
-			}
-		}
-		AliGPUTPCTrack& track = sliceNeighbour.fTracks[trackId];
-		track.SetAlive(1);
-		track.SetParam(tParam.GetParam());
-		track.SetNHits(nHits);
-		track.SetFirstHitID(hitId);
-		track.SetLocalTrackId((fISlice << 24) | fTracks[iTrack].LocalTrackId());
-	}
-
-	return(nHits >= GLOBAL_TRACKING_MIN_HITS);
-}
-
-GPUh() void AliGPUTPCTracker::PerformGlobalTracking(AliGPUTPCTracker& sliceLeft, AliGPUTPCTracker& sliceRight, int MaxTracksLeft, int MaxTracksRight)
-{
-	int ul = 0, ur = 0, ll = 0, lr = 0;
-	
-	int nTrkLeft = sliceLeft.fCommonMem->fNTracklets, nTrkRight = sliceRight.fCommonMem->fNTracklets;
-	sliceLeft.fCommonMem->fNTracklets = sliceRight.fCommonMem->fNTracklets = 1;
-	AliGPUTPCTracklet *trkLeft = sliceLeft.fTracklets, *trkRight = sliceRight.fTracklets;
-	sliceLeft.fTracklets = sliceRight.fTracklets = new AliGPUTPCTracklet;
-#ifdef EXTERN_ROW_HITS
-	calink *lnkLeft = sliceLeft.fTrackletRowHits, *lnkRight = sliceRight.fTrackletRowHits;
-	sliceLeft.fTrackletRowHits = sliceRight.fTrackletRowHits = new calink[GPUCA_ROW_COUNT];
-#endif
-
-	for (int i = 0;i < fCommonMem->fNLocalTracks;i++)
-	{
-		{
-			const int tmpHit = fTracks[i].FirstHitID();
-			if (fTrackHits[tmpHit].RowIndex() >= GLOBAL_TRACKING_MIN_ROWS && fTrackHits[tmpHit].RowIndex() < GLOBAL_TRACKING_RANGE)
-			{
-				int rowIndex = fTrackHits[tmpHit].RowIndex();
-				const AliGPUTPCRow& row = Row(rowIndex);
-				float Y = (float) Data().HitDataY(row, fTrackHits[tmpHit].HitIndex()) * row.HstepY() + row.Grid().YMin();
-				if (sliceLeft.NHitsTotal() < 1) {}
-				else if (sliceLeft.fCommonMem->fNTracks >= MaxTracksLeft) {printf("Insufficient memory for global tracking (%d:l %d / %d)\n", fISlice, sliceLeft.fCommonMem->fNTracks, MaxTracksLeft);}
-				else if (Y < -row.MaxY() * GLOBAL_TRACKING_Y_RANGE_LOWER_LEFT)
-				{
-					//printf("Track %d, lower row %d, left border (%f of %f)\n", i, fTrackHits[tmpHit].RowIndex(), Y, -row.MaxY());
-					ll += PerformGlobalTrackingRun(sliceLeft, i, rowIndex, -mCAParam->DAlpha, -1);
-				}
-				if (sliceRight.NHitsTotal() < 1) {}
-				else if (sliceRight.fCommonMem->fNTracks >= MaxTracksRight) {printf("Insufficient memory for global tracking (%d:r %d / %d)\n", fISlice, sliceRight.fCommonMem->fNTracks, MaxTracksRight);}
-				else if (Y > row.MaxY() * GLOBAL_TRACKING_Y_RANGE_LOWER_RIGHT)
-				{
-					//printf("Track %d, lower row %d, right border (%f of %f)\n", i, fTrackHits[tmpHit].RowIndex(), Y, row.MaxY());
-					lr += PerformGlobalTrackingRun(sliceRight, i, rowIndex, mCAParam->DAlpha, -1);
-				}
-			}
-		}
-		
-		{
-			const int tmpHit = fTracks[i].FirstHitID() + fTracks[i].NHits() - 1;
-			if (fTrackHits[tmpHit].RowIndex() < GPUCA_ROW_COUNT - GLOBAL_TRACKING_MIN_ROWS && fTrackHits[tmpHit].RowIndex() >= GPUCA_ROW_COUNT - GLOBAL_TRACKING_RANGE)
-			{
-				int rowIndex = fTrackHits[tmpHit].RowIndex();
-				const AliGPUTPCRow& row = Row(rowIndex);
-				float Y = (float) Data().HitDataY(row, fTrackHits[tmpHit].HitIndex()) * row.HstepY() + row.Grid().YMin();
-				if (sliceLeft.NHitsTotal() < 1) {}
-				else if (sliceLeft.fCommonMem->fNTracks >= MaxTracksLeft) {printf("Insufficient memory for global tracking (%d:l %d / %d)\n", fISlice, sliceLeft.fCommonMem->fNTracks, MaxTracksLeft);}
-				else if (Y < -row.MaxY() * GLOBAL_TRACKING_Y_RANGE_UPPER_LEFT)
-				{
-					//printf("Track %d, upper row %d, left border (%f of %f)\n", i, fTrackHits[tmpHit].RowIndex(), Y, -row.MaxY());
-					ul += PerformGlobalTrackingRun(sliceLeft, i, rowIndex, -mCAParam->DAlpha, 1);
-				}
-				if (sliceRight.NHitsTotal() < 1) {}
-				else if (sliceRight.fCommonMem->fNTracks >= MaxTracksRight) {printf("Insufficient memory for global tracking (%d:r %d / %d)\n", fISlice, sliceRight.fCommonMem->fNTracks, MaxTracksRight);}
-				else if (Y > row.MaxY() * GLOBAL_TRACKING_Y_RANGE_UPPER_RIGHT)
-				{
-					//printf("Track %d, upper row %d, right border (%f of %f)\n", i, fTrackHits[tmpHit].RowIndex(), Y, row.MaxY());
-					ur += PerformGlobalTrackingRun(sliceRight, i, rowIndex, mCAParam->DAlpha, 1);
-				}
-			}
-		}
-	}
-	
-	sliceLeft.fCommonMem->fNTracklets = nTrkLeft;sliceRight.fCommonMem->fNTracklets = nTrkRight;
-	delete sliceLeft.fTracklets;
-	sliceLeft.fTracklets = trkLeft;sliceRight.fTracklets = trkRight;
-#ifdef EXTERN_ROW_HITS
-	delete[] sliceLeft.fTrackletRowHits;
-	sliceLeft.fTrackletRowHits = lnkLeft;sliceRight.fTrackletRowHits = lnkRight;
-#endif
-	//printf("Global Tracking Result: Slide %2d: LL %3d LR %3d UL %3d UR %3d\n", mCAParam->ISlice(), ll, lr, ul, ur);
-}
-
 #endif
@@ -25,6 +25,7 @@
 #include "AliGPUProcessor.h"
 
 class AliGPUTPCSliceOutput;
+class AliGPUTPCSliceOutCluster;
 struct AliGPUTPCClusterData;
 MEM_CLASS_PRE() class AliGPUParam;
 MEM_CLASS_PRE() class AliGPUTPCTrack;
@@ -84,6 +85,7 @@ class AliGPUTPCTracker : public AliGPUProcessor
 	int ReadEvent();
 
 	GPUh() const AliGPUTPCClusterData *ClusterData() const { return fData.ClusterData(); }
+	GPUh() void GetOutputCluster(AliGPUTPCSliceOutCluster &c, unsigned int clusterIndex) const; //Output cluster from the input cluster data, for slice output with cluster indices
 
 	GPUh() MakeType(const MEM_LG(AliGPUTPCRow)&) Row( const AliGPUTPCHitId &HitId ) const { return fData.Row(HitId.RowIndex()); }
 
@@ -135,6 +137,12 @@ class AliGPUTPCTracker : public AliGPUProcessor
   
 	GPUhd() int NHitsTotal() const { return fData.NumberOfHits(); }
 	GPUhd() int NMaxTracks() const { return fNMaxTracks; }
+	GPUhd() int NMaxTrackHits() const { return fNMaxTrackHits; }
+	GPUhd() int NMaxTracklets() const { return fNMaxTracklets; }
+	GPUhd() int NMaxStartHits() const { return fNMaxStartHits; }
+	GPUhd() int NMaxRowStartHits() const { return fNMaxRowStartHits; }
+	float CapacityScale() const { return fCapacityScale; }
+	void SetCapacityScale(float v) { fCapacityScale = v; }
   
 	MEM_TEMPLATE() GPUd() void SetHitLinkUpData(const MEM_TYPE(AliGPUTPCRow) &row, int hitIndex, calink v) { fData.SetHitLinkUpData(row, hitIndex, v); }
 	MEM_TEMPLATE() GPUd() void SetHitLinkDownData(const MEM_TYPE(AliGPUTPCRow) &row, int hitIndex, calink v) { fData.SetHitLinkDownData(row, hitIndex, v); }
@@ -190,8 +198,11 @@ class AliGPUTPCTracker : public AliGPUProcessor
 	MEM_CLASS_PRE2() GPUhd() const MEM_LG2(AliGPUTPCTracklet) &Tracklet( int i ) const { return fTracklets[i]; }
 	GPUhd() GPUglobalref() MEM_GLOBAL(AliGPUTPCTracklet) *Tracklets() const { return fTracklets;}
 	GPUhd() GPUglobalref() calink* TrackletRowHits() const { return fTrackletRowHits; }
+	GPUhd() GPUglobalref() MEM_GLOBAL(AliGPUTPCTracklet) *GlobalTrackingTracklets() const { return fGlobalTrackingTracklets; }
+	GPUhd() GPUglobalref() calink* GlobalTrackingRowHits() const { return fGlobalTrackingRowHits; }
 
 	GPUhd() GPUglobalref() GPUAtomic(int) *NTracks() const { return &fCommonMem->fNTracks; }
+	GPUhd() int NLocalTracks() const { return fCommonMem->fNLocalTracks; }
 	GPUhd() GPUglobalref() MEM_GLOBAL(AliGPUTPCTrack) *Tracks() const { return fTracks; }
 	GPUhd() GPUglobalref() GPUAtomic(int) *NTrackHits() const { return &fCommonMem->fNTrackHits; }
 	GPUhd() GPUglobalref() AliGPUTPCHitId *TrackHits() const { return fTrackHits; }
@@ -208,16 +219,11 @@ class AliGPUTPCTracker : public AliGPUProcessor
 	{
 		int fTtrack;		//Track ID
 		float fSortVal;		//Value to sort for
+		unsigned int fFirstHit;	//Row and hit index of the first cluster, breaks ties independent of the order in which the tracks were stored
 	};
 
-	void PerformGlobalTracking(AliGPUTPCTracker& sliceLeft, AliGPUTPCTracker& sliceRight, int MaxTracksLeft, int MaxTracksRight);
-	
 	void* LinkTmpMemory() {return fLinkTmpMemory;}
 
-#if !defined(GPUCA_GPUCODE)
-	GPUh() int PerformGlobalTrackingRun(AliGPUTPCTracker& sliceNeighbour, int iTrack, int rowIndex, float angle, int direction);
-#endif
-
   private:
 	char* fStageAtSync;					//Temporary performance variable: Pointer to array storing current stage for every thread at every sync point
 	char* fLinkTmpMemory;				//tmp memory for hits after neighbours finder
@@ -229,9 +235,11 @@ class AliGPUTPCTracker : public AliGPUProcessor
 	MEM_LG(AliGPUTPCSliceData) fData; // The SliceData object. It is used to encapsulate the storage in memory from the access
   
 	int fNMaxStartHits;
+	int fNMaxRowStartHits;
 	int fNMaxTracklets;
 	int fNMaxTracks;
 	int fNMaxTrackHits;
+	float fCapacityScale; //Scale factor for the estimated buffer sizes, increased when the slice overflowed
 	short mMemoryResScratch;
 	short mMemoryResScratchHost;
 	short mMemoryResCommon;
@@ -251,12 +259,16 @@ class AliGPUTPCTracker : public AliGPUProcessor
 	GPUglobalref() AliGPUTPCHitId *fTrackletStartHits;   // start hits for the tracklets
 	GPUglobalref() MEM_GLOBAL(AliGPUTPCTracklet) *fTracklets; // tracklets
 	GPUglobalref() calink *fTrackletRowHits;			//Hits for each Tracklet in each row
+	GPUglobalref() MEM_GLOBAL(AliGPUTPCTracklet) *fGlobalTrackingTracklets; //Tracklet slots of the global tracking
+	GPUglobalref() calink *fGlobalTrackingRowHits;		//Row hits of the global tracking tracklet slots
 	GPUglobalref() MEM_GLOBAL(AliGPUTPCTrack) *fTracks;	// reconstructed tracks
 	GPUglobalref() AliGPUTPCHitId *fTrackHits;			// array of track hit numbers
 	
 	// output
 	GPUglobalref() AliGPUTPCSliceOutput *fOutput;		//address of pointer pointing to SliceOutput Object
 	void* fOutputMemory;									//Pointer to output memory if stored internally
+	trackSortData* fTrackSortMemory;						//Track order for the output, kept for the next events
+	int fTrackSortMemorySize;								//Number of tracks fTrackSortMemory can hold
   
 	// disable copy
 	AliGPUTPCTracker( const AliGPUTPCTracker& );
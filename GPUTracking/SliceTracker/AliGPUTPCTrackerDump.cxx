@@ -17,11 +17,14 @@ void AliGPUTPCTracker::DumpOutput(FILE* out)
 		fprintf(out, "Track %d (%d): ", j, track->NClusters());
 		for (int k = 0;k < track->NClusters();k++)
 		{
-			fprintf(out, "(%2.3f,%2.3f,%2.4f) ", track->Cluster(k).GetX(), track->Cluster(k).GetY(), track->Cluster(k).GetZ());
+			AliGPUTPCSliceOutCluster c;
+			if (Output()->ClusterIndexOutput()) GetOutputCluster(c, track->ClusterIndex(k));
+			else c = track->Cluster(k);
+			fprintf(out, "(%2.3f,%2.3f,%2.4f) ", c.GetX(), c.GetY(), c.GetZ());
 		}
 		fprintf(out, " - (%8.5f %8.5f %8.5f %8.5f %8.5f)", track->Param().Y(), track->Param().Z(), track->Param().SinPhi(), track->Param().DzDs(), track->Param().QPt());
 		fprintf(out, "\n");
-		track = track->GetNextTrack();
+		track = track->GetNextTrack(Output()->ClusterIndexOutput());
 	}
 }
 
@@ -128,7 +131,7 @@ void AliGPUTPCTracker::DumpTrackletHits(std::ostream &out)
 	//dump tracklets to file
 	int nTracklets = *NTracklets();
 	if( nTracklets<0 ) nTracklets = 0;
-	if( nTracklets>GPUCA_MAX_TRACKLETS ) nTracklets = GPUCA_MAX_TRACKLETS;
+	if( nTracklets>fNMaxTracklets ) nTracklets = fNMaxTracklets;
 	out << "Tracklets: (Slice" << fISlice << ") (" << nTracklets << ")" << std::endl;
 	if (mRec->GetDeviceProcessingSettings().comparableDebutOutput)
 	{
@@ -149,7 +152,7 @@ void AliGPUTPCTracker::DumpTrackletHits(std::ostream &out)
 					if (tmpTracklets[i].NHits() ){
 						for (int k = tmpTracklets[i].FirstRow();k <= tmpTracklets[i].LastRow();k++){
 							const int pos = k * nTracklets + j;
-							if (pos < 0 || pos >= GPUCA_MAX_TRACKLETS * GPUCA_ROW_COUNT){
+							if (pos < 0 || pos >= fNMaxTracklets * GPUCA_ROW_COUNT){
 								printf("internal error: invalid tracklet position k=%d j=%d pos=%d\n", k, j, pos);
 							} else {
 								fTrackletRowHits[pos] = tmpHits[k * nTracklets + i];
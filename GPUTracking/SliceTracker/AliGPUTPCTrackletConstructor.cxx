@@ -27,6 +27,10 @@
 #include "AliGPUTPCTracklet.h"
 #include "AliGPUTPCTrackletConstructor.h"
 #include "AliGPUCommonMath.h"
+#if !defined(GPUCA_GPUCODE) && defined(GPUCA_HAVE_OPENMP)
+#include <omp.h>
+#include "AliGPUReconstruction.h"
+#endif
 
 MEM_CLASS_PRE2()
 GPUd() void AliGPUTPCTrackletConstructor::InitTracklet(MEM_LG2(AliGPUTPCTrackParam) & tParam)
@@ -93,7 +97,7 @@ GPUd() void AliGPUTPCTrackletConstructor::UpdateTracklet(int /*nBlocks*/, int /*
 {
 	// reconstruction of tracklets, tracklets update step
 #ifndef EXTERN_ROW_HITS
-	AliGPUTPCTracklet &tracklet = tracker.Tracklets()[r.fItr];
+	GPUglobalref() MEM_GLOBAL(AliGPUTPCTracklet) &tracklet = r.fTracklets[r.fItr];
 #endif //EXTERN_ROW_HITS
 
 	MAKESharedRef(AliGPUTPCRow, row, tracker.Row(iRow), s.fRows[iRow]);
@@ -355,7 +359,7 @@ GPUd() void AliGPUTPCTrackletConstructor::DoTracklet(GPUconstantref() MEM_CONSTA
 	MEM_PLAIN(AliGPUTPCTrackParam)
 	tParam;
 #ifndef EXTERN_ROW_HITS
-	AliGPUTPCTracklet &tracklet = tracker.Tracklets()[r.fItr];
+	GPUglobalref() MEM_GLOBAL(AliGPUTPCTracklet) &tracklet = r.fTracklets[r.fItr];
 #endif //EXTERN_ROW_HITS
 	if (r.fGo)
 	{
@@ -420,12 +424,26 @@ template <> GPUd() void AliGPUTPCTrackletConstructor::Thread<0>(int nBlocks, int
 #endif
 	GPUbarrier();
 
+#ifdef GPUCA_GPUCODE
 	AliGPUTPCThreadMemory rMem;
+	SETRowHitBase(rMem, tracker.TrackletRowHits(), tracker.Tracklets());
 	for (rMem.fItr = get_global_id(0);rMem.fItr < sMem.fNTracklets;rMem.fItr += get_global_size(0))
 	{
 		rMem.fGo = 1;
 		DoTracklet(tracker, sMem, rMem);
 	}
+#else
+	//Start hits are sorted by row, so consecutive tracklets start close to each other and are processed as one batch
+	AliGPUTPCThreadMemory rMem[GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH];
+	AliGPUTPCTrackParam tParam[GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH];
+	for (int i = 0;i < GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH;i++) SETRowHitBase(rMem[i], tracker.TrackletRowHits(), tracker.Tracklets());
+	for (int iFirst = get_global_id(0) * GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH;iFirst < sMem.fNTracklets;iFirst += get_global_size(0) * GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH)
+	{
+		const int n = CAMath::Min(GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH, sMem.fNTracklets - iFirst);
+		for (int i = 0;i < n;i++) rMem[i].fItr = iFirst + i;
+		DoTrackletBatchCPU(tracker, sMem, rMem, tParam, n);
+	}
+#endif
 }
 
 template <> GPUd() void AliGPUTPCTrackletConstructor::Thread<1>(int nBlocks, int nThreads, int iBlock, int iThread, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &sMem, workerType &tracker0)
@@ -446,6 +464,7 @@ template <> GPUd() void AliGPUTPCTrackletConstructor::Thread<1>(int nBlocks, int
 		GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker) &tracker = pTracker[mySlice];
 
 		AliGPUTPCThreadMemory rMem;
+		SETRowHitBase(rMem, tracker.TrackletRowHits(), tracker.Tracklets());
 
 		while ((rMem.fItr = FetchTracklet(tracker, sMem)) != -2)
 		{
@@ -482,7 +501,36 @@ template <> GPUd() void AliGPUTPCTrackletConstructor::Thread<1>(int nBlocks, int
 		if (++mySlice >= GPUCA_NSLICES) mySlice = 0;
 	}
 #else
-	throw std::logic_error("Not supported on CPU");
+	//On the CPU, the kernel is started with a single block, which opens a pool of worker threads.
+	//Each worker starts at its own slice and fetches chunks of tracklets from all slices until all are processed.
+	AliGPUTPCTracker *pTracker = &tracker0;
+#ifdef GPUCA_HAVE_OPENMP
+#pragma omp parallel num_threads(tracker0.GetRec().GetDeviceProcessingSettings().nThreads)
+#endif
+	{
+#ifdef GPUCA_HAVE_OPENMP
+		int mySlice = omp_get_thread_num() % GPUCA_NSLICES;
+#else
+		int mySlice = 0;
+#endif
+		AliGPUTPCSharedMemory sMemCPU;
+		AliGPUTPCThreadMemory rMem[GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH];
+		AliGPUTPCTrackParam tParam[GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH];
+		for (unsigned int iSlice = 0;iSlice < GPUCA_NSLICES;iSlice++)
+		{
+			AliGPUTPCTracker &tracker = pTracker[mySlice];
+			sMemCPU.fNTracklets = *tracker.NTracklets();
+			for (int i = 0;i < GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH;i++) SETRowHitBase(rMem[i], tracker.TrackletRowHits(), tracker.Tracklets());
+			int iFirst;
+			while ((iFirst = FetchTracklet(tracker, sMemCPU)) >= 0)
+			{
+				const int n = CAMath::Min(GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH, sMemCPU.fNTracklets - iFirst);
+				for (int i = 0;i < n;i++) rMem[i].fItr = iFirst + i;
+				DoTrackletBatchCPU(tracker, sMemCPU, rMem, tParam, n);
+			}
+			if (++mySlice >= GPUCA_NSLICES) mySlice = 0;
+		}
+	}
 #endif
 }
 
@@ -520,13 +568,102 @@ GPUdi() int AliGPUTPCTrackletConstructor::FetchTracklet(GPUconstantref() MEM_CON
 
 #else //GPUCA_GPUCODE
 
-int AliGPUTPCTrackletConstructor::AliGPUTPCTrackletConstructorGlobalTracking(AliGPUTPCTracker &tracker, AliGPUTPCTrackParam &tParam, int row, int increment, int iTracklet)
+int AliGPUTPCTrackletConstructor::FetchTracklet(AliGPUTPCTracker &tracker, AliGPUTPCSharedMemory &sMem)
 {
+	//Fetch the next chunk of tracklets of this slice for the calling CPU thread, -2 if all are taken
+	const int firstTracklet = CAMath::AtomicAdd(&tracker.GPUParameters()->fNextTracklet, GPUCA_TRACKLET_CONSTRUCTOR_CPU_BATCH);
+	return(firstTracklet < sMem.fNTracklets ? firstTracklet : -2);
+}
+
+void AliGPUTPCTrackletConstructor::DoTrackletBatchCPU(AliGPUTPCTracker &tracker, AliGPUTPCSharedMemory &s, AliGPUTPCThreadMemory *rMem, AliGPUTPCTrackParam *tParam, int nTracklets)
+{
+	//Same reconstruction as DoTracklet, but all tracklets of the batch advance over the rows in lock-step.
+	//The row, its grid and its hits are used by the whole batch while they are in cache, and the row hits of
+	//consecutive tracklets are adjacent in TrackletRowHits, so the writes for one row share cache lines.
+	int rowFirst = GPUCA_ROW_COUNT, rowLast = -1;
+	for (int i = 0;i < nTracklets;i++)
+	{
+		AliGPUTPCThreadMemory &r = rMem[i];
+		AliGPUTPCHitId id = tracker.TrackletStartHits()[r.fItr];
+		r.fStartRow = r.fEndRow = r.fFirstRow = r.fLastRow = id.RowIndex();
+		r.fCurrIH = id.HitIndex();
+		r.fNMissed = 0;
+		r.fStage = 0;
+		r.fNHits = 0;
+		r.fGo = 1;
+		InitTracklet(tParam[i]);
+		if (r.fStartRow < rowFirst) rowFirst = r.fStartRow;
+	}
+
+	for (int iRow = rowFirst;iRow < GPUCA_ROW_COUNT;iRow++)
+	{ //Fit and upward search
+		bool active = false;
+		for (int i = 0;i < nTracklets;i++)
+		{
+			AliGPUTPCThreadMemory &r = rMem[i];
+			if (!r.fGo) continue;
+			active = true;
+			if (iRow >= r.fStartRow) UpdateTracklet(0, 0, 0, 0, s, r, tracker, tParam[i], iRow);
+		}
+		if (!active) break;
+	}
+
+	for (int i = 0;i < nTracklets;i++)
+	{
+		AliGPUTPCThreadMemory &r = rMem[i];
+		AliGPUTPCTrackParam &t = tParam[i];
+		r.fNMissed = 0;
+		if ((r.fGo = (t.TransportToX(tracker.Row(r.fEndRow).X(), tracker.Param().ConstBz, GPUCA_MAX_SIN_PHI) && t.Filter(r.fLastY, r.fLastZ, t.Err2Y() * 0.5f, t.Err2Z() * 0.5f, GPUCA_MAX_SIN_PHI_LOW, true))))
+		{
+			float err2Y, err2Z;
+			tracker.GetErrors2(r.fEndRow, t, err2Y, err2Z);
+			if (t.GetCov(0) < err2Y) t.SetCov(0, err2Y);
+			if (t.GetCov(2) < err2Z) t.SetCov(2, err2Z);
+		}
+		r.fNHits -= r.fNHitsEndRow;
+		r.fStage = 2;
+		if (r.fEndRow > rowLast) rowLast = r.fEndRow;
+	}
+
+	for (int iRow = rowLast;iRow >= 0;iRow--)
+	{ //Downward search, rows of a stopped tracklet down to its start row are invalidated as in DoTracklet
+		bool active = false;
+		for (int i = 0;i < nTracklets;i++)
+		{
+			AliGPUTPCThreadMemory &r = rMem[i];
+			if (iRow > r.fEndRow) {active = true; continue;}
+			if (r.fGo)
+			{
+				active = true;
+				UpdateTracklet(0, 0, 0, 0, s, r, tracker, tParam[i], iRow);
+			}
+			else if (iRow >= r.fStartRow)
+			{
+#ifndef EXTERN_ROW_HITS
+				AliGPUTPCTracklet &tracklet = r.fTracklets[r.fItr];
+#endif //EXTERN_ROW_HITS
+				active = true;
+				SETRowHit(iRow, CALINK_INVAL);
+			}
+		}
+		if (!active) break;
+	}
+
+	for (int i = 0;i < nTracklets;i++)
+	{
+		StoreTracklet(0, 0, 0, 0, s, rMem[i], tracker, tParam[i]);
+	}
+}
+
+#endif //GPUCA_GPUCODE
+
+GPUd() int AliGPUTPCTrackletConstructor::AliGPUTPCTrackletConstructorGlobalTracking(GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker) &tracker, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &sMem, MEM_LG(AliGPUTPCTrackParam) &tParam, int row, int increment, int iTracklet)
+{
+	//Follow a track from another slice through the rows of this slice, the row hits are stored in the global tracking slot iTracklet
 	AliGPUTPCThreadMemory rMem;
-	GPUshared() AliGPUTPCSharedMemory sMem;
-	sMem.fNTracklets = *tracker.NTracklets();
 	rMem.fItr = iTracklet;
 	rMem.fStage = 3;
+	SETRowHitBase(rMem, tracker.GlobalTrackingRowHits(), tracker.GlobalTrackingTracklets());
 	rMem.fNHits = rMem.fNMissed = 0;
 	rMem.fGo = 1;
 	while (rMem.fGo && row >= 0 && row < GPUCA_ROW_COUNT)
@@ -537,5 +674,3 @@ int AliGPUTPCTrackletConstructor::AliGPUTPCTrackletConstructorGlobalTracking(Ali
 	if (!CheckCov(tParam)) rMem.fNHits = 0;
 	return (rMem.fNHits);
 }
-
-#endif //GPUCA_GPUCODE
@@ -30,11 +30,21 @@ public:
 	public:
 #if !defined(GPUCA_GPUCODE)
 		AliGPUTPCThreadMemory()
-			: fItr( 0 ), fFirstRow( 0 ), fLastRow( 0 ), fStartRow( 0 ), fEndRow( 0 ), fCurrIH( 0 ), fGo( 0 ), fStage( 0 ), fNHits( 0 ), fNHitsEndRow( 0 ), fNMissed( 0 ), fLastY( 0 ), fLastZ( 0 )
+			: fItr( 0 ), fFirstRow( 0 ), fLastRow( 0 ), fStartRow( 0 ), fEndRow( 0 ), fCurrIH( 0 ), fGo( 0 ), fStage( 0 ), fNHits( 0 ), fNHitsEndRow( 0 ), fNMissed( 0 ), fLastY( 0 ), fLastZ( 0 ),
+#ifdef EXTERN_ROW_HITS
+			fRowHits( 0 )
+#else
+			fTracklets( 0 )
+#endif
 		{}
 
 		AliGPUTPCThreadMemory( const AliGPUTPCThreadMemory& /*dummy*/ )
-			: fItr( 0 ), fFirstRow( 0 ), fLastRow( 0 ), fStartRow( 0 ), fEndRow( 0 ), fCurrIH( 0 ), fGo( 0 ), fStage( 0 ), fNHits( 0 ), fNHitsEndRow( 0 ), fNMissed( 0 ), fLastY( 0 ), fLastZ( 0 )
+			: fItr( 0 ), fFirstRow( 0 ), fLastRow( 0 ), fStartRow( 0 ), fEndRow( 0 ), fCurrIH( 0 ), fGo( 0 ), fStage( 0 ), fNHits( 0 ), fNHitsEndRow( 0 ), fNMissed( 0 ), fLastY( 0 ), fLastZ( 0 ),
+#ifdef EXTERN_ROW_HITS
+			fRowHits( 0 )
+#else
+			fTracklets( 0 )
+#endif
 		{}
 		AliGPUTPCThreadMemory& operator=( const AliGPUTPCThreadMemory& /*dummy*/ ) { return *this; }
 #endif //!GPUCA_GPUCODE
@@ -54,11 +64,17 @@ public:
 		int fNMissed; // n missed hits during search
 		float fLastY; // Y of the last fitted cluster
 		float fLastZ; // Z of the last fitted cluster
+#ifdef EXTERN_ROW_HITS
+		GPUglobalref() calink *fRowHits; // row hits written by this thread, set by the kernel before the tracklets are processed
+#else
+		GPUglobalref() MEM_GLOBAL(AliGPUTPCTracklet) *fTracklets; // tracklets written by this thread, set by the kernel before the tracklets are processed
+#endif
 	};
 
 	MEM_CLASS_PRE() class AliGPUTPCSharedMemory
 	{
 		friend class AliGPUTPCTrackletConstructor; // friend class
+		friend class AliGPUTPCGlobalTracking; // friend class
 	public:
 #if !defined(GPUCA_GPUCODE)
 		AliGPUTPCSharedMemory() : fNextTrackletFirst(0), fNextTrackletCount(0), fNextTrackletFirstRun(0), fNTracklets(0) {
@@ -97,11 +113,12 @@ public:
 	GPUd() static void DoTracklet(GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker)& tracker, GPUsharedref() AliGPUTPCTrackletConstructor::MEM_LOCAL(AliGPUTPCSharedMemory)& sMem, AliGPUTPCThreadMemory& rMem);
 
 	GPUd() static int FetchTracklet(GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker) &tracker, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &sMem);
+	GPUd() static int AliGPUTPCTrackletConstructorGlobalTracking(GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker) &tracker, GPUsharedref() MEM_LOCAL(AliGPUTPCSharedMemory) &sMem, MEM_LG(AliGPUTPCTrackParam) &tParam, int startrow, int increment, int iTracklet);
 #ifdef GPUCA_GPUCODE
 	GPUd() static void AliGPUTPCTrackletConstructorGPU(GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker) *pTracker, GPUsharedref() AliGPUTPCTrackletConstructor::MEM_LOCAL(AliGPUTPCSharedMemory)& sMem);
 #else
 	GPUd() static void AliGPUTPCTrackletConstructorCPU(AliGPUTPCTracker &tracker);
-	static int AliGPUTPCTrackletConstructorGlobalTracking(AliGPUTPCTracker &tracker, AliGPUTPCTrackParam& tParam, int startrow, int increment, int iTracklet);
+	static void DoTrackletBatchCPU(AliGPUTPCTracker &tracker, AliGPUTPCSharedMemory &sMem, AliGPUTPCThreadMemory *rMem, AliGPUTPCTrackParam *tParam, int nTracklets);
 #endif //GPUCA_GPUCODE
 
 	typedef GPUconstantref() MEM_CONSTANT(AliGPUTPCTracker) workerType;
@@ -96,11 +96,7 @@ template <> GPUd() void AliGPUTPCTrackletSelector::Thread<0> (int nBlocks, int n
 				if ( nHits >= minHits )
                 {
 					int itrout = CAMath::AtomicAdd( tracker.NTracks(), 1 );
-#ifdef GPUCA_GPUCODE
-					if (itrout >= GPUCA_MAX_TRACKS)
-#else
-					if (itrout >= tracker.CommonMemory()->fNTracklets * 2 + 50)
-#endif //GPUCA_GPUCODE
+					if (itrout >= tracker.NMaxTracks())
 					{
 						tracker.GPUParameters()->fGPUError = GPUCA_ERROR_TRACK_OVERFLOW;
 						CAMath::AtomicExch( tracker.NTracks(), 0 );
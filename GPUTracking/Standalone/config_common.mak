@@ -36,6 +36,14 @@ ifeq ($(CONFIG_OPENMP), 1)
 DEFINES						+= GPUCA_HAVE_OPENMP
 endif
 
+ifeq ($(CONFIG_COMPACT_LINKS), 1)
+DEFINES						+= GPUCA_COMPACT_LINKS
+endif
+
+ifeq ($(CONFIG_COMPACT_HITS), 1)
+DEFINES						+= GPUCA_COMPACT_HITS
+endif
+
 ifeq ($(CONFIG_VC), 1)
 LIBSUSE						+= -lVc
 else
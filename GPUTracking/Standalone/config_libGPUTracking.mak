@@ -16,6 +16,7 @@ GPUCA_TRACKER_CXXFILES			= SliceTracker/AliGPUTPCSliceData.cxx \
 								SliceTracker/AliGPUTPCGrid.cxx \
 								SliceTracker/AliGPUTPCTrackletConstructor.cxx \
 								SliceTracker/AliGPUTPCTrackletSelector.cxx \
+								SliceTracker/AliGPUTPCGlobalTracking.cxx \
 								SliceTracker/AliGPUTPCStartHitsFinder.cxx \
 								SliceTracker/AliGPUTPCStartHitsSorter.cxx \
 								SliceTracker/AliGPUTPCHitArea.cxx \
@@ -43,8 +44,11 @@ GPUCA_MERGER_CXXFILES		= Merger/AliGPUTPCGMMerger.cxx \
 								Merger/AliGPUTPCGMPhysicalTrackModel.cxx \
 								Merger/AliGPUTPCGMPolynomialField.cxx \
 								Merger/AliGPUTPCGMPolynomialFieldManager.cxx \
+								Merger/AliGPUTPCGMMaterialLUT.cxx \
+								Merger/AliGPUTPCGMMergedTrackCompact.cxx \
 								Merger/AliGPUTPCGMPropagator.cxx \
 								Merger/AliGPUTPCGMTrackParam.cxx \
+								Merger/AliGPUTPCGMTrackFitLanes.cxx \
 								Merger/AliGPUTPCGMMergerGPU.cxx
 
 GPUCA_TRD_CXXFILES			= TRDTracking/AliGPUTRDTrack.cxx \
@@ -176,7 +176,8 @@ int genEvents::GenerateEvent(const AliGPUParam& sliceParam, char* filename)
     double theta = 2*std::atan(1./exp(eta));
     double lambda = theta-M_PI/2;
     //double theta = gRandom->Uniform(-60,60)*M_PI/180.;
-    double pt = .08*std::pow(10,gRandom->Uniform(0,2.2));
+    const double maxLogPt = configStandalone.configEG.maxPt > .08 ? std::log10(configStandalone.configEG.maxPt / .08) : 2.2;
+    double pt = .08*std::pow(10,gRandom->Uniform(0,maxLogPt));
     
     double q = 1.;
     int iSlice = GetSlice( phi );
@@ -47,6 +47,7 @@ EndConfig()
 
 BeginSubConfig(structConfigEG, configEG, configStandalone, "EG", 0, "Event generator settings")
 AddOption(numberOfTracks, int, 1, "numberOfTracks", 0, "Number of tracks per generated event")
+AddOption(maxPt, float, 0.f, "maxPt", 0, "Maximum Pt of generated tracks in GeV, e.g. 0.2 for looper-heavy events (0: default range up to 12.7 GeV)")
 AddHelp("help", 'h')
 EndConfig()
 
@@ -54,6 +55,8 @@ BeginSubConfig(structConfigRec, configRec, configStandalone, "REC", 0, "Reconstr
 AddOption(globalTracking, bool, true, "globalTracking", 0, "Enable global tracking")
 AddOption(runTRD, int, -1, "trd", 0, "Enable TRD processing")
 AddOption(disableRefitAttachment, int, 0, "refitAttachmentMask", 0, "Mask to disable certain attachment steps during refit")
+AddOption(refitMaxAttempts, int, 2, "refitMaxAttempts", 0, "Max number of fit attempts per track during refit")
+AddOption(refitMaxLooperSteps, int, 0, "refitMaxLooperSteps", 0, "Budget of loop following steps per track during refit (0 or negative = unlimited)")
 AddHelp("help", 'h')
 EndConfig()
 
@@ -61,6 +64,11 @@ BeginSubConfig(structConfigProc, configProc, configStandalone, "PROC", 0, "Proce
 AddOption(nStreams, int, -1, "nStreams", 0, "Number of GPU streams / command queues")
 AddOption(constructorPipeline, int, -1, "constructorPipeline", 0, "Run tracklet constructor in pipeline")
 AddOption(selectorPipeline, int, -1, "selectorPipeline", 0, "Run tracklet selector in pipeline")
+AddOption(mergerSortTracks, int, -1, "mergerSortTracks", 0, "Run the merger track fit ordered by number of clusters")
+AddOption(mergerFitLanes, int, -1, "mergerFitLanes", 0, "Run the merger track fit for 4, 8, or 16 tracks in lock-step SIMD lanes (0 = off)")
+AddOption(mergerIncremental, int, -1, "mergerIncremental", 0, "Merge the slices as soon as their output is ready")
+AddOption(mergerCompactOutput, int, -1, "mergerCompactOutput", 0, "Write the merged tracks also in the compact format")
+AddOption(sliceOutputClusterIndex, int, -1, "sliceOutputClusterIndex", 0, "Store cluster indices instead of clusters in the slice output")
 AddHelp("help", 'h')
 EndConfig()
 
@@ -194,6 +194,8 @@ int SetupReconstruction()
 	recSet.SearchWindowDZDR = configStandalone.dzdr;
 	recSet.GlobalTracking = configStandalone.configRec.globalTracking;
 	recSet.DisableRefitAttachment = configStandalone.configRec.disableRefitAttachment;
+	recSet.RefitMaxAttempts = configStandalone.configRec.refitMaxAttempts;
+	recSet.RefitMaxLooperSteps = configStandalone.configRec.refitMaxLooperSteps;
 	if (configStandalone.referenceX < 500.) recSet.TrackReferenceX = configStandalone.referenceX;
 	
 	if (configStandalone.OMPThreads != -1) devProc.nThreads = configStandalone.OMPThreads;
@@ -223,6 +225,11 @@ int SetupReconstruction()
 	if (configStandalone.configProc.nStreams >= 0) devProc.nStreams = configStandalone.configProc.nStreams;
 	if (configStandalone.configProc.constructorPipeline >= 0) devProc.trackletConstructorInPipeline = configStandalone.configProc.constructorPipeline;
 	if (configStandalone.configProc.selectorPipeline >= 0) devProc.trackletSelectorInPipeline = configStandalone.configProc.selectorPipeline;
+	if (configStandalone.configProc.mergerSortTracks >= 0) devProc.mergerSortTracks = configStandalone.configProc.mergerSortTracks;
+	if (configStandalone.configProc.mergerFitLanes >= 0) devProc.mergerFitLanes = configStandalone.configProc.mergerFitLanes;
+	if (configStandalone.configProc.mergerIncremental >= 0) devProc.mergerIncremental = configStandalone.configProc.mergerIncremental;
+	if (configStandalone.configProc.mergerCompactOutput >= 0) devProc.mergerCompactOutput = configStandalone.configProc.mergerCompactOutput;
+	if (configStandalone.configProc.sliceOutputClusterIndex >= 0) devProc.sliceOutputClusterIndex = configStandalone.configProc.sliceOutputClusterIndex;
 	
 	rec->SetSettings(&ev, &recSet, &devProc);
 	if (rec->Init())
@@ -206,6 +206,7 @@ template <> class propagatorInterface<AliGPUTPCGMPropagator> : public AliGPUTPCG
       constexpr float kRho = 1.025e-3f;
       constexpr float kRadLen = 29.532f;
       this->SetMaterial( kRadLen, kRho );
+      this->SetMaterialLUT( pMerger->MaterialLUT() );
       this->SetPolynomialField( pMerger->pField() );
       this->SetMaxSinPhi( GPUCA_MAX_SIN_PHI );
       this->SetToyMCEventsFlag(0);
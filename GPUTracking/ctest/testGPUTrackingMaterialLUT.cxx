@@ -0,0 +1,106 @@
+#define BOOST_TEST_MODULE Test TPC CA GPU Tracking Material LUT
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <memory>
+#include "AliGPUTPCGMMaterialLUT.h"
+
+static constexpr float kGasRho = 1.025e-3f;
+static constexpr float kGasRadLen = 29.532f;
+
+/// TPC gas with a thin inner field cage and a thick outer layer covering half of the azimuth
+static void ConstructTestLUT(AliGPUTPCGMMaterialLUT& lut)
+{
+  const AliGPUTPCGMMaterialLUT::Layer layers[] = {
+    {78.f, 79.f, -250.f, 250.f, 0.f, 0.f, 20.f, 0.1f},
+    {270.f, 290.f, -250.f, 250.f, 0.f, (float)M_PI, 10.f, 1.f}};
+  lut.Construct(64, 70.f, 300.f, 26, 250.f, 36, layers, 2, kGasRadLen, kGasRho);
+}
+
+/// The lookup reproduces the layers, and thin layers are kept through the cell averaging
+BOOST_AUTO_TEST_CASE(MaterialLUT_layers)
+{
+  AliGPUTPCGMMaterialLUT lut;
+  ConstructTestLUT(lut);
+  BOOST_CHECK(lut.isConstructed());
+  BOOST_CHECK_EQUAL(lut.getFlatBufferSize(), 64 * 26 * 36 * sizeof(AliGPUTPCGMMaterialLUT::Material));
+
+  float rho, rhoOverRadLen;
+  lut.GetMaterial(150.f, 10.f, 1.f, rho, rhoOverRadLen);
+  BOOST_CHECK_CLOSE(rho, kGasRho, 1e-3);
+  BOOST_CHECK_CLOSE(rhoOverRadLen, kGasRho / kGasRadLen, 1e-3);
+
+  lut.GetMaterial(280.f, -30.f, 1.5f, rho, rhoOverRadLen);
+  BOOST_CHECK_CLOSE(rho, 1.f, 1e-3);
+  BOOST_CHECK_CLOSE(rhoOverRadLen, 0.1f, 1e-3);
+
+  lut.GetMaterial(280.f, -30.f, 1.5f - (float)M_PI, rho, rhoOverRadLen); // other half of the azimuth, and negative phi
+  BOOST_CHECK_CLOSE(rho, kGasRho, 1e-3);
+
+  lut.GetMaterial(280.f, -30.f, 1.5f + 2.f * (float)M_PI, rho, rhoOverRadLen); // phi is periodic
+  BOOST_CHECK_CLOSE(rho, 1.f, 1e-3);
+
+  // Integrating rho over r across the 1 cm field cage layer gives about 1 cm * 0.1 g/cm^3
+  double integral = 0.;
+  const int nSteps = 2000;
+  const double rMin = 70., rMax = 90.;
+  for (int i = 0; i < nSteps; i++) {
+    lut.GetMaterial(rMin + (i + 0.5) * (rMax - rMin) / nSteps, 0.f, 0.f, rho, rhoOverRadLen);
+    integral += (rho - kGasRho) * (rMax - rMin) / nSteps;
+  }
+  BOOST_CHECK_CLOSE(integral, 0.1, 5.);
+}
+
+/// Cloning to an external buffer and moving the buffer keeps the lookup results
+BOOST_AUTO_TEST_CASE(MaterialLUT_flatObject)
+{
+  AliGPUTPCGMMaterialLUT lut;
+  ConstructTestLUT(lut);
+
+  std::unique_ptr<char[]> buffer(new char[lut.getFlatBufferSize()]);
+  AliGPUTPCGMMaterialLUT clone;
+  clone.cloneFromObject(lut, buffer.get());
+  BOOST_CHECK(!clone.isBufferInternal());
+
+  std::unique_ptr<char[]> buffer2(new char[lut.getFlatBufferSize()]);
+  clone.moveBufferTo(buffer2.get());
+
+  for (float r = 60.f; r < 320.f; r += 7.3f) {
+    for (float phi = -4.f; phi < 8.f; phi += 0.77f) {
+      float rho1 = -1.f, x1 = -1.f, rho2 = -1.f, x2 = -1.f;
+      const bool found1 = lut.GetMaterial(r, 0.3f * r - 40.f, phi, rho1, x1);
+      const bool found2 = clone.GetMaterial(r, 0.3f * r - 40.f, phi, rho2, x2);
+      BOOST_CHECK_EQUAL(found1, found2);
+      BOOST_CHECK_EQUAL(rho1, rho2);
+      BOOST_CHECK_EQUAL(x1, x2);
+    }
+  }
+}
+
+/// Points outside of the grid in r or z have no entry and leave the output untouched, the grid boundaries are inside
+BOOST_AUTO_TEST_CASE(MaterialLUT_outside)
+{
+  AliGPUTPCGMMaterialLUT lut;
+  ConstructTestLUT(lut);
+
+  const float outside[][2] = {{69.f, 0.f}, {300.5f, 0.f}, {370.f, 10.f}, {150.f, 251.f}, {150.f, -251.f}, {0.f, 0.f}, {-150.f, 0.f}};
+  for (const auto& p : outside) {
+    float rho = -1.f, rhoOverRadLen = -2.f;
+    BOOST_CHECK(!lut.GetMaterial(p[0], p[1], 1.5f, rho, rhoOverRadLen));
+    BOOST_CHECK_EQUAL(rho, -1.f);
+    BOOST_CHECK_EQUAL(rhoOverRadLen, -2.f);
+  }
+
+  const float inside[][2] = {{70.f, 0.f}, {300.f, 0.f}, {280.f, 250.f}, {280.f, -250.f}, {150.f, 0.f}};
+  for (const auto& p : inside) {
+    float rho = -1.f, rhoOverRadLen = -2.f;
+    BOOST_CHECK(lut.GetMaterial(p[0], p[1], 1.5f, rho, rhoOverRadLen));
+    BOOST_CHECK(rho > 0.f);
+    BOOST_CHECK(rhoOverRadLen > 0.f);
+  }
+  float rho, rhoOverRadLen;
+  BOOST_CHECK(lut.GetMaterial(280.f, 250.f, 1.5f, rho, rhoOverRadLen)); // the edge node averages its cell, half of which is in the thick layer
+  BOOST_CHECK_CLOSE(rho, 0.5f, 1.);
+}
@@ -0,0 +1,224 @@
+#define BOOST_TEST_MODULE Test TPC CA GPU Tracking Merged Track Compact Output
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include "AliGPUTPCGMMergedTrack.h"
+#include "AliGPUTPCGMMergedTrackHit.h"
+#include "AliGPUTPCGMMergedTrackCompact.h"
+
+/// Half precision conversion: exact for representable values, rounding to nearest, saturation and special values
+BOOST_AUTO_TEST_CASE(MergedTrackCompact_half)
+{
+  const float exact[] = {0.f, 1.f, -2.5f, 1024.f, 65504.f, -65504.f, 6.103515625e-05f, 5.9604645e-08f, 0.333251953125f};
+  for (float v : exact) {
+    BOOST_CHECK_EQUAL(AliGPUTPCGMMergedTrackCompact::HalfToFloat(AliGPUTPCGMMergedTrackCompact::FloatToHalf(v)), v);
+  }
+  BOOST_CHECK_EQUAL(AliGPUTPCGMMergedTrackCompact::FloatToHalf(1.f + 1.f / 2048.f), AliGPUTPCGMMergedTrackCompact::FloatToHalf(1.f)); // tie rounds to even
+  BOOST_CHECK_EQUAL(AliGPUTPCGMMergedTrackCompact::HalfToFloat(AliGPUTPCGMMergedTrackCompact::FloatToHalf(1e6f)), 65504.f);
+  BOOST_CHECK_EQUAL(AliGPUTPCGMMergedTrackCompact::HalfToFloat(AliGPUTPCGMMergedTrackCompact::FloatToHalf(1e-9f)), 0.f);
+  BOOST_CHECK(std::isinf(AliGPUTPCGMMergedTrackCompact::HalfToFloat(AliGPUTPCGMMergedTrackCompact::FloatToHalf(std::numeric_limits<float>::infinity()))));
+  BOOST_CHECK(std::isnan(AliGPUTPCGMMergedTrackCompact::HalfToFloat(AliGPUTPCGMMergedTrackCompact::FloatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> uni(-10.f, 10.f);
+  for (int i = 0; i < 10000; i++) {
+    const float v = std::pow(10.f, uni(rng) * 0.4f) * (i & 1 ? -1.f : 1.f);
+    BOOST_CHECK_CLOSE(AliGPUTPCGMMergedTrackCompact::HalfToFloat(AliGPUTPCGMMergedTrackCompact::FloatToHalf(v)), v, 0.05);
+  }
+}
+
+/// Encoding and decoding tracks with row-sorted clusters reproduces everything but the half precision outer parameters and the cluster coordinates
+BOOST_AUTO_TEST_CASE(MergedTrackCompact_roundTrip)
+{
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<float> uni(-1.f, 1.f);
+  const unsigned int nTracks = 200;
+  std::vector<AliGPUTPCGMMergedTrack> tracks(nTracks);
+  std::vector<AliGPUTPCGMMergedTrackHit> clusters;
+  for (unsigned int i = 0; i < nTracks; i++) {
+    AliGPUTPCGMMergedTrack& trk = tracks[i];
+    AliGPUTPCGMTrackParam& param = trk.Param();
+    param.SetX(80.f + 160.f * std::fabs(uni(rng)));
+    param.ZOffset() = uni(rng);
+    for (int j = 0; j < 5; j++) {
+      param.SetPar(j, uni(rng) * 100.f);
+    }
+    for (int j = 0; j < 15; j++) {
+      param.SetCov(j, uni(rng) * 1e-3f);
+    }
+    param.SetChi2(std::fabs(uni(rng)) * 200.f);
+    param.SetNDF(i % 300);
+    trk.SetAlpha(uni(rng) * 3.14f);
+    trk.SetLastX(uni(rng) * 250.f);
+    trk.SetLastY(uni(rng) * 40.f);
+    trk.SetLastZ(uni(rng) * 250.f);
+    trk.SetFlags(i & 0x1F);
+    trk.OuterParam().fX = 250.f - uni(rng);
+    trk.OuterParam().fAlpha = uni(rng);
+    for (int j = 0; j < 5; j++) {
+      trk.OuterParam().fP[j] = uni(rng) * 10.f;
+    }
+    for (int j = 0; j < 15; j++) {
+      trk.OuterParam().fC[j] = uni(rng);
+    }
+
+    // Legs of clusters with decreasing rows, the cluster index grows with the row within a slice
+    const unsigned int nClusters = i % 17 == 0 ? 0 : 20 + rng() % 300;
+    trk.SetFirstClusterRef(clusters.size());
+    trk.SetNClusters(nClusters);
+    trk.SetNClustersFitted(nClusters / 2);
+    int row = 152, slice = rng() % 36, leg = 0;
+    for (unsigned int j = 0; j < nClusters; j++) {
+      if (--row < 0 || rng() % 100 == 0) {
+        row = 152;
+        leg++;
+      }
+      if (rng() % 50 == 0) {
+        slice = rng() % 36;
+      }
+      AliGPUTPCGMMergedTrackHit cl = {};
+      cl.fX = uni(rng);
+      cl.fNum = slice * 1000000 + row * 5000 + rng() % 5000;
+      cl.fSlice = slice;
+      cl.fRow = row;
+      cl.fLeg = leg;
+      cl.fState = rng() & 0xFF;
+      clusters.push_back(cl);
+    }
+  }
+  // Unordered and large cluster indices, and a track referencing clusters of a previous track
+  clusters[1].fNum = 0xFFFFFFFF;
+  clusters[2].fNum = 0;
+  clusters[2].fRow = 158;
+  tracks[nTracks - 1].SetFirstClusterRef(0);
+  tracks[nTracks - 1].SetNClusters(tracks[2].FirstClusterRef());
+
+  unsigned int nTrackClusters = 0;
+  for (unsigned int i = 0; i < nTracks; i++) {
+    nTrackClusters += tracks[i].NClusters();
+  }
+  std::vector<char> buffer(AliGPUTPCGMMergedTrackCompact::MaxSize(nTracks, nTrackClusters));
+  const size_t size = AliGPUTPCGMMergedTrackCompact::Encode(tracks.data(), nTracks, clusters.data(), buffer.data());
+  BOOST_REQUIRE(size > 0 && size <= buffer.size());
+  BOOST_CHECK(size < nTracks * sizeof(AliGPUTPCGMMergedTrack) + nTrackClusters * sizeof(AliGPUTPCGMMergedTrackHit));
+
+  unsigned int nTracksOut, nClustersOut;
+  BOOST_REQUIRE_EQUAL(AliGPUTPCGMMergedTrackCompact::GetCounts(buffer.data(), size, nTracksOut, nClustersOut), 0);
+  BOOST_REQUIRE_EQUAL(nTracksOut, nTracks);
+  BOOST_REQUIRE_EQUAL(nClustersOut, nTrackClusters);
+  std::vector<AliGPUTPCGMMergedTrack> tracksOut(nTracksOut);
+  std::vector<AliGPUTPCGMMergedTrackHit> clustersOut(nClustersOut);
+  BOOST_REQUIRE_EQUAL(AliGPUTPCGMMergedTrackCompact::Decode(buffer.data(), size, tracksOut.data(), clustersOut.data()), 0);
+
+  unsigned int firstCluster = 0;
+  for (unsigned int i = 0; i < nTracks; i++) {
+    const AliGPUTPCGMMergedTrack &a = tracks[i], &b = tracksOut[i];
+    BOOST_CHECK_EQUAL(b.FirstClusterRef(), firstCluster);
+    BOOST_CHECK_EQUAL(b.NClusters(), a.NClusters());
+    BOOST_CHECK_EQUAL(b.NClustersFitted(), a.NClustersFitted());
+    BOOST_CHECK_EQUAL(b.OK(), a.OK());
+    BOOST_CHECK_EQUAL(b.Looper(), a.Looper());
+    BOOST_CHECK_EQUAL(b.CSide(), a.CSide());
+    BOOST_CHECK_EQUAL(b.CCE(), a.CCE());
+    BOOST_CHECK_EQUAL(b.FitBudgetExceeded(), a.FitBudgetExceeded());
+    BOOST_CHECK_EQUAL(b.GetAlpha(), a.GetAlpha());
+    BOOST_CHECK_EQUAL(b.LastX(), a.LastX());
+    BOOST_CHECK_EQUAL(b.LastY(), a.LastY());
+    BOOST_CHECK_EQUAL(b.LastZ(), a.LastZ());
+    BOOST_CHECK_EQUAL(b.GetParam().GetX(), a.GetParam().GetX());
+    BOOST_CHECK_EQUAL(b.GetParam().GetZOffset(), a.GetParam().GetZOffset());
+    for (int j = 0; j < 5; j++) {
+      BOOST_CHECK_EQUAL(b.GetParam().GetPar(j), a.GetParam().GetPar(j));
+      BOOST_CHECK_SMALL(b.OuterParam().fP[j] - a.OuterParam().fP[j], std::fabs(a.OuterParam().fP[j]) * 5e-4f + 6e-8f);
+    }
+    for (int j = 0; j < 15; j++) {
+      BOOST_CHECK_EQUAL(b.GetParam().GetCov(j), a.GetParam().GetCov(j));
+      BOOST_CHECK_SMALL(b.OuterParam().fC[j] - a.OuterParam().fC[j], std::fabs(a.OuterParam().fC[j]) * 5e-4f + 6e-8f);
+    }
+    BOOST_CHECK_EQUAL(b.GetParam().GetChi2(), a.GetParam().GetChi2());
+    BOOST_CHECK_EQUAL(b.GetParam().GetNDF(), a.GetParam().GetNDF());
+    BOOST_CHECK_EQUAL(b.OuterParam().fX, a.OuterParam().fX);
+    BOOST_CHECK_EQUAL(b.OuterParam().fAlpha, a.OuterParam().fAlpha);
+    for (unsigned int j = 0; j < a.NClusters(); j++) {
+      const AliGPUTPCGMMergedTrackHit &ca = clusters[a.FirstClusterRef() + j], &cb = clustersOut[b.FirstClusterRef() + j];
+      BOOST_CHECK_EQUAL(cb.fNum, ca.fNum);
+      BOOST_CHECK_EQUAL(cb.fSlice, ca.fSlice);
+      BOOST_CHECK_EQUAL(cb.fRow, ca.fRow);
+      BOOST_CHECK_EQUAL(cb.fLeg, ca.fLeg);
+      BOOST_CHECK_EQUAL(cb.fState, ca.fState);
+      BOOST_CHECK_EQUAL(cb.fX, 0.f);
+    }
+    firstCluster += a.NClusters();
+  }
+
+  // Truncated or modified buffers are rejected
+  BOOST_CHECK_EQUAL(AliGPUTPCGMMergedTrackCompact::Decode(buffer.data(), size - 1, tracksOut.data(), clustersOut.data()), 1);
+  buffer[0]++;
+  BOOST_CHECK_EQUAL(AliGPUTPCGMMergedTrackCompact::GetCounts(buffer.data(), size, nTracksOut, nClustersOut), 1);
+}
+
+/// With non-consecutive cluster IDs the merger clusters only store their output position, the encoded cluster index must be taken from the cluster ID array
+BOOST_AUTO_TEST_CASE(MergedTrackCompact_nonConsecutiveIDs)
+{
+  std::mt19937 rng(54321);
+  const unsigned int nTracks = 50;
+  std::vector<AliGPUTPCGMMergedTrack> tracks(nTracks);
+  std::vector<AliGPUTPCGMMergedTrackHit> clusters;
+  std::vector<int> clusterIDs;
+  for (unsigned int i = 0; i < nTracks; i++) {
+    AliGPUTPCGMMergedTrack& trk = tracks[i];
+    const unsigned int nClusters = 10 + rng() % 150;
+    trk.SetFirstClusterRef(clusters.size());
+    trk.SetNClusters(nClusters);
+    trk.SetNClustersFitted(nClusters);
+    trk.SetFlags(1);
+    const int slice = rng() % 36;
+    unsigned char state = 0;
+    for (unsigned int j = 0; j < nClusters; j++) {
+      // Mostly unchanged cluster states, as for real tracks
+      if (rng() % 10 == 0) {
+        state = rng() & 0xFF;
+      }
+      AliGPUTPCGMMergedTrackHit cl = {};
+      cl.fNum = clusters.size();
+      cl.fSlice = slice;
+      cl.fRow = 152 - j % 153;
+      cl.fLeg = j / 153;
+      cl.fState = state;
+      clusters.push_back(cl);
+      // HLT cluster IDs: slice and patch in the upper bits, not consecutive
+      clusterIDs.push_back((slice << 25) | ((rng() % 6) << 22) | (rng() & 0x3FFFFF));
+    }
+  }
+
+  std::vector<char> buffer(AliGPUTPCGMMergedTrackCompact::MaxSize(nTracks, clusters.size()));
+  const size_t size = AliGPUTPCGMMergedTrackCompact::Encode(tracks.data(), nTracks, clusters.data(), buffer.data(), clusterIDs.data());
+  BOOST_REQUIRE(size > 0 && size <= buffer.size());
+
+  unsigned int nTracksOut, nClustersOut;
+  BOOST_REQUIRE_EQUAL(AliGPUTPCGMMergedTrackCompact::GetCounts(buffer.data(), size, nTracksOut, nClustersOut), 0);
+  BOOST_REQUIRE_EQUAL(nTracksOut, nTracks);
+  BOOST_REQUIRE_EQUAL(nClustersOut, clusters.size());
+  std::vector<AliGPUTPCGMMergedTrack> tracksOut(nTracksOut);
+  std::vector<AliGPUTPCGMMergedTrackHit> clustersOut(nClustersOut);
+  BOOST_REQUIRE_EQUAL(AliGPUTPCGMMergedTrackCompact::Decode(buffer.data(), size, tracksOut.data(), clustersOut.data()), 0);
+  for (unsigned int i = 0; i < clusters.size(); i++) {
+    BOOST_CHECK_EQUAL(clustersOut[i].fNum, (unsigned int) clusterIDs[i]);
+    BOOST_CHECK_EQUAL(clustersOut[i].fSlice, clusters[i].fSlice);
+    BOOST_CHECK_EQUAL(clustersOut[i].fRow, clusters[i].fRow);
+    BOOST_CHECK_EQUAL(clustersOut[i].fLeg, clusters[i].fLeg);
+    BOOST_CHECK_EQUAL(clustersOut[i].fState, clusters[i].fState);
+  }
+
+  // Without the ID array the output positions are encoded
+  const size_t sizePositions = AliGPUTPCGMMergedTrackCompact::Encode(tracks.data(), nTracks, clusters.data(), buffer.data());
+  BOOST_REQUIRE_EQUAL(AliGPUTPCGMMergedTrackCompact::Decode(buffer.data(), sizePositions, tracksOut.data(), clustersOut.data()), 0);
+  for (unsigned int i = 0; i < clusters.size(); i++) {
+    BOOST_CHECK_EQUAL(clustersOut[i].fNum, i);
+  }
+}
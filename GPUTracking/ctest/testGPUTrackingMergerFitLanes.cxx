@@ -0,0 +1,150 @@
+#define BOOST_TEST_MODULE Test TPC CA GPU Tracking Merger Fit Lanes
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include "AliGPUReconstruction.h"
+#include "AliGPUChainTracking.h"
+#include "AliGPUParam.h"
+#include "AliGPUTPCClusterData.h"
+#include "AliGPUTPCGMMerger.h"
+#include "AliGPUTPCGMMergedTrack.h"
+
+struct FitResult {
+  bool ok;
+  unsigned int nClusters, nClustersFitted;
+  float alpha, par[5];
+};
+
+/// Reconstructs a toy event with straight and slightly curved tracks on both sides of the TPC plus noise on the CPU,
+/// with the merger refit running in fitLanes lanes, or one track at a time in the same order for fitLanes = 0
+static void RunToyEvent(int fitLanes, std::vector<FitResult>& results)
+{
+  std::unique_ptr<AliGPUReconstruction> rec(AliGPUReconstruction::CreateInstance("CPU", true));
+  AliGPUChainTracking* chain = rec->AddChain<AliGPUChainTracking>();
+  AliGPUSettingsEvent ev;
+  AliGPUSettingsRec recSet;
+  AliGPUSettingsDeviceProcessing devProc;
+  ev.solenoidBz = -5.00668;
+  recSet.SetMinTrackPt(MIN_TRACK_PT_DEFAULT);
+  devProc.nThreads = 1;
+  devProc.debugLevel = -1;
+  devProc.mergerSortTracks = true;
+  devProc.mergerFitLanes = fitLanes;
+  rec->SetSettings(&ev, &recSet, &devProc);
+  BOOST_REQUIRE_EQUAL(rec->Init(), 0);
+  const AliGPUParam& param = rec->GetParam();
+
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<double> uni(-1., 1.);
+  std::normal_distribution<double> gaus(0., 1.);
+  std::vector<AliGPUTPCClusterData> clusters[36];
+  for (int iSlice = 0; iSlice < 36; iSlice++) {
+    const double sgn = iSlice < 18 ? 1. : -1.;
+    for (int it = 0; it < 100; it++) {
+      const double ty = uni(rng) * 0.15, tz = sgn * std::fabs(uni(rng)), c = uni(rng) * 1e-3;
+      for (int r = 0; r < GPUCA_ROW_COUNT; r++) {
+        if (rng() % 20 == 0) {
+          continue;
+        }
+        AliGPUTPCClusterData cl;
+        cl.fRow = r;
+        cl.fFlags = 0;
+        cl.fX = param.RowX[r];
+        cl.fY = cl.fX * ty + c * cl.fX * cl.fX + gaus(rng) * 0.05;
+        cl.fZ = cl.fX * tz + gaus(rng) * 0.05;
+        cl.fAmp = 100;
+        if (std::fabs(cl.fY) < cl.fX * 0.17f && std::fabs(cl.fZ) < 250.f) {
+          clusters[iSlice].push_back(cl);
+        }
+      }
+    }
+    for (int in = 0; in < 1000; in++) {
+      AliGPUTPCClusterData cl;
+      cl.fRow = rng() % GPUCA_ROW_COUNT;
+      cl.fFlags = 0;
+      cl.fX = param.RowX[cl.fRow];
+      cl.fY = uni(rng) * cl.fX * 0.17;
+      cl.fZ = sgn * std::fabs(uni(rng)) * 250.;
+      cl.fAmp = 100;
+      clusters[iSlice].push_back(cl);
+    }
+    std::stable_sort(clusters[iSlice].begin(), clusters[iSlice].end(), [](const AliGPUTPCClusterData& a, const AliGPUTPCClusterData& b) { return a.fRow < b.fRow; });
+  }
+  int id = 0;
+  for (int iSlice = 0; iSlice < 36; iSlice++) {
+    for (auto& cl : clusters[iSlice]) {
+      cl.fId = id++;
+    }
+    chain->mIOPtrs.clusterData[iSlice] = clusters[iSlice].data();
+    chain->mIOPtrs.nClusterData[iSlice] = clusters[iSlice].size();
+  }
+  BOOST_REQUIRE_EQUAL(chain->RunStandalone(), 0);
+
+  const AliGPUTPCGMMerger& merger = chain->GetTPCMerger();
+  results.resize(merger.NOutputTracks());
+  for (int i = 0; i < merger.NOutputTracks(); i++) {
+    const AliGPUTPCGMMergedTrack& t = merger.OutputTracks()[i];
+    FitResult& r = results[i];
+    r.ok = t.OK();
+    r.nClusters = t.NClusters();
+    r.nClustersFitted = t.NClustersFitted();
+    r.alpha = t.GetAlpha();
+    for (int j = 0; j < 5; j++) {
+      r.par[j] = t.GetParam().GetPar(j);
+    }
+  }
+}
+
+/// The refit in 4, 8, and 16 lanes takes the same decisions as the scalar refit, and the parameters agree within the float
+/// rounding, which the Kalman filter amplifies for some tracks to a permille
+BOOST_AUTO_TEST_CASE(MergerFitLanes_compareScalar)
+{
+  std::vector<FitResult> scalar;
+  RunToyEvent(0, scalar);
+  int nOK = 0;
+  for (const FitResult& r : scalar) {
+    nOK += r.ok;
+  }
+  BOOST_CHECK_GT(nOK, 2500);
+
+  const float scale[5] = {1.f, 1.f, 1e-2f, 1e-2f, 1e-2f}; // Y, Z, SinPhi, DzDs, QPt
+  for (int lanes : {4, 8, 16}) {
+    BOOST_TEST_CONTEXT("lanes " << lanes)
+    {
+      std::vector<FitResult> packed;
+      RunToyEvent(lanes, packed);
+      BOOST_REQUIRE_EQUAL(packed.size(), scalar.size());
+      int nDecisions = 0, nCompared = 0, nFar = 0;
+      float maxDiff = 0.f;
+      for (unsigned int i = 0; i < scalar.size(); i++) {
+        const FitResult &a = scalar[i], &b = packed[i];
+        BOOST_CHECK_EQUAL(a.nClusters, b.nClusters);
+        if (a.ok != b.ok || a.nClustersFitted != b.nClustersFitted) {
+          nDecisions++;
+          continue;
+        }
+        if (!a.ok) {
+          continue;
+        }
+        BOOST_CHECK_EQUAL(a.alpha, b.alpha);
+        float diff = 0.f;
+        for (int j = 0; j < 5; j++) {
+          diff = std::max(diff, std::fabs(a.par[j] - b.par[j]) / std::max(std::fabs(a.par[j]), scale[j]));
+        }
+        nCompared++;
+        nFar += diff > 1e-3f;
+        maxDiff = std::max(maxDiff, diff);
+      }
+      BOOST_CHECK_LE(nDecisions, (int)scalar.size() / 500);
+      BOOST_CHECK_GT(nCompared, 2500);
+      BOOST_CHECK_LE(nFar, nCompared / 50);
+      BOOST_CHECK_LT(maxDiff, 0.1f);
+    }
+  }
+}
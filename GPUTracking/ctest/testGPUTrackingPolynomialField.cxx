@@ -0,0 +1,173 @@
+#define BOOST_TEST_MODULE Test TPC CA GPU Tracking Polynomial Field
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "AliGPUTPCGMPolynomialField.h"
+#include "AliGPUTPCGMPolynomialFieldManager.h"
+
+/// Random points in the TPC / TRD volume, stored column-wise
+struct FieldTestPoints {
+  std::vector<float> x, y, z;
+  explicit FieldTestPoints(int n) : x(n), y(n), z(n)
+  {
+    srand(12345);
+    for (int i = 0; i < n; i++) {
+      x[i] = -370.f + 740.f * rand() / RAND_MAX;
+      y[i] = -370.f + 740.f * rand() / RAND_MAX;
+      z[i] = -250.f + 500.f * rand() / RAND_MAX;
+    }
+  }
+};
+
+static AliGPUTPCGMPolynomialField GetTestField()
+{
+  AliGPUTPCGMPolynomialField field;
+  AliGPUTPCGMPolynomialFieldManager::GetPolynomialField(AliGPUTPCGMPolynomialFieldManager::k5kG, -5.00668, field);
+  return field;
+}
+
+/// Rounding tolerance for a field value: relative to the sum of the absolute polynomial terms, which bounds the cancellation
+template <int M>
+static float FieldTolerance(const float* coeff, const float f[M])
+{
+  float sum = 0.f;
+  for (int i = 0; i < M; i++) {
+    sum += std::fabs(coeff[i] * f[i]);
+  }
+  return 1e-5f * sum + 1e-7f;
+}
+
+/// The batched evaluation agrees with the per-point functions on random points within float rounding
+BOOST_AUTO_TEST_CASE(PolynomialField_batched)
+{
+  const int n = 1003; // not a multiple of the vector width, to cover the remainder loop
+  const AliGPUTPCGMPolynomialField field = GetTestField();
+  const FieldTestPoints p(n);
+  std::vector<float> bx(n), by(n), bz(n), bzOnly(n);
+
+  field.GetField(n, p.x.data(), p.y.data(), p.z.data(), bx.data(), by.data(), bz.data());
+  field.GetFieldBz(n, p.x.data(), p.y.data(), p.z.data(), bzOnly.data());
+  for (int i = 0; i < n; i++) {
+    float B[3], f[AliGPUTPCGMPolynomialField::fkTpcM];
+    field.GetField(p.x[i], p.y[i], p.z[i], B);
+    AliGPUTPCGMPolynomialField::GetPolynomsTpc(p.x[i], p.y[i], p.z[i], f);
+    BOOST_CHECK_SMALL(bx[i] - B[0], FieldTolerance<AliGPUTPCGMPolynomialField::fkTpcM>(field.GetCoeffTpcBx(), f));
+    BOOST_CHECK_SMALL(by[i] - B[1], FieldTolerance<AliGPUTPCGMPolynomialField::fkTpcM>(field.GetCoeffTpcBy(), f));
+    BOOST_CHECK_SMALL(bz[i] - B[2], FieldTolerance<AliGPUTPCGMPolynomialField::fkTpcM>(field.GetCoeffTpcBz(), f));
+    BOOST_CHECK_EQUAL(bzOnly[i], bz[i]);
+  }
+
+  field.GetFieldTrd(n, p.x.data(), p.y.data(), p.z.data(), bx.data(), by.data(), bz.data());
+  field.GetFieldTrdBz(n, p.x.data(), p.y.data(), p.z.data(), bzOnly.data());
+  for (int i = 0; i < n; i++) {
+    float B[3], f[AliGPUTPCGMPolynomialField::fkTrdM];
+    field.GetFieldTrd(p.x[i], p.y[i], p.z[i], B);
+    AliGPUTPCGMPolynomialField::GetPolynomsTrd(p.x[i], p.y[i], p.z[i], f);
+    BOOST_CHECK_SMALL(bx[i] - B[0], FieldTolerance<AliGPUTPCGMPolynomialField::fkTrdM>(field.GetCoeffTrdBx(), f));
+    BOOST_CHECK_SMALL(by[i] - B[1], FieldTolerance<AliGPUTPCGMPolynomialField::fkTrdM>(field.GetCoeffTrdBy(), f));
+    BOOST_CHECK_SMALL(bz[i] - B[2], FieldTolerance<AliGPUTPCGMPolynomialField::fkTrdM>(field.GetCoeffTrdBz(), f));
+    BOOST_CHECK_EQUAL(bzOnly[i], bz[i]);
+  }
+
+  field.GetFieldIts(n, p.x.data(), p.y.data(), p.z.data(), bx.data(), by.data(), bz.data());
+  field.GetFieldItsBz(n, p.x.data(), p.y.data(), p.z.data(), bzOnly.data());
+  for (int i = 0; i < n; i++) {
+    float B[3], f[AliGPUTPCGMPolynomialField::fkItsM];
+    field.GetFieldIts(p.x[i], p.y[i], p.z[i], B);
+    AliGPUTPCGMPolynomialField::GetPolynomsIts(p.x[i], p.y[i], p.z[i], f);
+    BOOST_CHECK_SMALL(bx[i] - B[0], FieldTolerance<AliGPUTPCGMPolynomialField::fkItsM>(field.GetCoeffItsBx(), f));
+    BOOST_CHECK_SMALL(by[i] - B[1], FieldTolerance<AliGPUTPCGMPolynomialField::fkItsM>(field.GetCoeffItsBy(), f));
+    BOOST_CHECK_SMALL(bz[i] - B[2], FieldTolerance<AliGPUTPCGMPolynomialField::fkItsM>(field.GetCoeffItsBz(), f));
+    BOOST_CHECK_EQUAL(bzOnly[i], bz[i]);
+  }
+}
+
+/// A field with a single non-zero coefficient per component checks that every batched term uses the right monomial
+BOOST_AUTO_TEST_CASE(PolynomialField_batchedTerms)
+{
+  const int n = 17;
+  const FieldTestPoints p(n);
+  std::vector<float> bx(n), by(n), bz(n);
+  float cx[AliGPUTPCGMPolynomialField::fkTrdM], cy[AliGPUTPCGMPolynomialField::fkTrdM], cz[AliGPUTPCGMPolynomialField::fkTrdM];
+  for (int k = 0; k < AliGPUTPCGMPolynomialField::fkTrdM; k++) {
+    for (int j = 0; j < AliGPUTPCGMPolynomialField::fkTrdM; j++) {
+      cx[j] = j == k ? 1.f : 0.f;
+      cy[j] = j == k ? 2.f : 0.f;
+      cz[j] = j == k ? -3.f : 0.f;
+    }
+    AliGPUTPCGMPolynomialField field;
+    field.SetFieldTrd(cx, cy, cz);
+    if (k < AliGPUTPCGMPolynomialField::fkTpcM) {
+      field.SetFieldTpc(cx, cy, cz);
+      field.SetFieldIts(cx, cy, cz);
+    }
+    for (int type = 0; type < 3; type++) {
+      if (type != 1 && k >= AliGPUTPCGMPolynomialField::fkTpcM) {
+        continue;
+      }
+      if (type == 0) {
+        field.GetField(n, p.x.data(), p.y.data(), p.z.data(), bx.data(), by.data(), bz.data());
+      } else if (type == 1) {
+        field.GetFieldTrd(n, p.x.data(), p.y.data(), p.z.data(), bx.data(), by.data(), bz.data());
+      } else {
+        field.GetFieldIts(n, p.x.data(), p.y.data(), p.z.data(), bx.data(), by.data(), bz.data());
+      }
+      for (int i = 0; i < n; i++) {
+        float f[AliGPUTPCGMPolynomialField::fkTrdM];
+        AliGPUTPCGMPolynomialField::GetPolynomsTrd(p.x[i], p.y[i], p.z[i], f);
+        BOOST_CHECK_CLOSE(bx[i], f[k], 1e-4);
+        BOOST_CHECK_CLOSE(by[i], 2.f * f[k], 1e-4);
+        BOOST_CHECK_CLOSE(bz[i], -3.f * f[k], 1e-4);
+      }
+    }
+  }
+}
+
+/// Timing of the per-point and the batched field evaluation, printed for comparison between versions and machines, not checked
+BOOST_AUTO_TEST_CASE(PolynomialField_benchmark)
+{
+  const int n = 4096, nRepeat = 200;
+  const AliGPUTPCGMPolynomialField field = GetTestField();
+  const FieldTestPoints p(n);
+  std::vector<float> bx(n), by(n), bz(n);
+  const char* names[] = {"Bz", "Bz batched", "TPC", "TPC batched", "TRD", "TRD batched"};
+  double sum = 0.;
+  for (int mode = 0; mode < 6; mode++) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (int k = 0; k < nRepeat; k++) {
+      if (mode == 0) {
+        for (int i = 0; i < n; i++) {
+          bz[i] = field.GetFieldBz(p.x[i], p.y[i], p.z[i]);
+        }
+      } else if (mode == 1) {
+        field.GetFieldBz(n, p.x.data(), p.y.data(), p.z.data(), bz.data());
+      } else if (mode == 2 || mode == 4) {
+        for (int i = 0; i < n; i++) {
+          float B[3];
+          if (mode == 2) {
+            field.GetField(p.x[i], p.y[i], p.z[i], B);
+          } else {
+            field.GetFieldTrd(p.x[i], p.y[i], p.z[i], B);
+          }
+          bx[i] = B[0];
+          by[i] = B[1];
+          bz[i] = B[2];
+        }
+      } else if (mode == 3) {
+        field.GetField(n, p.x.data(), p.y.data(), p.z.data(), bx.data(), by.data(), bz.data());
+      } else {
+        field.GetFieldTrd(n, p.x.data(), p.y.data(), p.z.data(), bx.data(), by.data(), bz.data());
+      }
+      sum += bz[k % n]; // keep the evaluation from being optimized away
+    }
+    const double time = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+    printf("Polynomial field %-12s %7.2f ns / point\n", names[mode], time / ((double) n * nRepeat));
+  }
+  BOOST_CHECK(std::isfinite(sum));
+}
@@ -22,6 +22,8 @@
 #include "AliTPCcalibDB.h"
 #include "AliHLTTPCGeometry.h"
 #include "TPCFastTransform.h"
+#include "AliTPCSpaceCharge3DCalc.h"
+#include <vector>
 
 namespace ali_tpc_common {
 namespace tpc_fast_transformation {
@@ -296,4 +298,100 @@ int TPCFastTransformManager::updateCalibration( TPCFastTransform &fastTransform,
 }
  
 
+int TPCFastTransformManager::updateDistortion( TPCFastTransform &fastTransform, AliTPCSpaceCharge3DCalc *spaceCharge )
+{
+  /// Fills the distortion splines of the fast transformation from the space-charge correction map.
+  /// The nominal position of each spline knot is corrected with the map, the difference is stored as the distortion.
+  /// Only the distortion is changed, the geometry and the drift calibration of fastTransform must already be set.
+  /// All knots are evaluated with one batched look-up.
+
+  if( !spaceCharge ) return storeError( -1, "TPCFastTransformManager::updateDistortion: No space-charge map given");
+
+  TPCDistortionIRS& distortion = fastTransform.getDistortionNonConst();
+
+  const int nSlices = distortion.getNumberOfSlices();
+  const int nRows = distortion.getNumberOfRows();
+
+  // first knot of each slice & row in the batch
+
+  std::vector<int> firstKnot( nSlices*nRows + 1 );
+  firstKnot[0] = 0;
+  for( int slice=0; slice<nSlices; slice++){
+    for( int row=0; row<nRows; row++ ){
+      int i = slice*nRows + row;
+      firstKnot[i+1] = firstKnot[i] + distortion.getSpline( slice, row ).getNumberOfKnots();
+    }
+  }
+  const int nKnots = firstKnot[nSlices*nRows];
+
+  // nominal knot positions in cylindrical coordinates
+
+  std::vector<float> knotUV( 2*nKnots );
+  std::vector<float> points( 3*nKnots );
+  std::vector<float> corrections( 3*nKnots );
+  std::vector<Short_t> rocs( nKnots );
+
+  for( int slice=0; slice<nSlices; slice++){
+    const TPCFastTransform::SliceInfo &sliceInfo = fastTransform.getSliceInfo( slice );
+    for( int row=0; row<nRows; row++ ){
+      const TPCFastTransform::RowInfo &rowInfo = fastTransform.getRowInfo( row );
+      const IrregularSpline2D3D& spline = distortion.getSpline( slice, row );
+      for( int knot=0; knot<spline.getNumberOfKnots(); knot++ ){
+	int i = firstKnot[slice*nRows + row] + knot;
+	float x = rowInfo.x;
+	float su=0, sv=0;
+	spline.getKnotUV( knot, su, sv );
+	float u=0, v=0;
+	distortion.convSUVtoUV( slice, row, su, sv, u, v );
+	float y=0, z=0;
+	fastTransform.convUVtoYZ( slice, row, x, u, v, y, z );
+	float gx = x*sliceInfo.cosAlpha - y*sliceInfo.sinAlpha;
+	float gy = x*sliceInfo.sinAlpha + y*sliceInfo.cosAlpha;
+	knotUV[2*i+0] = u;
+	knotUV[2*i+1] = v;
+	points[3*i+0] = sqrt( gx*gx + gy*gy );
+	points[3*i+1] = atan2( gy, gx );
+	points[3*i+2] = z;
+	rocs[i] = slice; // the ROC number only defines the TPC side
+      }
+    }
+  }
+
+  spaceCharge->GetCorrectionCyl( nKnots, points.data(), rocs.data(), corrections.data() );
+
+  // distortions in x,u,v: corrected position - nominal position
+
+  for( int slice=0; slice<nSlices; slice++){
+    const TPCFastTransform::SliceInfo &sliceInfo = fastTransform.getSliceInfo( slice );
+    for( int row=0; row<nRows; row++ ){
+      const TPCFastTransform::RowInfo &rowInfo = fastTransform.getRowInfo( row );
+      const IrregularSpline2D3D& spline = distortion.getSpline( slice, row );
+      float *data = distortion.getSplineDataNonConst(slice,row);
+      for( int knot=0; knot<spline.getNumberOfKnots(); knot++ ){
+	int i = firstKnot[slice*nRows + row] + knot;
+	float r = points[3*i+0];
+	float phi = points[3*i+1];
+	float cr = r + corrections[3*i+0];
+	float cphi = phi;
+	if( r > 0.f ) cphi += corrections[3*i+1] / r;
+	float cz = points[3*i+2] + corrections[3*i+2];
+	float gx = cr*cos(cphi);
+	float gy = cr*sin(cphi);
+	// back to the local coordinates of the slice
+	float ox = gx*sliceInfo.cosAlpha + gy*sliceInfo.sinAlpha;
+	float oy = -gx*sliceInfo.sinAlpha + gy*sliceInfo.cosAlpha;
+	float ou=0, ov=0;
+	fastTransform.convYZtoUV( slice, row, ox, oy, cz, ou, ov );
+	data[3*knot+0] = ox - rowInfo.x;
+	data[3*knot+1] = ou - knotUV[2*i+0];
+	data[3*knot+2] = ov - knotUV[2*i+1];
+      } // knots
+      spline.correctEdges(data);
+    } // row
+  } // slice
+
+  return 0;
+}
+
+
 }} // namespaces
@@ -24,6 +24,8 @@
 #include "TString.h"
 #include "AliTPCTransform.h"
 
+class AliTPCSpaceCharge3DCalc;
+
 namespace ali_tpc_common {
 namespace tpc_fast_transformation {
 class TPCFastTransform;
@@ -56,6 +58,9 @@ class TPCFastTransformManager
 
   /// Updates the transformation with the new time stamp 
   Int_t updateCalibration( TPCFastTransform &spline, Long_t TimeStamp );
+
+  /// Fills the distortion splines directly from a space-charge correction map
+  int updateDistortion( TPCFastTransform &fastTransform, AliTPCSpaceCharge3DCalc *spaceCharge );
   
   /// _______________  Utilities   ________________________
 
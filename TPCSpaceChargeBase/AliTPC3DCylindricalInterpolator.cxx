@@ -31,8 +31,13 @@ ClassImp(AliTPC3DCylindricalInterpolator)
 ///
 AliTPC3DCylindricalInterpolator::AliTPC3DCylindricalInterpolator() {
   fOrder = 1;
+  fValue = NULL;
+  fSecondDerZ = NULL;
   fIsAllocatingLookUp = kFALSE;
   fIsInitCubic = kFALSE;
+  fIsRegularR = kFALSE;
+  fIsRegularPhi = kFALSE;
+  fIsRegularZ = kFALSE;
 }
 
 /// destructor
@@ -60,6 +65,40 @@ Double_t AliTPC3DCylindricalInterpolator::GetValue(Double_t r, Double_t phi, Dou
   return InterpolateCylindrical(r, z, phi);
 }
 
+/// Get interpolation value on a point in a cylindrical volume, starting the grid search from a guess
+///
+/// The grid indices found for this point are returned in rLow, phiLow and zLow, so that the search
+/// for a neighbouring point is a short hunt instead of a full bisection.
+///
+/// \param r position r
+/// \param phi position $\phi$
+/// \param z position  z
+/// \param rLow Int_t& guess for the grid index in r (input/output)
+/// \param phiLow Int_t& guess for the grid index in $\phi$ (input/output)
+/// \param zLow Int_t& guess for the grid index in z (input/output)
+///
+/// \return interpolation value
+Double_t AliTPC3DCylindricalInterpolator::GetValue(Double_t r, Double_t phi, Double_t z, Int_t &rLow, Int_t &phiLow,
+                                                   Int_t &zLow) {
+  return InterpolateCylindrical(r, z, phi, rLow, zLow, phiLow);
+}
+
+/// Get interpolation values for an array of points in a cylindrical volume
+///
+/// The grid search of each point starts from the indices of the previous one, points should be ordered
+/// (e.g. along a track) for best performance.
+///
+/// \param n Int_t number of points
+/// \param r const Double_t[] position r
+/// \param phi const Double_t[] position $\phi$
+/// \param z const Double_t[] position z
+/// \param value Double_t[] interpolation values (output)
+void AliTPC3DCylindricalInterpolator::GetValue(const Int_t n, const Double_t r[], const Double_t phi[],
+                                               const Double_t z[], Double_t value[]) {
+  Int_t rLow = 0, phiLow = 0, zLow = 0;
+  for (Int_t i = 0; i < n; i++) value[i] = InterpolateCylindrical(r[i], z[i], phi[i], rLow, zLow, phiLow);
+}
+
 /// Get interpolation value on a point in a cylindrical volume
 ///
 /// \param r Double_t position r
@@ -68,6 +107,22 @@ Double_t AliTPC3DCylindricalInterpolator::GetValue(Double_t r, Double_t phi, Dou
 ///
 /// \return interpolation value
 Double_t AliTPC3DCylindricalInterpolator::InterpolateCylindrical(Double_t r, Double_t z, Double_t phi) {
+  Int_t rLow = 0, zLow = 0, phiLow = 0;
+  return InterpolateCylindrical(r, z, phi, rLow, zLow, phiLow);
+}
+
+/// Get interpolation value on a point in a cylindrical volume
+///
+/// \param r Double_t position r
+/// \param phi Double_t position $\phi$
+/// \param z Double_t position  z
+/// \param rLow Int_t& guess for the grid index in r (input/output)
+/// \param zLow Int_t& guess for the grid index in z (input/output)
+/// \param phiLow Int_t& guess for the grid index in $\phi$ (input/output)
+///
+/// \return interpolation value
+Double_t AliTPC3DCylindricalInterpolator::InterpolateCylindrical(Double_t r, Double_t z, Double_t phi, Int_t &rLow,
+                                                                 Int_t &zLow, Int_t &phiLow) {
   Int_t iLow = 0, jLow = 0, m = 0;
   Int_t kLow = 0;
   Int_t index;
@@ -85,9 +140,12 @@ Double_t AliTPC3DCylindricalInterpolator::InterpolateCylindrical(Double_t r, Dou
   while (phi > TMath::TwoPi()) phi = phi - TMath::TwoPi();
 
   // search lowest index related to r,z and phi
-  Search(fNR, fRList, r, iLow);
-  Search(fNZ, fZList, z, jLow);
-  Search(fNPhi, fPhiList, phi, kLow);
+  Search(fNR, fRList, fIsRegularR, r, rLow);
+  Search(fNZ, fZList, fIsRegularZ, z, zLow);
+  Search(fNPhi, fPhiList, fIsRegularPhi, phi, phiLow);
+  iLow = rLow;
+  jLow = zLow;
+  kLow = phiLow;
 
   // order >= 3
   kLow -= (fOrder / 2);
@@ -363,15 +421,17 @@ void AliTPC3DCylindricalInterpolator::Search(Int_t n, const Double_t xArray[], D
     high = n;
   } else {                                            // Ordered Search phase
     if ((Int_t)(x > xArray[low]) == ascend) {
-      if (low == n - 1) return;
       high = low + 1;
-      while ((Int_t)(x > xArray[high]) == ascend) {
-        low = high;
-        increment *= 2;
-        high = low + increment;
-        if (high > n - 1) {
-          high = n;
-          break;
+      if (high > n - 1) high = n;
+      else {
+        while ((Int_t)(x > xArray[high]) == ascend) {
+          low = high;
+          increment *= 2;
+          high = low + increment;
+          if (high > n - 1) {
+            high = n;
+            break;
+          }
         }
       }
     } else {
@@ -379,14 +439,16 @@ void AliTPC3DCylindricalInterpolator::Search(Int_t n, const Double_t xArray[], D
         low = -1;
         return;
       }
-      high = low - 1;
-      while ((Int_t)(x < xArray[low]) == ascend) {
+      high = low;
+      low = high - increment;
+      while ((Int_t)(x > xArray[low]) != ascend) {
         high = low;
         increment *= 2;
-        if (increment >= high) {
+        low = high - increment;
+        if (low < 0) {
           low = -1;
           break;
-        } else low = high - increment;
+        }
       }
     }
   }
@@ -404,6 +466,47 @@ void AliTPC3DCylindricalInterpolator::Search(Int_t n, const Double_t xArray[], D
 
 }
 
+/// Search the nearest grid index position to a Point
+///
+/// On an equidistant grid the index is computed directly from the position, otherwise the ordered
+/// table is searched by hunting up or down from the guess in low. Either way low ends up as the last
+/// grid index with xArray[low] < x (-1 below and n above the grid), independent of the guess.
+///
+/// \param n
+/// \param xArray
+/// \param isRegular Bool_t xArray has equidistant points
+/// \param x
+/// \param low
+void AliTPC3DCylindricalInterpolator::Search(Int_t n, const Double_t xArray[], Bool_t isRegular, Double_t x,
+                                             Int_t &low) {
+  if (!isRegular || x < xArray[0] || x > xArray[n - 1]) {
+    Search(n, xArray, x, low);
+    return;
+  }
+
+  low = (Int_t) TMath::Ceil((x - xArray[0]) / (xArray[1] - xArray[0])) - 1;
+  if (low < -1) low = -1;
+  if (low > n - 1) low = n - 1;
+  // correct for rounding, low is the last grid point below x
+  while (low < n - 1 && x > xArray[low + 1]) low++;
+  while (low >= 0 && !(x > xArray[low])) low--;
+}
+
+/// Check if a list of grid points is equidistant
+///
+/// \param n Int_t number of points
+/// \param xArray const Double_t[] grid points
+/// \return kTRUE if the points are increasing with a constant step
+Bool_t AliTPC3DCylindricalInterpolator::IsRegular(Int_t n, const Double_t xArray[]) {
+  if (n < 2) return kFALSE;
+  const Double_t step = xArray[1] - xArray[0];
+  if (step <= 0) return kFALSE;
+  for (Int_t i = 2; i < n; i++) {
+    if (TMath::Abs(xArray[i] - xArray[i - 1] - step) > 1e-6 * step) return kFALSE;
+  }
+  return kTRUE;
+}
+
 /// Set the value as interpolation point
 ///
 /// \param matricesVal TMatrixD** reference value for each point
@@ -454,6 +557,7 @@ void AliTPC3DCylindricalInterpolator::SetValue(TMatrixD **matricesVal,Int_t iZ)
 void AliTPC3DCylindricalInterpolator::SetRList(Double_t *rList) {
   fRList = new Double_t[fNR];
   for (Int_t i = 0; i < fNR; i++) fRList[i] = rList[i];
+  fIsRegularR = IsRegular(fNR, fRList);
 }
 
 /// set the position of phi
@@ -462,6 +566,7 @@ void AliTPC3DCylindricalInterpolator::SetRList(Double_t *rList) {
 void AliTPC3DCylindricalInterpolator::SetPhiList(Double_t *phiList) {
   fPhiList = new Double_t[fNPhi];
   for (Int_t i = 0; i < fNPhi; i++) fPhiList[i] = phiList[i];
+  fIsRegularPhi = IsRegular(fNPhi, fPhiList);
 
 }
 
@@ -471,6 +576,7 @@ void AliTPC3DCylindricalInterpolator::SetPhiList(Double_t *phiList) {
 void AliTPC3DCylindricalInterpolator::SetZList(Double_t *zList) {
   fZList = new Double_t[fNZ];
   for (Int_t i = 0; i < fNZ; i++) fZList[i] = zList[i];
+  fIsRegularZ = IsRegular(fNZ, fZList);
 
 }
 
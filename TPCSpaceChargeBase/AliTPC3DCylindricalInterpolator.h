@@ -21,6 +21,8 @@ public:
   AliTPC3DCylindricalInterpolator();
   virtual ~AliTPC3DCylindricalInterpolator();
   Double_t GetValue(Double_t r, Double_t phi, Double_t z);
+  Double_t GetValue(Double_t r, Double_t phi, Double_t z, Int_t &rLow, Int_t &phiLow, Int_t &zLow);
+  void GetValue(const Int_t n, const Double_t r[], const Double_t phi[], const Double_t z[], Double_t value[]);
   void InitCubicSpline();
   void SetOrder(Int_t order) { fOrder = order; }
   void SetNR(Int_t nR) { fNR = nR; }
@@ -39,6 +41,7 @@ public:
   Int_t GetOrder() { return fOrder; }
 
   Double_t * GetSecondDerZ() {return fSecondDerZ;}
+  Double_t * GetValues() {return fValue;}
 private:
   Int_t fOrder; ///< Order of interpolation, 1 - linear, 2 - quadratic, 3 >= - cubic,
   Int_t fNR; ///< Grid size in direction of R
@@ -53,13 +56,19 @@ private:
 
   Bool_t fIsAllocatingLookUp; ///< is allocating memory
   Bool_t fIsInitCubic; ///< is cubic second derivative already been initialized
+  Bool_t fIsRegularR; //!<! fRList has equidistant points, grid index can be computed directly
+  Bool_t fIsRegularPhi; //!<! fPhiList has equidistant points, grid index can be computed directly
+  Bool_t fIsRegularZ; //!<! fZList has equidistant points, grid index can be computed directly
 
   Double_t InterpolatePhi(Double_t xArray[], const Int_t iLow, const Int_t lenX, Double_t yArray[], Double_t x);
   Double_t InterpolateCylindrical(Double_t r, Double_t z, Double_t phi);
+  Double_t InterpolateCylindrical(Double_t r, Double_t z, Double_t phi, Int_t &rLow, Int_t &zLow, Int_t &phiLow);
   Double_t Interpolate(Double_t xArray[], Double_t yArray[], Double_t x);
   Double_t InterpolateCubicSpline(Double_t *xArray, Double_t *yArray, Double_t *y2Array, const Int_t nxArray,
                                   const Int_t nyArray, const Int_t ny2Array, Double_t x, const Int_t skip);
   void Search(Int_t n, const Double_t xArray[], Double_t x, Int_t &low);
+  void Search(Int_t n, const Double_t xArray[], Bool_t isRegular, Double_t x, Int_t &low);
+  static Bool_t IsRegular(Int_t n, const Double_t xArray[]);
   void InitCubicSpline(Double_t *xArray, Double_t *yArray, const Int_t n, Double_t *y2Array, const Int_t skip);
   void InitCubicSpline(Double_t *xArray, Double_t *yArray, const Int_t n, Double_t *y2Array, const Int_t skip,
                        Double_t yp0, Double_t ypn1);
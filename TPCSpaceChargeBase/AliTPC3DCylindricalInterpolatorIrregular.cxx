@@ -348,15 +348,17 @@ void AliTPC3DCylindricalInterpolatorIrregular::Search(Int_t n, Double_t *xArray,
     high = n;
   } else {                                            // Ordered Search phase
     if ((Int_t)(x >= xArray[low * offset]) == ascend) {
-      if (low == n - 1) return;
       high = low + 1;
-      while ((Int_t)(x >= xArray[high * offset]) == ascend) {
-        low = high;
-        increment *= 2;
-        high = low + increment;
-        if (high > n - 1) {
-          high = n;
-          break;
+      if (high > n - 1) high = n;
+      else {
+        while ((Int_t)(x >= xArray[high * offset]) == ascend) {
+          low = high;
+          increment *= 2;
+          high = low + increment;
+          if (high > n - 1) {
+            high = n;
+            break;
+          }
         }
       }
     } else {
@@ -364,14 +366,16 @@ void AliTPC3DCylindricalInterpolatorIrregular::Search(Int_t n, Double_t *xArray,
         low = -1;
         return;
       }
-      high = low - 1;
-      while ((Int_t)(x < xArray[low * offset]) == ascend) {
+      high = low;
+      low = high - increment;
+      while ((Int_t)(x >= xArray[low * offset]) != ascend) {
         high = low;
         increment *= 2;
-        if (increment >= high) {
+        low = high - increment;
+        if (low < 0) {
           low = -1;
           break;
-        } else low = high - increment;
+        }
       }
     }
   }
@@ -384,8 +388,8 @@ void AliTPC3DCylindricalInterpolatorIrregular::Search(Int_t n, Double_t *xArray,
       high = middle;
   }
 
-  if (x > xArray[n - 1]) low = n;
-  if (x < xArray[0]) low = -1;
+  if (x > xArray[(n - 1) * offset]) low = n;
+  if (x < xArray[0 * offset]) low = -1;
 
 }
 
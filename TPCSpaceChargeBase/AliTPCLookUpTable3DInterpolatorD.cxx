@@ -219,6 +219,45 @@ void AliTPCLookUpTable3DInterpolatorD::GetValue(
   zValue = fInterpolatorZ->GetValue(r, phi, z);
 }
 
+/// get value of 3-components at a P(r,phi,z), starting the grid search from a guess
+///
+/// The three components share the grid, the indices found for the first component are reused for the others
+/// and returned for the search of the next point.
+///
+/// \param r Double_t r position
+/// \param phi Double_t phi position
+/// \param z Double_t z position
+/// \param rValue Double_t value of r-component
+/// \param phiValue Double_t value of phi-component
+/// \param zValue Double_t value of z-component
+/// \param rLow Int_t& guess for the grid index in r (input/output)
+/// \param phiLow Int_t& guess for the grid index in phi (input/output)
+/// \param zLow Int_t& guess for the grid index in z (input/output)
+void AliTPCLookUpTable3DInterpolatorD::GetValue(
+        Double_t r, Double_t phi, Double_t z,
+        Double_t &rValue, Double_t &phiValue, Double_t &zValue,
+        Int_t &rLow, Int_t &phiLow, Int_t &zLow) {
+  rValue = fInterpolatorR->GetValue(r, phi, z, rLow, phiLow, zLow);
+  phiValue = fInterpolatorPhi->GetValue(r, phi, z, rLow, phiLow, zLow);
+  zValue = fInterpolatorZ->GetValue(r, phi, z, rLow, phiLow, zLow);
+}
+
+/// get value of 3-components for an array of points
+///
+/// \param n Int_t number of points
+/// \param r const Double_t[] r position
+/// \param phi const Double_t[] phi position
+/// \param z const Double_t[] z position
+/// \param rValue Double_t[] value of r-component (output)
+/// \param phiValue Double_t[] value of phi-component (output)
+/// \param zValue Double_t[] value of z-component (output)
+void AliTPCLookUpTable3DInterpolatorD::GetValue(
+        const Int_t n, const Double_t r[], const Double_t phi[], const Double_t z[],
+        Double_t rValue[], Double_t phiValue[], Double_t zValue[]) {
+  Int_t rLow = 0, phiLow = 0, zLow = 0;
+  for (Int_t i = 0; i < n; i++) GetValue(r[i], phi[i], z[i], rValue[i], phiValue[i], zValue[i], rLow, phiLow, zLow);
+}
+
 
 // Set Order of interpolation
 //
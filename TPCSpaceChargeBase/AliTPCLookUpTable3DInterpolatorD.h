@@ -41,6 +41,10 @@ public:
 	void SetOrder(Int_t order);
 	void GetValue(Double_t r, Double_t phi, Double_t z, Double_t &rValue, Double_t &phiValue, Double_t &zValue);
   void GetValue(Double_t r, Double_t phi, Double_t z, Float_t &rValue, Float_t &phiValue, Float_t &zValue);
+  void GetValue(Double_t r, Double_t phi, Double_t z, Double_t &rValue, Double_t &phiValue, Double_t &zValue,
+                Int_t &rLow, Int_t &phiLow, Int_t &zLow);
+  void GetValue(const Int_t n, const Double_t r[], const Double_t phi[], const Double_t z[], Double_t rValue[],
+                Double_t phiValue[], Double_t zValue[]);
 	void CopyFromMatricesToInterpolator();
 	void CopyFromMatricesToInterpolator(Int_t iZ); // copy only iZ
 
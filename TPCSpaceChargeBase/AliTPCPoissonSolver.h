@@ -72,6 +72,7 @@ public:
       cycleType = kFCycle;
       gtType = kFull; // default full
       relaxType = kGaussSeidel; // default relaxation method
+      gamma = 1;
       nPre = 2;
       nPost = 2;
       nMGCycle = 200;
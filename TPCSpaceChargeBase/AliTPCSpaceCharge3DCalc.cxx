@@ -22,6 +22,8 @@
 /// \author Rifki Sadikin <rifki.sadikin@cern.ch>, Indonesian Institute of Sciences
 /// \date Nov 20, 2017
 
+#include <cstdio>
+#include <cstring>
 #include "TStopwatch.h"
 #include "TMath.h"
 #include "AliTPCSpaceCharge3DCalc.h"
@@ -397,7 +399,7 @@ AliTPCSpaceCharge3DCalc::~AliTPCSpaceCharge3DCalc() {
 ///
 /// The algorithm and implementations of this function is the following:
 ///
-/// Do for each side A,C
+/// Do for each side A,C (both sides are processed concurrently, see InitSpaceCharge3DPoissonIntegralDzSide)
 ///
 /// 1) Solving \f$ \nabla^2 \Phi(r,\phi,z) = -  \rho(r,\phi,z)\f$
 /// ~~~ Calling poisson solver
@@ -442,18 +444,78 @@ AliTPCSpaceCharge3DCalc::~AliTPCSpaceCharge3DCalc() {
 ///
 void AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz(
   Int_t nRRow, Int_t nZColumn, Int_t phiSlice, Int_t maxIteration, Double_t stoppingConvergence) {
-  Int_t phiSlicesPerSector = phiSlice / kNumSector;
+
+  // do if look up table haven't be initialized
+  if (fInitLookUp) return;
+
+  // look up tables computed before for the same input
+  ULong64_t cacheKey = 0;
+  TString cacheFileName;
+  if (!fLookUpTableCacheDirectory.IsNull()) {
+    cacheKey = GetLookUpTableCacheKey(nRRow, nZColumn, phiSlice, maxIteration, stoppingConvergence);
+    if (cacheKey) {
+      cacheFileName = Form("%s/AliTPCSpaceCharge3DCalc_%016llx.bin", fLookUpTableCacheDirectory.Data(), cacheKey);
+      if (ReadLookUpTableCache(cacheFileName.Data(), cacheKey)) {
+        Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Look up tables read from cache %s", cacheFileName.Data()));
+        fInitLookUp = kTRUE;
+        return;
+      }
+    }
+  }
+
+  AliTPCPoissonSolver::fgConvergenceError = stoppingConvergence;
+
+  // the sides are independent: side A uses fPoissonSolver, side C gets its own solver with the same settings
+  AliTPCPoissonSolver *poissonSolverC = new AliTPCPoissonSolver();
+  poissonSolverC->SetStrategy(fPoissonSolver->GetStrategy());
+  poissonSolverC->fMgParameters = fPoissonSolver->fMgParameters;
+  AliTPCPoissonSolver *poissonSolvers[2] = {fPoissonSolver, poissonSolverC};
+  Profile profiles[2];
+
+#pragma omp parallel for num_threads(2)
+  for (Int_t side = 0; side < 2; side++) {
+    InitSpaceCharge3DPoissonIntegralDzSide(side, poissonSolvers[side], nRRow, nZColumn, phiSlice, maxIteration,
+                                           profiles[side]);
+  }
+  delete poissonSolverC;
+
+  myProfile = profiles[0];
+  fInitLookUp = kTRUE;
+
+  if (cacheKey && !WriteLookUpTableCache(cacheFileName.Data(), cacheKey)) {
+    Warning("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Cannot write look up table cache %s", cacheFileName.Data()));
+  }
+}
+
+/// Solve one side of the TPC for InitSpaceCharge3DPoissonIntegralDz
+///
+/// All temporary matrices and look-up tables are owned by this call, and only the member matrices
+/// and look-up tables of the given side are written, so both sides can run concurrently.
+/// Evaluation of the boundary formulas is serialized, since TF1 / TFormula are not thread-safe.
+///
+/// \param side Int_t side to compute (0 - A, 1 - C)
+/// \param poissonSolver AliTPCPoissonSolver* solver instance used exclusively by this side
+/// \param nRRow Int_t Number of nRRow in r-direction
+/// \param nZColumn Int_t Number of nZColumn in z-direction
+/// \param phiSlice Int_t Number of phi slice in \f$ phi \f$ direction
+/// \param maxIteration Int_t Maximum iteration for poisson solver
+/// \param profile Profile timing of the individual steps (output)
+///
+void AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDzSide(
+  const Int_t side, AliTPCPoissonSolver *poissonSolver, const Int_t nRRow, const Int_t nZColumn,
+  const Int_t phiSlice, const Int_t maxIteration, Profile &profile) {
   const Float_t gridSizeR = (AliTPCPoissonSolver::fgkOFCRadius - AliTPCPoissonSolver::fgkIFCRadius) / (nRRow - 1);
   const Float_t gridSizeZ = AliTPCPoissonSolver::fgkTPCZ0 / (nZColumn - 1);
   const Float_t gridSizePhi = TMath::TwoPi() / phiSlice;
   const Double_t ezField = (AliTPCPoissonSolver::fgkCathodeV - AliTPCPoissonSolver::fgkGG) / AliTPCPoissonSolver::fgkTPCZ0; // = ALICE Electric Field (V/cm) Magnitude ~ -400 V/cm;
+  const char *sideName = side == 0 ? "A" : "C";
 
   // local variables
   Float_t radius0, phi0, z0;
 
   // memory allocation for temporary matrices:
   // potential (boundary values), charge distribution
-  TMatrixD **matricesV, *matricesCharge[phiSlice];
+  TMatrixD *matricesCharge[phiSlice];
   TMatrixD *matricesEr[phiSlice], *matricesEPhi[phiSlice], *matricesEz[phiSlice];
   TMatrixD *matricesDistDrDz[phiSlice], *matricesDistDPhiRDz[phiSlice], *matricesDistDz[phiSlice];
   TMatrixD *matricesCorrDrDz[phiSlice], *matricesCorrDPhiRDz[phiSlice], *matricesCorrDz[phiSlice];
@@ -461,7 +523,6 @@ void AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz(
   TMatrixD *matricesGCorrDrDz[phiSlice], *matricesGCorrDPhiRDz[phiSlice], *matricesGCorrDz[phiSlice];
 
   for (Int_t k = 0; k < phiSlice; k++) {
-    //matricesV[k] = new TMatrixD(nRRow, nZColumn);
     matricesCharge[k] = new TMatrixD(nRRow, nZColumn);
     matricesEr[k] = new TMatrixD(nRRow, nZColumn);
     matricesEPhi[k] = new TMatrixD(nRRow, nZColumn);
@@ -478,23 +539,17 @@ void AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz(
     matricesGCorrDrDz[k] = new TMatrixD(nRRow, nZColumn);
     matricesGCorrDPhiRDz[k] = new TMatrixD(nRRow, nZColumn);
     matricesGCorrDz[k] = new TMatrixD(nRRow, nZColumn);
-
   }
 
   // list of point as used in the poisson relaxation and the interpolation (for interpolation)
   Double_t rList[nRRow], zList[nZColumn], phiList[phiSlice];
 
-  // pointer to current TF1 for potential boundary values
-  TF1 *f1BoundaryIFC = NULL;
-  TF1 *f1BoundaryOFC = NULL;
-  TF1 *f1BoundaryROC = NULL;
   TStopwatch w;
 
   for (Int_t k = 0; k < phiSlice; k++) phiList[k] = gridSizePhi * k;
   for (Int_t i = 0; i < nRRow; i++) rList[i] = AliTPCPoissonSolver::fgkIFCRadius + i * gridSizeR;
   for (Int_t j = 0; j < nZColumn; j++) zList[j] = j * gridSizeZ;
 
-
   // allocate look up local distortion
   AliTPCLookUpTable3DInterpolatorD *lookupLocalDist =
     new AliTPCLookUpTable3DInterpolatorD(
@@ -521,283 +576,174 @@ void AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz(
   // should be set, in another place
   const Int_t symmetry = 0; // fSymmetry
 
-  // for irregular
-  TMatrixD **matricesIrregularDrDz = NULL;
-  TMatrixD **matricesIrregularDPhiRDz = NULL;
-  TMatrixD **matricesIrregularDz = NULL;
-  TMatrixD **matricesPhiIrregular = NULL;
-  TMatrixD **matricesRIrregular = NULL;
-  TMatrixD **matricesZIrregular = NULL;
-
-  // for charge
-  TMatrixD **matricesLookUpCharge = NULL;
-  AliTPC3DCylindricalInterpolator *chargeInterpolator = NULL;
-  AliTPC3DCylindricalInterpolator *potentialInterpolator = NULL;
-  Double_t *potentialBoundary = NULL;
-  TMatrixD *matrixV;
-  TMatrixD *matrixCharge;
-  // for potential
-  TMatrixD **matricesVPotential;
-
-  Int_t pIndex = 0;
-
-  // do if look up table haven't be initialized
-  if (!fInitLookUp) {
-    // initialize for working memory
-    for (Int_t side = 0; side < 2; side++) {
-      // zeroing global distortion/correction
-      for (Int_t k = 0; k < phiSlice; k++) {
-        matricesDistDrDz[k]->Zero();
-        matricesDistDPhiRDz[k]->Zero();
-        matricesDistDz[k]->Zero();
-        matricesCorrDrDz[k]->Zero();
-        matricesCorrDPhiRDz[k]->Zero();
-        matricesCorrDz[k]->Zero();
-
-        matricesGDistDrDz[k]->Zero();
-        matricesGDistDPhiRDz[k]->Zero();
-        matricesGDistDz[k]->Zero();
-        matricesGCorrDrDz[k]->Zero();
-        matricesGCorrDPhiRDz[k]->Zero();
-        matricesGCorrDz[k]->Zero();
-      }
-      if (side == 0) {
-        matricesIrregularDrDz = fMatrixIntCorrDrEzIrregularA;
-        matricesIrregularDPhiRDz = fMatrixIntCorrDPhiREzIrregularA;
-        matricesIrregularDz = fMatrixIntCorrDzIrregularA;
-
-        matricesPhiIrregular = fMatrixPhiListIrregularA;
-        matricesRIrregular = fMatrixRListIrregularA;
-        matricesZIrregular = fMatrixZListIrregularA;
-        matricesLookUpCharge = fMatrixChargeA;
-
-
-	matricesV = fMatrixPotentialA;
-        chargeInterpolator = fInterpolatorChargeA;
-        potentialInterpolator = fInterpolatorPotentialA;
-        fLookupDistA->SetLookUpR(matricesDistDrDz);
-        fLookupDistA->SetLookUpPhi(matricesDistDPhiRDz);
-        fLookupDistA->SetLookUpZ(matricesDistDz);
+  // side dependent members, never touched by the other side
+  TMatrixD **matricesIrregularDrDz = side == 0 ? fMatrixIntCorrDrEzIrregularA : fMatrixIntCorrDrEzIrregularC;
+  TMatrixD **matricesIrregularDPhiRDz = side == 0 ? fMatrixIntCorrDPhiREzIrregularA : fMatrixIntCorrDPhiREzIrregularC;
+  TMatrixD **matricesIrregularDz = side == 0 ? fMatrixIntCorrDzIrregularA : fMatrixIntCorrDzIrregularC;
+  TMatrixD **matricesPhiIrregular = side == 0 ? fMatrixPhiListIrregularA : fMatrixPhiListIrregularC;
+  TMatrixD **matricesRIrregular = side == 0 ? fMatrixRListIrregularA : fMatrixRListIrregularC;
+  TMatrixD **matricesZIrregular = side == 0 ? fMatrixZListIrregularA : fMatrixZListIrregularC;
+  TMatrixD **matricesV = side == 0 ? fMatrixPotentialA : fMatrixPotentialC;
+  TMatrixD **matricesIntDistDrEz = side == 0 ? fMatrixIntDistDrEzA : fMatrixIntDistDrEzC;
+  TMatrixD **matricesIntDistDPhiREz = side == 0 ? fMatrixIntDistDPhiREzA : fMatrixIntDistDPhiREzC;
+  TMatrixD **matricesIntDistDz = side == 0 ? fMatrixIntDistDzA : fMatrixIntDistDzC;
+  TMatrixD **matricesIntCorrDrEz = side == 0 ? fMatrixIntCorrDrEzA : fMatrixIntCorrDrEzC;
+  TMatrixD **matricesIntCorrDPhiREz = side == 0 ? fMatrixIntCorrDPhiREzA : fMatrixIntCorrDPhiREzC;
+  TMatrixD **matricesIntCorrDz = side == 0 ? fMatrixIntCorrDzA : fMatrixIntCorrDzC;
+  AliTPC3DCylindricalInterpolator *chargeInterpolator = side == 0 ? fInterpolatorChargeA : fInterpolatorChargeC;
+  AliTPC3DCylindricalInterpolator *potentialInterpolator = side == 0 ? fInterpolatorPotentialA : fInterpolatorPotentialC;
+  AliTPCLookUpTable3DInterpolatorD *lookupDist = side == 0 ? fLookupDistA : fLookupDistC;
+  AliTPCLookUpTable3DInterpolatorD *lookupElectricField = side == 0 ? fLookupElectricFieldA : fLookupElectricFieldC;
+  AliTPCLookUpTable3DInterpolatorD *lookupIntDist = side == 0 ? fLookupIntDistA : fLookupIntDistC;
+  AliTPCLookUpTable3DInterpolatorD *lookupIntCorr = side == 0 ? fLookupIntCorrA : fLookupIntCorrC;
+  AliTPCLookUpTable3DInterpolatorIrregularD *lookupIntCorrIrregular = side == 0 ? fLookupIntCorrIrregularA : fLookupIntCorrIrregularC;
 
-
-        fLookupElectricFieldA->SetLookUpR(matricesEr);
-        fLookupElectricFieldA->SetLookUpPhi(matricesEPhi);
-        fLookupElectricFieldA->SetLookUpZ(matricesEz);
-
-        potentialBoundary = fListPotentialBoundaryA;
-        f1BoundaryIFC = fFormulaBoundaryIFCA;
-        f1BoundaryOFC = fFormulaBoundaryOFCA;
-        f1BoundaryROC = fFormulaBoundaryROCA;
-      } else {
-        matricesIrregularDrDz = fMatrixIntCorrDrEzIrregularC;
-        matricesIrregularDPhiRDz = fMatrixIntCorrDPhiREzIrregularC;
-        matricesIrregularDz = fMatrixIntCorrDzIrregularC;
-        matricesPhiIrregular = fMatrixPhiListIrregularC;
-        matricesRIrregular = fMatrixRListIrregularC;
-        matricesZIrregular = fMatrixZListIrregularC;
-        matricesLookUpCharge = fMatrixChargeC;
-	matricesV = fMatrixPotentialC;
-        chargeInterpolator = fInterpolatorChargeC;
-        potentialInterpolator = fInterpolatorPotentialC;
-        fLookupDistC->SetLookUpR(matricesDistDrDz);
-        fLookupDistC->SetLookUpPhi(matricesDistDPhiRDz);
-        fLookupDistC->SetLookUpZ(matricesDistDz);
-        fLookupElectricFieldC->SetLookUpR(matricesEr);
-        fLookupElectricFieldC->SetLookUpPhi(matricesEPhi);
-        fLookupElectricFieldC->SetLookUpZ(matricesEz);
-
-        potentialBoundary = fListPotentialBoundaryC;
-        f1BoundaryIFC = fFormulaBoundaryIFCC;
-        f1BoundaryOFC = fFormulaBoundaryOFCC;
-        f1BoundaryROC = fFormulaBoundaryROCC;
-      }
-
-      // fill the potential boundary
-      // guess the initial potential
-      // fill also charge
-      //pIndex = 0;
-
-      Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step = 0: Fill Boundary and Charge Densities"));
-      for (Int_t k = 0; k < phiSlice; k++) {
-        phi0 = k * gridSizePhi;
-        matrixV = matricesV[k];
-        matrixCharge = matricesCharge[k];
-        for (Int_t i = 0; i < nRRow; i++) {
-          radius0 = AliTPCPoissonSolver::fgkIFCRadius + i * gridSizeR;
-          for (Int_t j = 0; j < nZColumn; j++) {
-            z0 = j * gridSizeZ;
-            (*matrixCharge)(i, j) = chargeInterpolator->GetValue(rList[i], phiList[k], zList[j]);
-            (*matrixV)(i, j) = 0.0; // fill zeros
-            
-	    if (fFormulaPotentialV == NULL) {
-              // boundary IFC
-              if (i == 0) {
-                if (f1BoundaryIFC != NULL) {
-                  (*matrixV)(i, j) = f1BoundaryIFC->Eval(z0);
-                }
-              }
-              if (i == (nRRow - 1)) {
-                if (f1BoundaryOFC != NULL)
-                  (*matrixV)(i, j) = f1BoundaryOFC->Eval(z0);
-              }
-              if (j == 0) {
-                if (fFormulaBoundaryCE) {
-                  (*matrixV)(i, j) = fFormulaBoundaryCE->Eval(radius0);
-                }
-              }
-              if (j == (nZColumn - 1)) {
-                if (f1BoundaryROC != NULL)
-                  (*matrixV)(i, j) = f1BoundaryROC->Eval(radius0);
-              }
-            } else {
-              if ((i == 0) || (i == (nRRow - 1)) || (j == 0) || (j == (nZColumn - 1))) {
-                (*matrixV)(i, j) = fFormulaPotentialV->Eval(radius0, phi0, z0);
-              }
+  // pointer to current TF1 for potential boundary values
+  TF1 *f1BoundaryIFC = side == 0 ? fFormulaBoundaryIFCA : fFormulaBoundaryIFCC;
+  TF1 *f1BoundaryOFC = side == 0 ? fFormulaBoundaryOFCA : fFormulaBoundaryOFCC;
+  TF1 *f1BoundaryROC = side == 0 ? fFormulaBoundaryROCA : fFormulaBoundaryROCC;
+
+  lookupDist->SetLookUpR(matricesDistDrDz);
+  lookupDist->SetLookUpPhi(matricesDistDPhiRDz);
+  lookupDist->SetLookUpZ(matricesDistDz);
+
+  lookupElectricField->SetLookUpR(matricesEr);
+  lookupElectricField->SetLookUpPhi(matricesEPhi);
+  lookupElectricField->SetLookUpZ(matricesEz);
+
+  // fill the potential boundary
+  // guess the initial potential
+  // fill also charge
+  Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step = 0: Fill Boundary and Charge Densities (side %s)", sideName));
+#pragma omp critical(AliTPCSpaceCharge3DCalcFormula)
+  for (Int_t k = 0; k < phiSlice; k++) {
+    phi0 = k * gridSizePhi;
+    TMatrixD *matrixV = matricesV[k];
+    TMatrixD *matrixCharge = matricesCharge[k];
+    for (Int_t i = 0; i < nRRow; i++) {
+      radius0 = AliTPCPoissonSolver::fgkIFCRadius + i * gridSizeR;
+      for (Int_t j = 0; j < nZColumn; j++) {
+        z0 = j * gridSizeZ;
+        (*matrixCharge)(i, j) = chargeInterpolator->GetValue(rList[i], phiList[k], zList[j]);
+        (*matrixV)(i, j) = 0.0; // fill zeros
+
+        if (fFormulaPotentialV == NULL) {
+          // boundary IFC
+          if (i == 0) {
+            if (f1BoundaryIFC != NULL) {
+              (*matrixV)(i, j) = f1BoundaryIFC->Eval(z0);
+            }
+          }
+          if (i == (nRRow - 1)) {
+            if (f1BoundaryOFC != NULL)
+              (*matrixV)(i, j) = f1BoundaryOFC->Eval(z0);
+          }
+          if (j == 0) {
+            if (fFormulaBoundaryCE) {
+              (*matrixV)(i, j) = fFormulaBoundaryCE->Eval(radius0);
             }
           }
+          if (j == (nZColumn - 1)) {
+            if (f1BoundaryROC != NULL)
+              (*matrixV)(i, j) = f1BoundaryROC->Eval(radius0);
+          }
+        } else {
+          if ((i == 0) || (i == (nRRow - 1)) || (j == 0) || (j == (nZColumn - 1))) {
+            (*matrixV)(i, j) = fFormulaPotentialV->Eval(radius0, phi0, z0);
+          }
         }
       }
-      Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 0: Preparing Charge interpolator: %f\n", w.CpuTime()));
-      AliTPCPoissonSolver::fgConvergenceError = stoppingConvergence;
-
-      //fPoissonSolver->SetStrategy(AliTPCPoissonSolver::kMultiGrid);
-      //(fPoissonSolver->fMgParameters).cycleType = AliTPCPoissonSolver::kFCycle;
-      //(fPoissonSolver->fMgParameters).isFull3D = kFALSE;
-      //(fPoissonSolver->fMgParameters).nMGCycle = maxIteration;
-      //(fPoissonSolver->fMgParameters).maxLoop = 6;
-
-
-      w.Start();
-      fPoissonSolver->PoissonSolver3D(matricesV, matricesCharge, nRRow, nZColumn, phiSlice, maxIteration,
-                                      symmetry);
-      w.Stop();
-
-      potentialInterpolator->SetValue(matricesV);
-      potentialInterpolator->InitCubicSpline();
-
-
-      Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 1: Poisson solver: %f\n", w.CpuTime()));
-      if (side == 0) myProfile.poissonSolverTime = w.CpuTime();
-      if (side == 0) myProfile.iteration = fPoissonSolver->fIterations;
-
-
-      w.Start();
-      ElectricField(matricesV,
-                    matricesEr, matricesEPhi, matricesEz, nRRow, nZColumn, phiSlice,
-                    gridSizeR, gridSizePhi, gridSizeZ, symmetry, AliTPCPoissonSolver::fgkIFCRadius);
-      w.Stop();
-
-      myProfile.electricFieldTime = w.CpuTime();
-      Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 2: Electric Field Calculation: %f\n", w.CpuTime()));
-      w.Start();
-      LocalDistCorrDz(matricesEr, matricesEPhi, matricesEz,
-                      matricesDistDrDz, matricesDistDPhiRDz, matricesDistDz,
-                      matricesCorrDrDz, matricesCorrDPhiRDz, matricesCorrDz,
-                      nRRow, nZColumn, phiSlice, gridSizeZ, ezField);
-      w.Stop();
-      myProfile.localDistortionTime = w.CpuTime();
-
-      // copy to interpolator
-      if (side == 0) {
-        lookupLocalDist->CopyFromMatricesToInterpolator();
-        lookupLocalCorr->CopyFromMatricesToInterpolator();
-        fLookupDistA->CopyFromMatricesToInterpolator();
-        fLookupElectricFieldA->CopyFromMatricesToInterpolator();
-      } else {
-        lookupLocalDist->CopyFromMatricesToInterpolator();
-        lookupLocalCorr->CopyFromMatricesToInterpolator();
-        fLookupDistC->CopyFromMatricesToInterpolator();
-        fLookupElectricFieldC->CopyFromMatricesToInterpolator();
-      }
-
-      Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 3: Local distortion and correction: %f\n", w.CpuTime()));
-      w.Start();
-      if (fIntegrationStrategy == kNaive)
-	IntegrateDistCorrDriftLineDz(
-          lookupLocalDist,
-          matricesGDistDrDz, matricesGDistDPhiRDz, matricesGDistDz,
-          lookupLocalCorr,
-          matricesGCorrDrDz, matricesGCorrDPhiRDz, matricesGCorrDz,
-          matricesIrregularDrDz, matricesIrregularDPhiRDz, matricesIrregularDz,
-          matricesRIrregular, matricesPhiIrregular, matricesZIrregular,
-          nRRow, nZColumn, phiSlice, rList, phiList, zList
-        );
-      else
-	IntegrateDistCorrDriftLineDzWithLookUp ( 
-          lookupLocalDist,
-          matricesGDistDrDz, matricesGDistDPhiRDz, matricesGDistDz,
-          lookupLocalCorr,
-          matricesGCorrDrDz, matricesGCorrDPhiRDz, matricesGCorrDz,
-          nRRow, nZColumn, phiSlice, rList, phiList, zList
-	);
-
-      w.Stop();
-      Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 4: Global correction/distortion: %f\n", w.CpuTime()));
-      myProfile.globalDistortionTime = w.CpuTime();
-
-      //// copy to 1D interpolator /////
-      lookupGlobalDist->CopyFromMatricesToInterpolator();
-      if (fCorrectionType==0)
-      	lookupGlobalCorr->CopyFromMatricesToInterpolator();
-      ////
-
-
-       w.Stop();
+    }
+  }
+  Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 0: Preparing Charge interpolator: %f\n", w.CpuTime()));
 
-      if (side == 0) {
+  w.Start();
+  poissonSolver->PoissonSolver3D(matricesV, matricesCharge, nRRow, nZColumn, phiSlice, maxIteration,
+                                 symmetry);
+  w.Stop();
 
-	w.Start();
-        FillLookUpTable(lookupGlobalDist,
-                        fMatrixIntDistDrEzA, fMatrixIntDistDPhiREzA, fMatrixIntDistDzA,
-                        nRRow, nZColumn, phiSlice, rList, phiList, zList);
+  potentialInterpolator->SetValue(matricesV);
+  potentialInterpolator->InitCubicSpline();
 
-        if (fCorrectionType ==0) 
-		FillLookUpTable(lookupGlobalCorr,
-                        fMatrixIntCorrDrEzA, fMatrixIntCorrDPhiREzA, fMatrixIntCorrDzA,
-                        nRRow, nZColumn, phiSlice, rList, phiList, zList);
+  Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 1: Poisson solver: %f\n", w.CpuTime()));
+  profile.poissonSolverTime = w.CpuTime();
+  profile.iteration = poissonSolver->fIterations;
 
-        fLookupIntDistA->CopyFromMatricesToInterpolator();
-        if (fCorrectionType == 0)
-          fLookupIntCorrA->CopyFromMatricesToInterpolator();
-        else
-          fLookupIntCorrIrregularA->CopyFromMatricesToInterpolator();
+  w.Start();
+  ElectricField(matricesV,
+                matricesEr, matricesEPhi, matricesEz, nRRow, nZColumn, phiSlice,
+                gridSizeR, gridSizePhi, gridSizeZ, symmetry, AliTPCPoissonSolver::fgkIFCRadius);
+  w.Stop();
 
-	w.Stop();
-      	myProfile.interpolationInitTime = w.CpuTime();
-        Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 5: Filling up the look up: %f\n", w.CpuTime()));
-        Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz"," A side done");
-      }
-      if (side == 1) {
-	w.Start();
-        FillLookUpTable(lookupGlobalDist,
-                        fMatrixIntDistDrEzC, fMatrixIntDistDPhiREzC, fMatrixIntDistDzC,
-                        nRRow, nZColumn, phiSlice, rList, phiList, zList);
+  profile.electricFieldTime = w.CpuTime();
+  Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 2: Electric Field Calculation: %f\n", w.CpuTime()));
+  w.Start();
+  LocalDistCorrDz(matricesEr, matricesEPhi, matricesEz,
+                  matricesDistDrDz, matricesDistDPhiRDz, matricesDistDz,
+                  matricesCorrDrDz, matricesCorrDPhiRDz, matricesCorrDz,
+                  nRRow, nZColumn, phiSlice, gridSizeZ, ezField);
+  w.Stop();
+  profile.localDistortionTime = w.CpuTime();
 
-        if (fCorrectionType == 0)
-		FillLookUpTable(lookupGlobalCorr,
-                        fMatrixIntCorrDrEzC, fMatrixIntCorrDPhiREzC, fMatrixIntCorrDzC,
-                        nRRow, nZColumn, phiSlice, rList, phiList, zList);
+  // copy to interpolator
+  lookupLocalDist->CopyFromMatricesToInterpolator();
+  lookupLocalCorr->CopyFromMatricesToInterpolator();
+  lookupDist->CopyFromMatricesToInterpolator();
+  lookupElectricField->CopyFromMatricesToInterpolator();
 
-        fLookupIntDistC->CopyFromMatricesToInterpolator();
-        if (fCorrectionType == 0)
-          fLookupIntCorrC->CopyFromMatricesToInterpolator();
-        else
-          fLookupIntCorrIrregularC->CopyFromMatricesToInterpolator();
-	w.Stop();
-      	myProfile.interpolationInitTime = w.CpuTime();
-        Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz"," C side done");
-      }
-
-    }
+  Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 3: Local distortion and correction: %f\n", w.CpuTime()));
+  w.Start();
+  if (fIntegrationStrategy == kNaive)
+    IntegrateDistCorrDriftLineDz(
+      lookupLocalDist,
+      matricesGDistDrDz, matricesGDistDPhiRDz, matricesGDistDz,
+      lookupLocalCorr,
+      matricesGCorrDrDz, matricesGCorrDPhiRDz, matricesGCorrDz,
+      matricesIrregularDrDz, matricesIrregularDPhiRDz, matricesIrregularDz,
+      matricesRIrregular, matricesPhiIrregular, matricesZIrregular,
+      nRRow, nZColumn, phiSlice, rList, phiList, zList
+    );
+  else
+    IntegrateDistCorrDriftLineDzWithLookUp (
+      lookupLocalDist,
+      matricesGDistDrDz, matricesGDistDPhiRDz, matricesGDistDz,
+      lookupLocalCorr,
+      matricesGCorrDrDz, matricesGCorrDPhiRDz, matricesGCorrDz,
+      nRRow, nZColumn, phiSlice, rList, phiList, zList
+    );
 
-    fInitLookUp = kTRUE;
-  }
+  w.Stop();
+  Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 4: Global correction/distortion: %f\n", w.CpuTime()));
+  profile.globalDistortionTime = w.CpuTime();
 
+  //// copy to 1D interpolator /////
+  lookupGlobalDist->CopyFromMatricesToInterpolator();
+  if (fCorrectionType == 0)
+    lookupGlobalCorr->CopyFromMatricesToInterpolator();
+  ////
 
+  w.Start();
+  FillLookUpTable(lookupGlobalDist,
+                  matricesIntDistDrEz, matricesIntDistDPhiREz, matricesIntDistDz,
+                  nRRow, nZColumn, phiSlice, rList, phiList, zList);
+
+  if (fCorrectionType == 0)
+    FillLookUpTable(lookupGlobalCorr,
+                    matricesIntCorrDrEz, matricesIntCorrDPhiREz, matricesIntCorrDz,
+                    nRRow, nZColumn, phiSlice, rList, phiList, zList);
+
+  lookupIntDist->CopyFromMatricesToInterpolator();
+  if (fCorrectionType == 0)
+    lookupIntCorr->CopyFromMatricesToInterpolator();
+  else
+    lookupIntCorrIrregular->CopyFromMatricesToInterpolator();
+  w.Stop();
+  profile.interpolationInitTime = w.CpuTime();
+  Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form("Step 5: Filling up the look up: %f\n", w.CpuTime()));
+  Info("AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz","%s",Form(" %s side done", sideName));
 
   // memory de-allocation for temporary matrices
   for (Int_t k = 0; k < phiSlice; k++) {
-    //delete matricesV[k];
     delete matricesCharge[k];
     delete matricesEr[k];
     delete matricesEPhi[k];
@@ -816,7 +762,6 @@ void AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz(
     delete matricesGCorrDrDz[k];
     delete matricesGCorrDPhiRDz[k];
     delete matricesGCorrDz[k];
-
   }
   delete lookupLocalDist;
   delete lookupLocalCorr;
@@ -824,6 +769,235 @@ void AliTPCSpaceCharge3DCalc::InitSpaceCharge3DPoissonIntegralDz(
   delete lookupGlobalCorr;
 }
 
+/// Header of the look-up table cache file
+///
+/// The header is followed by flat Double_t blocks of fNPhiSlices * fNRRows * fNZColumns values each,
+/// in [phi][r][z] order (the layout of AliTPC3DCylindricalInterpolator), so the file can be memory mapped.
+/// For each side (A, then C) the blocks are: potential, global distortion (r, r phi, z), global correction
+/// (r, r phi, z; for the irregular type followed by the distorted r, phi, z points), local distortion
+/// (r, r phi, z) and electric field (r, phi, z).
+struct AliTPCSpaceCharge3DCalcCacheHeader {
+  Char_t magic[8];       ///< "SC3DLUT"
+  UInt_t version;        ///< version of the file layout
+  UInt_t nRRow;          ///< grid size in r
+  UInt_t nZColumn;       ///< grid size in z
+  UInt_t nPhiSlice;      ///< grid size in phi
+  Int_t correctionType;  ///< correction type, defines the correction blocks
+  UInt_t reserved;       ///< padding to 8 bytes
+  ULong64_t key;         ///< input hash, see GetLookUpTableCacheKey
+};
+
+static const Char_t kLookUpTableCacheMagic[8] = "SC3DLUT";
+static const UInt_t kLookUpTableCacheVersion = 1;
+
+/// FNV-1a hash of a block of memory
+static ULong64_t HashLookUpTableCacheInput(ULong64_t hash, const void *data, size_t size) {
+  const UChar_t *bytes = (const UChar_t *) data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+/// Key of the persistent look-up table cache
+///
+/// The key is a hash of everything the look-up tables of InitSpaceCharge3DPoissonIntegralDz depend on:
+/// grid sizes, interpolation and correction settings, \f$ \omega\tau \f$ coefficients, Poisson solver settings
+/// and the charge densities of both sides.
+///
+/// \param nRRow Int_t Number of nRRow in r-direction
+/// \param nZColumn Int_t Number of nZColumn in z-direction
+/// \param phiSlice Int_t Number of phi slice in \f$ phi \f$ direction
+/// \param maxIteration Int_t Maximum iteration for poisson solver
+/// \param stoppingConvergence Convergence error stopping condition for poisson solver
+/// \return ULong64_t key, 0 if the inputs cannot be hashed (analytic boundaries or potential, no charge, grid mismatch)
+ULong64_t AliTPCSpaceCharge3DCalc::GetLookUpTableCacheKey(Int_t nRRow, Int_t nZColumn, Int_t phiSlice,
+                                                          Int_t maxIteration, Double_t stoppingConvergence) {
+  // formulas cannot be hashed reliably
+  if (fFormulaBoundaryIFCA || fFormulaBoundaryIFCC || fFormulaBoundaryOFCA || fFormulaBoundaryOFCC ||
+      fFormulaBoundaryROCA || fFormulaBoundaryROCC || fFormulaBoundaryCE || fFormulaPotentialV) return 0;
+  if (nRRow != fNRRows || nZColumn != fNZColumns || phiSlice != fNPhiSlices) return 0;
+  if (fInterpolatorChargeA->GetValues() == NULL || fInterpolatorChargeC->GetValues() == NULL) return 0;
+
+  const AliTPCPoissonSolver::MGParameters &mg = fPoissonSolver->fMgParameters;
+  const Int_t strategy = fPoissonSolver->GetStrategy();
+  const Int_t params[] = {(Int_t) kLookUpTableCacheVersion, nRRow, nZColumn, phiSlice, maxIteration,
+                          fInterpolationOrder, fIrregularGridSize, fRBFKernelType, fCorrectionType,
+                          fIntegrationStrategy, strategy, mg.isFull3D, mg.cycleType, mg.gtType, mg.relaxType,
+                          mg.cycleType == AliTPCPoissonSolver::kWCycle ? mg.gamma : 0, mg.nPre, mg.nPost, mg.nMGCycle, mg.maxLoop};
+  const Double_t values[] = {fC0, fC1, stoppingConvergence};
+
+  ULong64_t hash = 14695981039346656037ull;
+  hash = HashLookUpTableCacheInput(hash, params, sizeof(params));
+  hash = HashLookUpTableCacheInput(hash, values, sizeof(values));
+  const size_t size = (size_t) fNPhiSlices * fNRRows * fNZColumns * sizeof(Double_t);
+  hash = HashLookUpTableCacheInput(hash, fInterpolatorChargeA->GetValues(), size);
+  hash = HashLookUpTableCacheInput(hash, fInterpolatorChargeC->GetValues(), size);
+  return hash == 0 ? 1 : hash;
+}
+
+/// Write the look-up tables computed by InitSpaceCharge3DPoissonIntegralDz to the cache
+///
+/// The file is written under a temporary name and renamed, so concurrent jobs never read a partial file.
+///
+/// \param fileName const char* name of the cache file
+/// \param key ULong64_t input hash
+/// \return kTRUE on success
+Bool_t AliTPCSpaceCharge3DCalc::WriteLookUpTableCache(const char *fileName, ULong64_t key) {
+  TString tmpFileName = Form("%s.tmp", fileName);
+  FILE *fp = fopen(tmpFileName.Data(), "wb");
+  if (fp == NULL) return kFALSE;
+
+  AliTPCSpaceCharge3DCalcCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kLookUpTableCacheMagic, sizeof(header.magic));
+  header.version = kLookUpTableCacheVersion;
+  header.nRRow = fNRRows;
+  header.nZColumn = fNZColumns;
+  header.nPhiSlice = fNPhiSlices;
+  header.correctionType = fCorrectionType;
+  header.key = key;
+
+  Bool_t ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  const size_t sizeMatrix = (size_t) fNRRows * fNZColumns;
+  const size_t sizeTable = sizeMatrix * fNPhiSlices;
+  for (Int_t side = 0; side < 2 && ok; side++) {
+    TMatrixD **matrices[] = {
+      side == 0 ? fMatrixPotentialA : fMatrixPotentialC,
+      side == 0 ? fMatrixIntDistDrEzA : fMatrixIntDistDrEzC,
+      side == 0 ? fMatrixIntDistDPhiREzA : fMatrixIntDistDPhiREzC,
+      side == 0 ? fMatrixIntDistDzA : fMatrixIntDistDzC,
+      side == 0 ? fMatrixIntCorrDrEzA : fMatrixIntCorrDrEzC,
+      side == 0 ? fMatrixIntCorrDPhiREzA : fMatrixIntCorrDPhiREzC,
+      side == 0 ? fMatrixIntCorrDzA : fMatrixIntCorrDzC,
+      side == 0 ? fMatrixIntCorrDrEzIrregularA : fMatrixIntCorrDrEzIrregularC,
+      side == 0 ? fMatrixIntCorrDPhiREzIrregularA : fMatrixIntCorrDPhiREzIrregularC,
+      side == 0 ? fMatrixIntCorrDzIrregularA : fMatrixIntCorrDzIrregularC,
+      side == 0 ? fMatrixRListIrregularA : fMatrixRListIrregularC,
+      side == 0 ? fMatrixPhiListIrregularA : fMatrixPhiListIrregularC,
+      side == 0 ? fMatrixZListIrregularA : fMatrixZListIrregularC};
+    const Int_t nMatrices = sizeof(matrices) / sizeof(matrices[0]);
+    for (Int_t iMatrices = 0; iMatrices < nMatrices && ok; iMatrices++) {
+      if (fCorrectionType == kRegularInterpolator && iMatrices >= 7) continue;
+      if (fCorrectionType != kRegularInterpolator && iMatrices >= 4 && iMatrices < 7) continue;
+      for (Int_t k = 0; k < fNPhiSlices && ok; k++) {
+        ok = fwrite(matrices[iMatrices][k]->GetMatrixArray(), sizeof(Double_t), sizeMatrix, fp) == sizeMatrix;
+      }
+    }
+
+    // local distortion and electric field only live in their interpolators
+    AliTPCLookUpTable3DInterpolatorD *lookups[] = {side == 0 ? fLookupDistA : fLookupDistC,
+                                                   side == 0 ? fLookupElectricFieldA : fLookupElectricFieldC};
+    for (Int_t iLookup = 0; iLookup < 2 && ok; iLookup++) {
+      AliTPC3DCylindricalInterpolator *interpolators[] = {lookups[iLookup]->GetInterpolatorR(),
+                                                          lookups[iLookup]->GetInterpolatorPhi(),
+                                                          lookups[iLookup]->GetInterpolatorZ()};
+      for (Int_t i = 0; i < 3 && ok; i++) {
+        ok = interpolators[i]->GetValues() != NULL &&
+             fwrite(interpolators[i]->GetValues(), sizeof(Double_t), sizeTable, fp) == sizeTable;
+      }
+    }
+  }
+  if (fclose(fp)) ok = kFALSE;
+  if (ok) ok = rename(tmpFileName.Data(), fileName) == 0;
+  if (!ok) remove(tmpFileName.Data());
+  return ok;
+}
+
+/// Read the look-up tables from the cache and initialize the interpolators
+///
+/// \param fileName const char* name of the cache file
+/// \param key ULong64_t expected input hash
+/// \return kTRUE if the look-up tables were initialized from the cache
+Bool_t AliTPCSpaceCharge3DCalc::ReadLookUpTableCache(const char *fileName, ULong64_t key) {
+  FILE *fp = fopen(fileName, "rb");
+  if (fp == NULL) return kFALSE;
+
+  AliTPCSpaceCharge3DCalcCacheHeader header;
+  if (fread(&header, sizeof(header), 1, fp) != 1 ||
+      memcmp(header.magic, kLookUpTableCacheMagic, sizeof(header.magic)) ||
+      header.version != kLookUpTableCacheVersion || header.key != key ||
+      header.nRRow != (UInt_t) fNRRows || header.nZColumn != (UInt_t) fNZColumns ||
+      header.nPhiSlice != (UInt_t) fNPhiSlices || header.correctionType != fCorrectionType) {
+    fclose(fp);
+    return kFALSE;
+  }
+
+  const size_t sizeMatrix = (size_t) fNRRows * fNZColumns;
+  TMatrixD *matricesTemp[3][kNMaxPhi];
+  for (Int_t i = 0; i < 3; i++) {
+    for (Int_t k = 0; k < fNPhiSlices; k++) matricesTemp[i][k] = new TMatrixD(fNRRows, fNZColumns);
+  }
+
+  Bool_t ok = kTRUE;
+  for (Int_t side = 0; side < 2 && ok; side++) {
+    TMatrixD **matrices[] = {
+      side == 0 ? fMatrixPotentialA : fMatrixPotentialC,
+      side == 0 ? fMatrixIntDistDrEzA : fMatrixIntDistDrEzC,
+      side == 0 ? fMatrixIntDistDPhiREzA : fMatrixIntDistDPhiREzC,
+      side == 0 ? fMatrixIntDistDzA : fMatrixIntDistDzC,
+      side == 0 ? fMatrixIntCorrDrEzA : fMatrixIntCorrDrEzC,
+      side == 0 ? fMatrixIntCorrDPhiREzA : fMatrixIntCorrDPhiREzC,
+      side == 0 ? fMatrixIntCorrDzA : fMatrixIntCorrDzC,
+      side == 0 ? fMatrixIntCorrDrEzIrregularA : fMatrixIntCorrDrEzIrregularC,
+      side == 0 ? fMatrixIntCorrDPhiREzIrregularA : fMatrixIntCorrDPhiREzIrregularC,
+      side == 0 ? fMatrixIntCorrDzIrregularA : fMatrixIntCorrDzIrregularC,
+      side == 0 ? fMatrixRListIrregularA : fMatrixRListIrregularC,
+      side == 0 ? fMatrixPhiListIrregularA : fMatrixPhiListIrregularC,
+      side == 0 ? fMatrixZListIrregularA : fMatrixZListIrregularC};
+    const Int_t nMatrices = sizeof(matrices) / sizeof(matrices[0]);
+    for (Int_t iMatrices = 0; iMatrices < nMatrices && ok; iMatrices++) {
+      if (fCorrectionType == kRegularInterpolator && iMatrices >= 7) continue;
+      if (fCorrectionType != kRegularInterpolator && iMatrices >= 4 && iMatrices < 7) continue;
+      for (Int_t k = 0; k < fNPhiSlices && ok; k++) {
+        ok = fread(matrices[iMatrices][k]->GetMatrixArray(), sizeof(Double_t), sizeMatrix, fp) == sizeMatrix;
+      }
+    }
+
+    AliTPCLookUpTable3DInterpolatorD *lookups[] = {side == 0 ? fLookupDistA : fLookupDistC,
+                                                   side == 0 ? fLookupElectricFieldA : fLookupElectricFieldC};
+    for (Int_t iLookup = 0; iLookup < 2 && ok; iLookup++) {
+      AliTPC3DCylindricalInterpolator *interpolators[] = {lookups[iLookup]->GetInterpolatorR(),
+                                                          lookups[iLookup]->GetInterpolatorPhi(),
+                                                          lookups[iLookup]->GetInterpolatorZ()};
+      for (Int_t i = 0; i < 3 && ok; i++) {
+        for (Int_t k = 0; k < fNPhiSlices && ok; k++) {
+          ok = fread(matricesTemp[i][k]->GetMatrixArray(), sizeof(Double_t), sizeMatrix, fp) == sizeMatrix;
+        }
+        if (ok) {
+          interpolators[i]->SetValue(matricesTemp[i]);
+          if (fInterpolationOrder > 2) interpolators[i]->InitCubicSpline();
+        }
+      }
+    }
+    if (!ok) break;
+
+    AliTPC3DCylindricalInterpolator *potentialInterpolator = side == 0 ? fInterpolatorPotentialA : fInterpolatorPotentialC;
+    potentialInterpolator->SetValue(side == 0 ? fMatrixPotentialA : fMatrixPotentialC);
+    potentialInterpolator->InitCubicSpline();
+    if (side == 0) {
+      fLookupIntDistA->CopyFromMatricesToInterpolator();
+      if (fCorrectionType == kRegularInterpolator)
+        fLookupIntCorrA->CopyFromMatricesToInterpolator();
+      else
+        fLookupIntCorrIrregularA->CopyFromMatricesToInterpolator();
+    } else {
+      fLookupIntDistC->CopyFromMatricesToInterpolator();
+      if (fCorrectionType == kRegularInterpolator)
+        fLookupIntCorrC->CopyFromMatricesToInterpolator();
+      else
+        fLookupIntCorrIrregularC->CopyFromMatricesToInterpolator();
+    }
+  }
+  fclose(fp);
+
+  for (Int_t i = 0; i < 3; i++) {
+    for (Int_t k = 0; k < fNPhiSlices; k++) delete matricesTemp[i][k];
+  }
+  return ok;
+}
+
 // outdated, to be removed once modifications in aliroot are pushed
 /// Creating look-up tables of Correction/Distortion by integration following
 /// drift line with known distributions for potential and space charge.
@@ -1783,13 +1957,14 @@ void AliTPCSpaceCharge3DCalc::ElectricField(TMatrixD **matricesV, TMatrixD **mat
                                                  const Float_t gridSizeR, const Float_t gridSizePhi,
                                                  const Float_t gridSizeZ,
                                                  const Int_t symmetry, const Float_t innerRadius) {
-  Float_t radius;
-  Int_t mPlus, mMinus, signPlus, signMinus;
+  // the slices only read the converged potential, so they are independent
+#pragma omp parallel for
   for (Int_t m = 0; m < phiSlice; m++) {
-    mPlus = m + 1;
-    signPlus = 1;
-    mMinus = m - 1;
-    signMinus = 1;
+    Float_t radius;
+    Int_t mPlus = m + 1;
+    Int_t signPlus = 1;
+    Int_t mMinus = m - 1;
+    Int_t signMinus = 1;
     if (symmetry == 1) { // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
       if (mPlus > phiSlice - 1) mPlus = phiSlice - 2;
       if (mMinus < 0) mMinus = 1;
@@ -2008,30 +2183,24 @@ AliTPCSpaceCharge3DCalc::LocalDistCorrDz(TMatrixD **matricesEr, TMatrixD **matri
                                               const Int_t nRRow, const Int_t nZColumn, const Int_t phiSlice,
                                               const Float_t gridSizeZ,
                                               const Double_t ezField) {
-  Float_t localIntErOverEz = 0.0;
-  Float_t localIntEPhiOverEz = 0.0;
-  Float_t localIntDeltaEz = 0.0;
-  TMatrixD *eR;
-  TMatrixD *ePhi;
-  TMatrixD *eZ;
-  TMatrixD *distDrDz;
-  TMatrixD *distDPhiRDz;
-  TMatrixD *distDz;
-  TMatrixD *corrDrDz;
-  TMatrixD *corrDPhiRDz;
-  TMatrixD *corrDz;
-
-
-  // Initialization for j == column-1 integration is 0.0
+  // each slice only needs its own electric field, slices are processed independently
+#pragma omp parallel for
   for (Int_t m = 0; m < phiSlice; m++) {
-    distDrDz = matricesDistDrDz[m];
-    distDPhiRDz = matricesDistDPhiRDz[m];
-    distDz = matricesDistDz[m];
-
-    corrDrDz = matricesCorrDrDz[m];
-    corrDPhiRDz = matricesCorrDPhiRDz[m];
-    corrDz = matricesCorrDz[m];
-
+    Float_t localIntErOverEz = 0.0;
+    Float_t localIntEPhiOverEz = 0.0;
+    Float_t localIntDeltaEz = 0.0;
+    TMatrixD *eR = matricesEr[m];
+    TMatrixD *ePhi = matricesEPhi[m];
+    TMatrixD *eZ = matricesEz[m];
+    TMatrixD *distDrDz = matricesDistDrDz[m];
+    TMatrixD *distDPhiRDz = matricesDistDPhiRDz[m];
+    TMatrixD *distDz = matricesDistDz[m];
+
+    TMatrixD *corrDrDz = matricesCorrDrDz[m];
+    TMatrixD *corrDPhiRDz = matricesCorrDPhiRDz[m];
+    TMatrixD *corrDz = matricesCorrDz[m];
+
+    // Initialization for j == column-1 integration is 0.0
     for (Int_t i = 0; i < nRRow; i++) {
       (*distDrDz)(i, nZColumn - 1) = 0.0;
       (*distDPhiRDz)(i, nZColumn - 1) = 0.0;
@@ -2041,22 +2210,9 @@ AliTPCSpaceCharge3DCalc::LocalDistCorrDz(TMatrixD **matricesEr, TMatrixD **matri
       (*corrDPhiRDz)(i, 0) = 0.0;
       (*corrDz)(i, 0) = 0.0;
     }
-  }
-
-  // for this case
-  // use trapezoidal rule assume no ROC displacement
-  for (Int_t m = 0; m < phiSlice; m++) {
-    eR = matricesEr[m];
-    ePhi = matricesEPhi[m];
-    eZ = matricesEz[m];
-    distDrDz = matricesDistDrDz[m];
-    distDPhiRDz = matricesDistDPhiRDz[m];
-    distDz = matricesDistDz[m];
-
-    corrDrDz = matricesCorrDrDz[m];
-    corrDPhiRDz = matricesCorrDPhiRDz[m];
-    corrDz = matricesCorrDz[m];
 
+    // for this case
+    // use trapezoidal rule assume no ROC displacement
     for (Int_t j = 0; j < nZColumn - 1; j++) {
       for (Int_t i = 0; i < nRRow; i++) {
         localIntErOverEz = (gridSizeZ * 0.5) * ((*eR)(i, j) + (*eR)(i, j + 1)) / (ezField + (*eZ)(i,j));
@@ -3218,6 +3374,98 @@ void AliTPCSpaceCharge3DCalc::GetCorrectionCyl(const Float_t x[], Short_t roc, F
   else
     GetCorrectionCylACIrregular(x, roc, dx);
 }
+
+/// Get distortions for an array of points in cylindrical coordinates
+///
+/// Same as GetDistortionCyl for each point. Points are processed in chunks in parallel, within a chunk
+/// the grid search starts from the grid indices of the previous point of the same side, so ordered points
+/// (e.g. hits along a track) are cheapest.
+///
+/// \param nPoints Int_t number of points
+/// \param x const Float_t[] points (r, phi, z) of size 3 * nPoints
+/// \param roc const Short_t[] ROC number of each point
+/// \param dx Float_t[] distortions (dr, r dphi, dz) of size 3 * nPoints (output)
+void AliTPCSpaceCharge3DCalc::GetDistortionCyl(const Int_t nPoints, const Float_t x[], const Short_t roc[],
+                                               Float_t dx[]) {
+  if (!fInitLookUp) {
+    Info("AliTPCSpaceCharge3DCalc::GetDistortionCyl","Lookup table was not initialized! Performing the initialization now ...");
+    InitSpaceCharge3DPoissonIntegralDz(129, 129, 144, 100, 1e-8);
+  }
+  GetValueCylAC(fLookupIntDistA, fLookupIntDistC, nPoints, x, roc, dx, "AliTPCSpaceCharge3DCalc::GetDistortionCyl");
+}
+
+/// Get corrections for an array of points in cylindrical coordinates
+///
+/// Same as GetCorrectionCyl for each point, see GetDistortionCyl(const Int_t, const Float_t[], const Short_t[], Float_t[]).
+///
+/// \param nPoints Int_t number of points
+/// \param x const Float_t[] points (r, phi, z) of size 3 * nPoints
+/// \param roc const Short_t[] ROC number of each point
+/// \param dx Float_t[] corrections (dr, r dphi, dz) of size 3 * nPoints (output)
+void AliTPCSpaceCharge3DCalc::GetCorrectionCyl(const Int_t nPoints, const Float_t x[], const Short_t roc[],
+                                               Float_t dx[]) {
+  if (!fInitLookUp) {
+    Info("AliTPCSpaceCharge3DCalc::GetCorrectionCyl","Lookup table was not initialized! Performing the initialization now ...");
+    InitSpaceCharge3DPoissonIntegralDz(129, 129, 144, 100, 1e-8);
+  }
+  if (fCorrectionType == kRegularInterpolator) {
+    GetValueCylAC(fLookupIntCorrA, fLookupIntCorrC, nPoints, x, roc, dx, "AliTPCSpaceCharge3DCalc::GetCorrectionCyl");
+  } else {
+    for (Int_t i = 0; i < nPoints; i++) GetCorrectionCylACIrregular(&x[3 * i], roc[i], &dx[3 * i]);
+  }
+}
+
+/// Interpolate regular look up tables of side A and C for an array of points
+///
+/// \param lookupA AliTPCLookUpTable3DInterpolatorD* look up table for side A
+/// \param lookupC AliTPCLookUpTable3DInterpolatorD* look up table for side C
+/// \param nPoints Int_t number of points
+/// \param x const Float_t[] points (r, phi, z) of size 3 * nPoints
+/// \param roc const Short_t[] ROC number of each point
+/// \param dx Float_t[] interpolated values (r, r phi, z) of size 3 * nPoints (output)
+/// \param location const char* caller name for error messages
+void AliTPCSpaceCharge3DCalc::GetValueCylAC(AliTPCLookUpTable3DInterpolatorD *lookupA,
+                                            AliTPCLookUpTable3DInterpolatorD *lookupC, const Int_t nPoints,
+                                            const Float_t x[], const Short_t roc[], Float_t dx[],
+                                            const char *location) {
+  const Int_t chunkSize = 256;
+  const Int_t nChunks = (nPoints + chunkSize - 1) / chunkSize;
+  Int_t nInconsistent = 0;
+
+#pragma omp parallel for reduction(+:nInconsistent)
+  for (Int_t iChunk = 0; iChunk < nChunks; iChunk++) {
+    // grid index guesses for side A and C
+    Int_t rLow[2] = {0, 0}, phiLow[2] = {0, 0}, zLow[2] = {0, 0};
+    const Int_t iEnd = TMath::Min(nPoints, (iChunk + 1) * chunkSize);
+    for (Int_t i = iChunk * chunkSize; i < iEnd; i++) {
+      Double_t r = x[3 * i];
+      Double_t phi = x[3 * i + 1];
+      Double_t z = x[3 * i + 2];
+      Double_t dR, dRPhi, dZ;
+      if (phi < 0) phi += TMath::TwoPi();                   // Table uses phi from 0 to 2*Pi
+      if (phi > TMath::TwoPi()) phi = phi - TMath::TwoPi();                   // Table uses phi from 0 to 2*Pi
+
+      const Int_t sign = ((roc[i] % 36) < 18) ? 1 : -1;
+      if (sign == 1 && z < AliTPCPoissonSolver::fgkZOffSet) z = AliTPCPoissonSolver::fgkZOffSet;    // Protect against discontinuity at CE
+      if (sign == -1 && z > -AliTPCPoissonSolver::fgkZOffSet) z = -AliTPCPoissonSolver::fgkZOffSet;    // Protect against discontinuity at CE
+      if ((sign == 1 && z < -1e-16) || (sign == -1 && z > -1e-16)) nInconsistent++;
+
+      if (z > -1e-16)
+        lookupA->GetValue(r, phi, z, dR, dRPhi, dZ, rLow[0], phiLow[0], zLow[0]);
+      else {
+        lookupC->GetValue(r, phi, -z, dR, dRPhi, dZ, rLow[1], phiLow[1], zLow[1]);
+        dZ = -1 * dZ;
+      }
+
+      dx[3 * i] = fCorrectionFactor * (Float_t) dR;
+      dx[3 * i + 1] = fCorrectionFactor * (Float_t) dRPhi;
+      dx[3 * i + 2] = fCorrectionFactor * (Float_t) dZ;
+    }
+  }
+
+  if (nInconsistent)
+    Error(location,"%s",Form("ROC number does not correspond to z coordinate for %d points! Calculation of distortions is most likely wrong!", nInconsistent));
+}
 ///
 /// \param x
 /// \param roc
@@ -17,6 +17,7 @@
 #include "TF1.h"
 #include "TH3F.h"
 #include "TMatrixD.h"
+#include "TString.h"
 #include "AliTPCPoissonSolver.h"
 #include "AliTPCLookUpTable3DInterpolatorD.h"
 #include "AliTPC3DCylindricalInterpolator.h"
@@ -61,8 +62,10 @@ public:
   void ForceInitSpaceCharge3DPoissonIntegralDz(Int_t nRRow, Int_t nZColumn, Int_t phiSlice, Int_t maxIteration,
                                                Double_t stopConvergence);
   void GetDistortionCyl(const Float_t x[], Short_t roc, Float_t dx[]);
+  void GetDistortionCyl(const Int_t nPoints, const Float_t x[], const Short_t roc[], Float_t dx[]);
   void GetDistortionCylAC(const Float_t x[], Short_t roc, Float_t dx[]);
   void GetCorrectionCyl(const Float_t x[], Short_t roc, Float_t dx[]);
+  void GetCorrectionCyl(const Int_t nPoints, const Float_t x[], const Short_t roc[], Float_t dx[]);
   void GetCorrectionCylAC(const Float_t x[], Short_t roc, Float_t dx[]);
   void GetCorrectionCylACIrregular(const Float_t x[], Short_t roc, Float_t dx[]);
   void GetCorrectionCylACIrregular(const Float_t x[], Short_t roc, Float_t dx[],const Int_t side);
@@ -245,6 +248,11 @@ public:
   void SetIntegrationStrategy(Int_t integrationStrategy) {
     fIntegrationStrategy = integrationStrategy;
   }
+
+  void SetLookUpTableCacheDirectory(const char *directory) { fLookUpTableCacheDirectory = directory; }
+  const char *GetLookUpTableCacheDirectory() const { return fLookUpTableCacheDirectory.Data(); }
+  ULong64_t GetLookUpTableCacheKey(Int_t nRRow, Int_t nZColumn, Int_t phiSlice, Int_t maxIteration,
+                                   Double_t stoppingConvergence);
 private:
   static const Int_t kNMaxPhi = 360;
   Profile myProfile;
@@ -269,6 +277,7 @@ private:
   Int_t fIrregularGridSize; ///>  Size of irregular grid cubes for interpolation (min 3)
   Int_t fRBFKernelType; ///>  RBF kernel type
   Int_t fIntegrationStrategy; ///> Strategy for integration
+  TString fLookUpTableCacheDirectory; //!<! Directory of the persistent look-up table cache, disabled if empty
 
   TMatrixD *fMatrixIntDistDrEzA[kNMaxPhi];  //[kNMaxPhi] Matrices for storing Global distortion  \f$ R \f$ direction for Side A
   TMatrixD *fMatrixIntDistDPhiREzA[kNMaxPhi]; //[kNMaxPhi] Matrices for storing Global \f$ \phi R \f$ Distortion for Side A
@@ -370,6 +379,15 @@ private:
 
   AliTPCPoissonSolver *fPoissonSolver; //-> Pointer to a poisson solver
 
+  void GetValueCylAC(AliTPCLookUpTable3DInterpolatorD *lookupA, AliTPCLookUpTable3DInterpolatorD *lookupC,
+                     const Int_t nPoints, const Float_t x[], const Short_t roc[], Float_t dx[], const char *location);
+  Bool_t ReadLookUpTableCache(const char *fileName, ULong64_t key);
+  Bool_t WriteLookUpTableCache(const char *fileName, ULong64_t key);
+
+  void InitSpaceCharge3DPoissonIntegralDzSide(const Int_t side, AliTPCPoissonSolver *poissonSolver, const Int_t nRRow,
+                                              const Int_t nZColumn, const Int_t phiSlice, const Int_t maxIteration,
+                                              Profile &profile);
+
   void ElectricField(TMatrixD **matricesV, TMatrixD **matricesEr, TMatrixD **matricesEPhi, TMatrixD **matricesEz,
                      const Int_t nRRow, const Int_t nZColumn, const Int_t phiSlices, const Float_t gridSizeR,
                      const Float_t gridSizePhi, const Float_t gridSizeZ, const Int_t symmetry,
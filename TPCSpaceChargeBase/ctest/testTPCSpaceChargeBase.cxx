@@ -3,7 +3,10 @@
 #define BOOST_TEST_DYN_LINK
 
 #include <boost/test/unit_test.hpp>
+#include <vector>
+#include "TMath.h"
 #include "AliTPCSpaceCharge3DCalc.h"
+#include "AliTPC3DCylindricalInterpolator.h"
 
 /// @brief Basic test if we can create the method class
 BOOST_AUTO_TEST_CASE(TPCSpaceChargeBase_test1)
@@ -11,3 +14,42 @@ BOOST_AUTO_TEST_CASE(TPCSpaceChargeBase_test1)
   auto spacecharge = new AliTPCSpaceCharge3DCalc;
   delete spacecharge;
 }
+
+/// @brief Test that the grid search from an index guess finds the same bracket as a full search
+/// on an irregular grid, also for a guess above the point and for points exactly on a grid node
+BOOST_AUTO_TEST_CASE(TPCSpaceChargeBase_irregularSearch)
+{
+  const Int_t nR = 7, nPhi = 4, nZ = 3;
+  Double_t rList[nR] = {83.5, 90.0, 92.5, 110.0, 111.0, 140.0, 254.5};
+  Double_t phiList[nPhi], zList[nZ], values[nPhi * nR * nZ];
+  for (Int_t k = 0; k < nPhi; k++) phiList[k] = k * TMath::TwoPi() / nPhi;
+  for (Int_t j = 0; j < nZ; j++) zList[j] = j * 10.0;
+  for (Int_t k = 0; k < nPhi; k++)
+    for (Int_t i = 0; i < nR; i++)
+      for (Int_t j = 0; j < nZ; j++) values[k * nR * nZ + i * nZ + j] = 2.0 * rList[i] + 1.0;
+
+  AliTPC3DCylindricalInterpolator interpolator;
+  interpolator.SetOrder(1);
+  interpolator.SetNR(nR);
+  interpolator.SetNPhi(nPhi);
+  interpolator.SetNZ(nZ);
+  interpolator.SetRList(rList);
+  interpolator.SetPhiList(phiList);
+  interpolator.SetZList(zList);
+  interpolator.SetValue(values);
+
+  std::vector<Double_t> points(rList + 1, rList + nR);
+  for (Int_t i = 0; i < nR - 1; i++) points.push_back(0.5 * (rList[i] + rList[i + 1]));
+  for (Double_t r : points) {
+    Int_t expected = -1;
+    for (Int_t i = 0; i < nR; i++)
+      if (r > rList[i]) expected = i;
+    for (Int_t guess = 0; guess < nR; guess++) {
+      Int_t rLow = guess, phiLow = 0, zLow = 0;
+      Double_t value = interpolator.GetValue(r, 0.1, 5.0, rLow, phiLow, zLow);
+      BOOST_CHECK_EQUAL(rLow, expected);
+      BOOST_CHECK_CLOSE(value, 2.0 * r + 1.0, 1e-9);
+      BOOST_CHECK_EQUAL(value, interpolator.GetValue(r, 0.1, 5.0));
+    }
+  }
+}
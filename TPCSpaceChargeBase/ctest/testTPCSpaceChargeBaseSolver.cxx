@@ -0,0 +1,197 @@
+#define BOOST_TEST_MODULE Test TPC Space-Charge Base Poisson Solver
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include "TFormula.h"
+#include "TMath.h"
+#include "TMatrixD.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "AliTPCPoissonSolver.h"
+
+/// Result of one solver configuration on the test problem
+struct SolverBenchmarkResult {
+  Int_t strategy;
+  Int_t cycleType;
+  Int_t relaxType;
+  Bool_t isFull3D;
+  Double_t realTime;  ///< wall time of PoissonSolver3D [s]
+  Double_t cpuTime;   ///< cpu time of PoissonSolver3D [s]
+  Int_t iterations;   ///< iterations / multigrid cycles used
+  Long_t solveRSS;    ///< increase of the resident memory during PoissonSolver3D [kB], -1 if unavailable
+  Double_t error;     ///< max |V - V_exact| / max |V_exact|
+};
+
+/// Read a memory field of /proc/self/status
+///
+/// \param field const char* field name including the colon, e.g. "VmRSS:"
+/// \return Long_t value in kB, -1 if not available
+static Long_t ReadProcStatus(const char *field)
+{
+  FILE *fp = fopen("/proc/self/status", "r");
+  if (fp == NULL) return -1;
+  char line[256];
+  Long_t value = -1;
+  const size_t length = strlen(field);
+  while (fgets(line, sizeof(line), fp)) {
+    if (strncmp(line, field, length) == 0) {
+      value = atol(line + length);
+      break;
+    }
+  }
+  fclose(fp);
+  return value;
+}
+
+/// Reset the peak resident memory (VmHWM) of the process to the current one
+///
+/// \return Bool_t kTRUE if the kernel supports resetting the peak
+static Bool_t ResetPeakRSS()
+{
+#ifdef __GLIBC__
+  // return memory freed by previous solves, so that reusing it shows up as an increase
+  malloc_trim(0);
+#endif
+  FILE *fp = fopen("/proc/self/clear_refs", "w");
+  if (fp == NULL) return kFALSE;
+  Bool_t ok = fputs("5", fp) >= 0;
+  ok = (fclose(fp) == 0) && ok;
+  return ok;
+}
+
+/// Solve the test problem V = (r/R)^2 (z/Z)^2 (1 + cos(phi)) with the given solver configuration
+///
+/// Boundary values and the charge density (the analytic Laplacian of V) are filled from TFormula,
+/// the same way as AliTPCSpaceCharge3DCalc::SetPotentialBoundaryAndChargeFormula does.
+static SolverBenchmarkResult RunSolverBenchmark(AliTPCPoissonSolver::StrategyType strategy,
+                                                AliTPCPoissonSolver::CycleType cycleType,
+                                                AliTPCPoissonSolver::RelaxType relaxType, Bool_t isFull3D)
+{
+  const Int_t nRRow = 17, nZColumn = 17, phiSlice = 16, maxIteration = 200;
+  const Double_t gridSizeR = (AliTPCPoissonSolver::fgkOFCRadius - AliTPCPoissonSolver::fgkIFCRadius) / (nRRow - 1);
+  const Double_t gridSizeZ = AliTPCPoissonSolver::fgkTPCZ0 / (nZColumn - 1);
+  const Double_t gridSizePhi = TMath::TwoPi() / phiSlice;
+  const Double_t scale = 1.0 / (AliTPCPoissonSolver::fgkOFCRadius * AliTPCPoissonSolver::fgkOFCRadius *
+                                AliTPCPoissonSolver::fgkTPCZ0 * AliTPCPoissonSolver::fgkTPCZ0);
+
+  TFormula vTestFunction("vTestFunction", Form("%.15g*x*x*z*z*(1+cos(y))", scale));
+  TFormula rhoTestFunction("rhoTestFunction", Form("%.15g*(z*z*(4+3*cos(y))+2*x*x*(1+cos(y)))", scale));
+
+  TMatrixD *matricesV[phiSlice];
+  TMatrixD *matricesCharge[phiSlice];
+  TMatrixD *matricesExact[phiSlice];
+  for (Int_t k = 0; k < phiSlice; k++) {
+    matricesV[k] = new TMatrixD(nRRow, nZColumn);
+    matricesCharge[k] = new TMatrixD(nRRow, nZColumn);
+    matricesExact[k] = new TMatrixD(nRRow, nZColumn);
+    const Double_t phi0 = k * gridSizePhi;
+    for (Int_t i = 0; i < nRRow; i++) {
+      const Double_t radius0 = AliTPCPoissonSolver::fgkIFCRadius + i * gridSizeR;
+      for (Int_t j = 0; j < nZColumn; j++) {
+        const Double_t z0 = j * gridSizeZ;
+        (*matricesExact[k])(i, j) = vTestFunction.Eval(radius0, phi0, z0);
+        (*matricesCharge[k])(i, j) = -1.0 * rhoTestFunction.Eval(radius0, phi0, z0);
+        if ((i == 0) || (i == nRRow - 1) || (j == 0) || (j == nZColumn - 1))
+          (*matricesV[k])(i, j) = (*matricesExact[k])(i, j);
+      }
+    }
+  }
+
+  AliTPCPoissonSolver poissonSolver;
+  poissonSolver.SetStrategy(strategy);
+  poissonSolver.fMgParameters.cycleType = cycleType;
+  poissonSolver.fMgParameters.relaxType = relaxType;
+  poissonSolver.fMgParameters.isFull3D = isFull3D;
+  poissonSolver.fIterations = 0;
+  poissonSolver.SetExactSolution(matricesExact, phiSlice);
+  AliTPCPoissonSolver::fgConvergenceError = 1e-8;
+
+  const Bool_t peakReset = ResetPeakRSS();
+  const Long_t rssBefore = ReadProcStatus("VmRSS:");
+  TStopwatch w;
+  poissonSolver.PoissonSolver3D(matricesV, matricesCharge, nRRow, nZColumn, phiSlice, maxIteration, 0);
+  w.Stop();
+  const Long_t rssPeak = ReadProcStatus("VmHWM:");
+
+  SolverBenchmarkResult result;
+  result.strategy = strategy;
+  result.cycleType = cycleType;
+  result.relaxType = relaxType;
+  result.isFull3D = isFull3D;
+  result.realTime = w.RealTime();
+  result.cpuTime = w.CpuTime();
+  result.iterations = poissonSolver.fIterations;
+
+  result.solveRSS = (peakReset && rssBefore >= 0 && rssPeak >= 0) ? TMath::Max(0L, rssPeak - rssBefore) : -1;
+
+  Double_t maxExact = 0.0, maxError = 0.0;
+  for (Int_t k = 0; k < phiSlice; k++) {
+    for (Int_t i = 0; i < nRRow; i++) {
+      for (Int_t j = 0; j < nZColumn; j++) {
+        maxExact = TMath::Max(maxExact, TMath::Abs((*matricesExact[k])(i, j)));
+        maxError = TMath::Max(maxError, TMath::Abs((*matricesV[k])(i, j) - (*matricesExact[k])(i, j)));
+      }
+    }
+  }
+  result.error = maxError / maxExact;
+
+  for (Int_t k = 0; k < phiSlice; k++) {
+    delete matricesV[k];
+    delete matricesCharge[k];
+    delete matricesExact[k];
+  }
+  return result;
+}
+
+/// @brief Run all solver strategies / cycle types / relaxation types on an analytic problem
+///
+/// The results are written as CSV to the file given by TPCSPACECHARGE_BENCHMARK_OUTPUT
+/// (default testTPCSpaceChargeBaseSolver.csv), so they can be compared between versions.
+BOOST_AUTO_TEST_CASE(TPCSpaceChargeBase_PoissonSolverBenchmark)
+{
+  const char *fileName = getenv("TPCSPACECHARGE_BENCHMARK_OUTPUT");
+  if (fileName == NULL) fileName = "testTPCSpaceChargeBaseSolver.csv";
+  FILE *fp = fopen(fileName, "w");
+  BOOST_REQUIRE(fp != NULL);
+  fprintf(fp, "strategy,cycleType,relaxType,isFull3D,realTime,cpuTime,iterations,solveRSSkB,error\n");
+
+  const AliTPCPoissonSolver::StrategyType strategies[] = {AliTPCPoissonSolver::kRelaxation,
+                                                          AliTPCPoissonSolver::kMultiGrid,
+                                                          AliTPCPoissonSolver::kFastRelaxation};
+  const AliTPCPoissonSolver::CycleType cycleTypes[] = {AliTPCPoissonSolver::kVCycle, AliTPCPoissonSolver::kWCycle,
+                                                       AliTPCPoissonSolver::kFCycle};
+  const AliTPCPoissonSolver::RelaxType relaxTypes[] = {AliTPCPoissonSolver::kJacobi,
+                                                       AliTPCPoissonSolver::kWeightedJacobi,
+                                                       AliTPCPoissonSolver::kGaussSeidel};
+
+  for (Int_t iStrategy = 0; iStrategy < 3; iStrategy++) {
+    // cycle and relaxation types are only used by the multigrid strategy
+    const Bool_t isMultiGrid = strategies[iStrategy] == AliTPCPoissonSolver::kMultiGrid;
+    for (Int_t iCycle = 0; iCycle < (isMultiGrid ? 3 : 1); iCycle++) {
+      for (Int_t iRelax = 0; iRelax < (isMultiGrid ? 3 : 1); iRelax++) {
+        for (Int_t iFull3D = 0; iFull3D < (isMultiGrid ? 2 : 1); iFull3D++) {
+          const AliTPCPoissonSolver::CycleType cycleType = isMultiGrid ? cycleTypes[iCycle] : AliTPCPoissonSolver::kFCycle;
+          const AliTPCPoissonSolver::RelaxType relaxType = isMultiGrid ? relaxTypes[iRelax] : AliTPCPoissonSolver::kGaussSeidel;
+          SolverBenchmarkResult result = RunSolverBenchmark(strategies[iStrategy], cycleType, relaxType, iFull3D);
+          fprintf(fp, "%d,%d,%d,%d,%g,%g,%d,%ld,%g\n", result.strategy, result.cycleType, result.relaxType,
+                  result.isFull3D, result.realTime, result.cpuTime, result.iterations, result.solveRSS, result.error);
+
+          // W cycle and weighted Jacobi are not implemented in 3D and plain Jacobi smoothing is not guaranteed
+          // to converge within the cycle limit, these are recorded but not checked
+          if (cycleType == AliTPCPoissonSolver::kWCycle || relaxType != AliTPCPoissonSolver::kGaussSeidel) continue;
+          BOOST_CHECK_MESSAGE(result.error < 5e-2, Form("strategy %d, cycle %d, relax %d, full3D %d: error %g",
+                                                         result.strategy, result.cycleType, result.relaxType,
+                                                         result.isFull3D, result.error));
+        }
+      }
+    }
+  }
+  fclose(fp);
+}